@@ -70,12 +70,21 @@
 
 #include "ensmallen_bits/utility/any.hpp"
 #include "ensmallen_bits/utility/arma_traits.hpp"
+#include "ensmallen_bits/utility/counter_rng.hpp"
+#include "ensmallen_bits/utility/elementwise.hpp"
+#include "ensmallen_bits/utility/random_engine.hpp"
+#include "ensmallen_bits/utility/parallel.hpp"
+#include "ensmallen_bits/utility/perf_counters.hpp"
+#include "ensmallen_bits/utility/quantized_blocks.hpp"
 #include "ensmallen_bits/utility/indicators/epsilon.hpp"
 #include "ensmallen_bits/utility/indicators/igd.hpp"
 #include "ensmallen_bits/utility/indicators/igd_plus.hpp"
 
 // Contains traits, must be placed before report callback.
 #include "ensmallen_bits/function.hpp" // TODO: should move to function/
+#include "ensmallen_bits/function/memoized_function.hpp"
+#include "ensmallen_bits/function/instrumented_function.hpp"
+#include "ensmallen_bits/function/mixed_precision_function.hpp"
 
 // Callbacks.
 #include "ensmallen_bits/callbacks/callbacks.hpp"
@@ -83,7 +92,9 @@
 #include "ensmallen_bits/callbacks/grad_clip_by_norm.hpp"
 #include "ensmallen_bits/callbacks/grad_clip_by_value.hpp"
 #include "ensmallen_bits/callbacks/print_loss.hpp"
+#include "ensmallen_bits/callbacks/profile_trace.hpp"
 #include "ensmallen_bits/callbacks/progress_bar.hpp"
+#include "ensmallen_bits/callbacks/prometheus_metrics.hpp"
 #include "ensmallen_bits/callbacks/query_front.hpp"
 #include "ensmallen_bits/callbacks/report.hpp"
 #include "ensmallen_bits/callbacks/store_best_coordinates.hpp"
@@ -96,6 +107,7 @@
 #include "ensmallen_bits/ada_delta/ada_delta.hpp"
 #include "ensmallen_bits/ada_grad/ada_grad.hpp"
 #include "ensmallen_bits/ada_sqrt/ada_sqrt.hpp"
+#include "ensmallen_bits/adafactor/adafactor.hpp"
 #include "ensmallen_bits/adam/adam.hpp"
 #include "ensmallen_bits/demon_adam/demon_adam.hpp"
 #include "ensmallen_bits/demon_sgd/demon_sgd.hpp"
@@ -116,16 +128,19 @@
 #include "ensmallen_bits/iqn/iqn.hpp"
 #include "ensmallen_bits/katyusha/katyusha.hpp"
 #include "ensmallen_bits/lbfgs/lbfgs.hpp"
+#include "ensmallen_bits/local_sgd/local_sgd.hpp"
 #include "ensmallen_bits/lookahead/lookahead.hpp"
 #include "ensmallen_bits/agemoea/agemoea.hpp"
 #include "ensmallen_bits/moead/moead.hpp"
 #include "ensmallen_bits/nsga2/nsga2.hpp"
 #include "ensmallen_bits/padam/padam.hpp"
 #include "ensmallen_bits/parallel_sgd/parallel_sgd.hpp"
+#include "ensmallen_bits/parameter_server/parameter_server_sgd.hpp"
 #include "ensmallen_bits/pso/pso.hpp"
 #include "ensmallen_bits/rmsprop/rmsprop.hpp"
 
 #include "ensmallen_bits/sa/sa.hpp"
+#include "ensmallen_bits/sa/parallel_tempering.hpp"
 #include "ensmallen_bits/sarah/sarah.hpp"
 #include "ensmallen_bits/sdp/sdp.hpp"
 #include "ensmallen_bits/sdp/lrsdp.hpp"
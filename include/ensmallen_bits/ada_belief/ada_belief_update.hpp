@@ -109,21 +109,64 @@ class AdaBeliefUpdate
       // Increment the iteration counter variable.
       ++iteration;
 
+      const double biasCorrection1 = 1.0 - std::pow(parent.beta1, iteration);
+      const double biasCorrection2 = 1.0 - std::pow(parent.beta2, iteration);
+
+      Step(iterate, gradient, stepSize, biasCorrection1, biasCorrection2);
+    }
+
+   private:
+    //! Update the moments and take a step.
+    template<typename IterateType, typename GType>
+    void Step(IterateType& iterate,
+              const GType& gradient,
+              const double stepSize,
+              const double biasCorrection1,
+              const double biasCorrection2)
+    {
       m *= parent.beta1;
       m += (1 - parent.beta1) * gradient;
 
       s *= parent.beta2;
       s += (1 - parent.beta2) * arma::pow(gradient - m, 2.0) + parent.epsilon;
 
-      const double biasCorrection1 = 1.0 - std::pow(parent.beta1, iteration);
-      const double biasCorrection2 = 1.0 - std::pow(parent.beta2, iteration);
-
       // And update the iterate.
       iterate -= ((m / biasCorrection1) * stepSize) / (arma::sqrt(s /
           biasCorrection2) + parent.epsilon);
     }
 
-   private:
+    //! Dense version of Step(): update the moments and the iterate in a single
+    //! pass over the memory.
+    template<typename eT>
+    void Step(arma::Mat<eT>& iterate,
+              const arma::Mat<eT>& gradient,
+              const double stepSize,
+              const double biasCorrection1,
+              const double biasCorrection2)
+    {
+      const eT beta1 = parent.beta1;
+      const eT beta2 = parent.beta2;
+      const eT epsilon = parent.epsilon;
+      const eT a = stepSize;
+      const eT bc1 = biasCorrection1;
+      const eT bc2 = biasCorrection2;
+
+      eT* x = iterate.memptr();
+      eT* mMem = m.memptr();
+      eT* sMem = s.memptr();
+      const eT* g = gradient.memptr();
+
+      const size_t n = iterate.n_elem;
+      ENS_PRAGMA_OMP_SIMD
+      for (size_t i = 0; i < n; ++i)
+      {
+        mMem[i] = beta1 * mMem[i] + (1 - beta1) * g[i];
+        const eT d = g[i] - mMem[i];
+        sMem[i] = beta2 * sMem[i] + ((1 - beta2) * (d * d) + epsilon);
+        x[i] -= ((mMem[i] / bc1) * a) / (std::sqrt(sMem[i] / bc2) + epsilon);
+      }
+    }
+
     //! Instantiated parent object.
     AdaBeliefUpdate& parent;
 
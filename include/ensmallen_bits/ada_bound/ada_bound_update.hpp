@@ -135,13 +135,6 @@ class AdaBoundUpdate
       // Increment the iteration counter variable.
       ++iteration;
 
-      // Decay the first and second moment running average coefficient.
-      m *= parent.beta1;
-      m += (1 - parent.beta1) * gradient;
-
-      v *= parent.beta2;
-      v += (1 - parent.beta2) * (gradient % gradient);
-
       const ElemType biasCorrection1 = 1.0 - std::pow(parent.beta1, iteration);
       const ElemType biasCorrection2 = 1.0 - std::pow(parent.beta2, iteration);
 
@@ -149,13 +142,61 @@ class AdaBoundUpdate
       const ElemType lower = fl * (1.0 - 1.0 / (parent.gamma * iteration + 1));
       const ElemType upper = fl * (1.0 + 1.0 / (parent.gamma * iteration));
 
-       // Applies bounds on actual learning rate.
-      iterate -= arma::clamp((stepSize *
-          std::sqrt(biasCorrection2) / biasCorrection1) / (arma::sqrt(v) +
-          parent.epsilon), lower, upper) % m;
+      // Applies bounds on actual learning rate.
+      Step(iterate, gradient, (ElemType) (stepSize *
+          std::sqrt(biasCorrection2) / biasCorrection1), lower, upper);
     }
 
    private:
+    // Update the moments and take a step of size alpha, with the learning rate
+    // of each element clamped to [lower, upper].
+    template<typename IterateType, typename GType, typename ElemType>
+    void Step(IterateType& iterate,
+              const GType& gradient,
+              const ElemType alpha,
+              const ElemType lower,
+              const ElemType upper)
+    {
+      // Decay the first and second moment running average coefficient.
+      m *= parent.beta1;
+      m += (1 - parent.beta1) * gradient;
+
+      v *= parent.beta2;
+      v += (1 - parent.beta2) * (gradient % gradient);
+
+      iterate -= arma::clamp(alpha / (arma::sqrt(v) + parent.epsilon),
+          lower, upper) % m;
+    }
+
+    // Dense version of Step(): update the moments and the iterate in a single
+    // pass over the memory.
+    template<typename eT>
+    void Step(arma::Mat<eT>& iterate,
+              const arma::Mat<eT>& gradient,
+              const eT alpha,
+              const eT lower,
+              const eT upper)
+    {
+      const eT beta1 = parent.beta1;
+      const eT beta2 = parent.beta2;
+      const eT epsilon = parent.epsilon;
+
+      eT* x = iterate.memptr();
+      eT* mMem = m.memptr();
+      eT* vMem = v.memptr();
+      const eT* g = gradient.memptr();
+
+      const size_t n = iterate.n_elem;
+      ENS_PRAGMA_OMP_SIMD
+      for (size_t i = 0; i < n; ++i)
+      {
+        mMem[i] = beta1 * mMem[i] + (1 - beta1) * g[i];
+        vMem[i] = beta2 * vMem[i] + (1 - beta2) * (g[i] * g[i]);
+        const eT rate = alpha / (std::sqrt(vMem[i]) + epsilon);
+        x[i] -= std::min(std::max(rate, lower), upper) * mMem[i];
+      }
+    }
+
     // Instantiated parent object.
     AdaBoundUpdate& parent;
 
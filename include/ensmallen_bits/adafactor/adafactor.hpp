@@ -0,0 +1,198 @@
+/**
+ * @file adafactor.hpp
+ *
+ * Class wrapper for the Adafactor update policy.  Adafactor is a variant of
+ * Adam that stores factored second moment estimates for matrix parameters.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_ADAFACTOR_ADAFACTOR_HPP
+#define ENSMALLEN_ADAFACTOR_ADAFACTOR_HPP
+
+#include <ensmallen_bits/sgd/sgd.hpp>
+#include "adafactor_update.hpp"
+
+namespace ens {
+
+/**
+ * Adafactor is a variant of Adam that, for parameters that are matrices, only
+ * stores the moving averages of the row and column sums of the squared
+ * gradient, so that its state takes memory proportional to the number of rows
+ * plus the number of columns instead of their product.  The updates are
+ * clipped to a maximum root mean square, and by default no first moment
+ * estimate is kept.
+ *
+ * For more information, see the following.
+ *
+ * @code
+ * @inproceedings{Shazeer2018,
+ *   author    = {Noam Shazeer and Mitchell Stern},
+ *   title     = {Adafactor: Adaptive Learning Rates with Sublinear Memory
+ *                Cost},
+ *   booktitle = {Proceedings of the 35th International Conference on Machine
+ *                Learning},
+ *   pages     = {4596--4604},
+ *   year      = {2018}
+ * }
+ * @endcode
+ *
+ * Adafactor can optimize differentiable separable functions. For more details,
+ * see the documentation on function types included with this distribution or
+ * on the ensmallen website.
+ */
+class Adafactor
+{
+ public:
+  /**
+   * Construct the Adafactor optimizer with the given function and parameters.
+   * The defaults here are not necessarily good for the given problem, so it is
+   * suggested that the values used be tailored to the task at hand.  The
+   * maximum number of iterations refers to the maximum number of points that
+   * are processed (i.e., one iteration equals one point; one iteration does not
+   * equal one pass over the dataset).
+   *
+   * @param stepSize Step size for each iteration.
+   * @param batchSize Number of points to process in a single step.
+   * @param epsilon Value added to the squared gradient to avoid division by
+   *     zero.
+   * @param clippingThreshold Maximum root mean square of an update.
+   * @param decayRate Exponent of the decay of the second moment estimate.
+   * @param beta1 The smoothing parameter of the first moment estimate (0 means
+   *     no first moment estimate is kept).
+   * @param maxIterations Maximum number of iterations allowed (0 means no
+   *     limit).
+   * @param tolerance Maximum absolute tolerance to terminate algorithm.
+   * @param shuffle If true, the function order is shuffled; otherwise, each
+   *     function is visited in linear order.
+   * @param resetPolicy If true, parameters are reset before every Optimize
+   *     call; otherwise, their values are retained.
+   * @param exactObjective Calculate the exact objective (Default: estimate the
+   *        final objective obtained on the last pass over the data).
+   */
+  Adafactor(const double stepSize = 0.01,
+            const size_t batchSize = 32,
+            const double epsilon = 1e-30,
+            const double clippingThreshold = 1.0,
+            const double decayRate = 0.8,
+            const double beta1 = 0.0,
+            const size_t maxIterations = 100000,
+            const double tolerance = 1e-5,
+            const bool shuffle = true,
+            const bool resetPolicy = true,
+            const bool exactObjective = false);
+
+  /**
+   * Optimize the given function using Adafactor. The given starting point will
+   * be modified to store the finishing point of the algorithm, and the final
+   * objective value is returned.
+   *
+   * @tparam SeparableFunctionType Type of the function to optimize.
+   * @tparam MatType Type of matrix to optimize with.
+   * @tparam GradType Type of matrix to use to represent function gradients.
+   * @tparam CallbackTypes Types of callback functions.
+   * @param function Function to optimize.
+   * @param iterate Starting point (will be modified).
+   * @param callbacks Callback functions.
+   * @return Objective value of the final point.
+   */
+  template<typename SeparableFunctionType,
+           typename MatType,
+           typename GradType,
+           typename... CallbackTypes>
+  typename std::enable_if<IsArmaType<GradType>::value,
+      typename MatType::elem_type>::type
+  Optimize(SeparableFunctionType& function,
+           MatType& iterate,
+           CallbackTypes&&... callbacks)
+  {
+    return optimizer.Optimize<SeparableFunctionType, MatType, GradType,
+        CallbackTypes...>(function, iterate,
+        std::forward<CallbackTypes>(callbacks)...);
+  }
+
+  //! Forward the MatType as GradType.
+  template<typename SeparableFunctionType,
+           typename MatType,
+           typename... CallbackTypes>
+  typename MatType::elem_type Optimize(SeparableFunctionType& function,
+                                       MatType& iterate,
+                                       CallbackTypes&&... callbacks)
+  {
+    return Optimize<SeparableFunctionType, MatType, MatType,
+        CallbackTypes...>(function, iterate,
+        std::forward<CallbackTypes>(callbacks)...);
+  }
+
+  //! Get the step size.
+  double StepSize() const { return optimizer.StepSize(); }
+  //! Modify the step size.
+  double& StepSize() { return optimizer.StepSize(); }
+
+  //! Get the batch size.
+  size_t BatchSize() const { return optimizer.BatchSize(); }
+  //! Modify the batch size.
+  size_t& BatchSize() { return optimizer.BatchSize(); }
+
+  //! Get the value added to the squared gradient.
+  double Epsilon() const { return optimizer.UpdatePolicy().Epsilon(); }
+  //! Modify the value added to the squared gradient.
+  double& Epsilon() { return optimizer.UpdatePolicy().Epsilon(); }
+
+  //! Get the maximum root mean square of an update.
+  double ClippingThreshold() const
+  { return optimizer.UpdatePolicy().ClippingThreshold(); }
+  //! Modify the maximum root mean square of an update.
+  double& ClippingThreshold()
+  { return optimizer.UpdatePolicy().ClippingThreshold(); }
+
+  //! Get the exponent of the decay of the second moment estimate.
+  double DecayRate() const { return optimizer.UpdatePolicy().DecayRate(); }
+  //! Modify the exponent of the decay of the second moment estimate.
+  double& DecayRate() { return optimizer.UpdatePolicy().DecayRate(); }
+
+  //! Get the smoothing parameter.
+  double Beta1() const { return optimizer.UpdatePolicy().Beta1(); }
+  //! Modify the smoothing parameter.
+  double& Beta1() { return optimizer.UpdatePolicy().Beta1(); }
+
+  //! Get the maximum number of iterations (0 indicates no limit).
+  size_t MaxIterations() const { return optimizer.MaxIterations(); }
+  //! Modify the maximum number of iterations (0 indicates no limit).
+  size_t& MaxIterations() { return optimizer.MaxIterations(); }
+
+  //! Get the tolerance for termination.
+  double Tolerance() const { return optimizer.Tolerance(); }
+  //! Modify the tolerance for termination.
+  double& Tolerance() { return optimizer.Tolerance(); }
+
+  //! Get whether or not the individual functions are shuffled.
+  bool Shuffle() const { return optimizer.Shuffle(); }
+  //! Modify whether or not the individual functions are shuffled.
+  bool& Shuffle() { return optimizer.Shuffle(); }
+
+  //! Get whether or not the actual objective is calculated.
+  bool ExactObjective() const { return optimizer.ExactObjective(); }
+  //! Modify whether or not the actual objective is calculated.
+  bool& ExactObjective() { return optimizer.ExactObjective(); }
+
+  //! Get whether or not the update policy parameters are reset before
+  //! Optimize call.
+  bool ResetPolicy() const { return optimizer.ResetPolicy(); }
+  //! Modify whether or not the update policy parameters
+  //! are reset before Optimize call.
+  bool& ResetPolicy() { return optimizer.ResetPolicy(); }
+
+ private:
+  //! The Stochastic Gradient Descent object with Adafactor policy.
+  SGD<AdafactorUpdate> optimizer;
+};
+
+} // namespace ens
+
+// Include implementation.
+#include "adafactor_impl.hpp"
+
+#endif
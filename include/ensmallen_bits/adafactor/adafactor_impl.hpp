@@ -0,0 +1,44 @@
+/**
+ * @file adafactor_impl.hpp
+ *
+ * Implementation of the Adafactor optimizer.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_ADAFACTOR_ADAFACTOR_IMPL_HPP
+#define ENSMALLEN_ADAFACTOR_ADAFACTOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "adafactor.hpp"
+
+namespace ens {
+
+inline Adafactor::Adafactor(
+    const double stepSize,
+    const size_t batchSize,
+    const double epsilon,
+    const double clippingThreshold,
+    const double decayRate,
+    const double beta1,
+    const size_t maxIterations,
+    const double tolerance,
+    const bool shuffle,
+    const bool resetPolicy,
+    const bool exactObjective) :
+    optimizer(stepSize,
+              batchSize,
+              maxIterations,
+              tolerance,
+              shuffle,
+              AdafactorUpdate(epsilon, clippingThreshold, decayRate, beta1),
+              NoDecay(),
+              resetPolicy,
+              exactObjective)
+{ /* Nothing to do. */ }
+
+} // namespace ens
+
+#endif
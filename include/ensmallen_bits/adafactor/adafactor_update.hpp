@@ -0,0 +1,329 @@
+/**
+ * @file adafactor_update.hpp
+ *
+ * Implements the Adafactor update policy, which keeps a factored estimate of
+ * the second moments of matrix-shaped parameters.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_ADAFACTOR_ADAFACTOR_UPDATE_HPP
+#define ENSMALLEN_ADAFACTOR_ADAFACTOR_UPDATE_HPP
+
+namespace ens {
+
+/**
+ * Adafactor scales the gradient by the inverse square root of an exponential
+ * moving average of the squared gradient, like Adam, but for a matrix of n
+ * rows and m columns it only stores the moving averages of the row sums and
+ * the column sums of the squared gradient.  The second moment of every
+ * element is reconstructed on the fly as the outer product of the two,
+ * divided by their total, so the state takes O(n + m) memory instead of
+ * O(n m).  Vectors (matrices with a single row or column) keep the full
+ * second moment estimate.
+ *
+ * The decay of the moving average grows with the iteration t as
+ * 1 - t^(-decayRate), and the root mean square of every update is clipped to
+ * clippingThreshold.  If beta1 is greater than 0, a first moment estimate of
+ * the (full) size of the parameters is kept as well.
+ *
+ * For more information, see the following.
+ *
+ * @code
+ * @inproceedings{Shazeer2018,
+ *   author    = {Noam Shazeer and Mitchell Stern},
+ *   title     = {Adafactor: Adaptive Learning Rates with Sublinear Memory
+ *                Cost},
+ *   booktitle = {Proceedings of the 35th International Conference on Machine
+ *                Learning},
+ *   pages     = {4596--4604},
+ *   year      = {2018}
+ * }
+ * @endcode
+ */
+class AdafactorUpdate
+{
+ public:
+  /**
+   * Construct the Adafactor update policy with the given parameters.
+   *
+   * @param epsilon Value added to the squared gradient to avoid division by
+   *     zero.
+   * @param clippingThreshold Maximum root mean square of an update.
+   * @param decayRate Exponent of the decay of the second moment estimate.
+   * @param beta1 The smoothing parameter of the first moment estimate (0 means
+   *     no first moment estimate is kept).
+   */
+  AdafactorUpdate(const double epsilon = 1e-30,
+                  const double clippingThreshold = 1.0,
+                  const double decayRate = 0.8,
+                  const double beta1 = 0.0) :
+    epsilon(epsilon),
+    clippingThreshold(clippingThreshold),
+    decayRate(decayRate),
+    beta1(beta1)
+  {
+    // Nothing to do.
+  }
+
+  //! Get the value added to the squared gradient.
+  double Epsilon() const { return epsilon; }
+  //! Modify the value added to the squared gradient.
+  double& Epsilon() { return epsilon; }
+
+  //! Get the maximum root mean square of an update.
+  double ClippingThreshold() const { return clippingThreshold; }
+  //! Modify the maximum root mean square of an update.
+  double& ClippingThreshold() { return clippingThreshold; }
+
+  //! Get the exponent of the decay of the second moment estimate.
+  double DecayRate() const { return decayRate; }
+  //! Modify the exponent of the decay of the second moment estimate.
+  double& DecayRate() { return decayRate; }
+
+  //! Get the smoothing parameter.
+  double Beta1() const { return beta1; }
+  //! Modify the smoothing parameter.
+  double& Beta1() { return beta1; }
+
+  /**
+   * The UpdatePolicyType policy classes must contain an internal 'Policy'
+   * template class with two template arguments: MatType and GradType.  This is
+   * instantiated at the start of the optimization, and holds parameters
+   * specific to an individual optimization.
+   */
+  template<typename MatType, typename GradType>
+  class Policy
+  {
+   public:
+    typedef typename MatType::elem_type ElemType;
+
+    /**
+     * This constructor is called by the SGD Optimize() method before the start
+     * of the iteration update process.
+     *
+     * @param parent AdafactorUpdate object.
+     * @param rows Number of rows in the gradient matrix.
+     * @param cols Number of columns in the gradient matrix.
+     */
+    Policy(AdafactorUpdate& parent, const size_t rows, const size_t cols) :
+        parent(parent),
+        factored(rows > 1 && cols > 1),
+        iteration(0)
+    {
+      if (factored)
+      {
+        r.zeros(rows);
+        c.zeros(cols);
+      }
+      else
+      {
+        v.zeros(rows, cols);
+      }
+
+      if (parent.beta1 > 0)
+        m.zeros(rows, cols);
+    }
+
+    /**
+     * Update step for Adafactor.
+     *
+     * @param iterate Parameters that minimize the function.
+     * @param stepSize Step size to be used for the given iteration.
+     * @param gradient The gradient matrix.
+     */
+    void Update(MatType& iterate,
+                const double stepSize,
+                const GradType& gradient)
+    {
+      // Increment the iteration counter variable.
+      ++iteration;
+
+      Step(iterate, gradient, stepSize,
+          1.0 - std::pow((double) iteration, -parent.decayRate));
+    }
+
+    //! Get the moving average of the row sums of the squared gradient (empty
+    //! if the second moments are not factored).
+    const arma::Col<ElemType>& R() const { return r; }
+    //! Get the moving average of the column sums of the squared gradient
+    //! (empty if the second moments are not factored).
+    const arma::Row<ElemType>& C() const { return c; }
+    //! Get the full second moment estimate (empty if the second moments are
+    //! factored).
+    const arma::Mat<ElemType>& V() const { return v; }
+
+   private:
+    //! Update the second moment estimate and take a step of the given size.
+    template<typename IterateType, typename GType>
+    void Step(IterateType& iterate,
+              const GType& gradient,
+              const double stepSize,
+              const double beta2)
+    {
+      const arma::Mat<ElemType> g(gradient);
+      arma::Mat<ElemType> update = arma::square(g) + parent.epsilon;
+      if (factored)
+      {
+        r = beta2 * r + (1 - beta2) * arma::sum(update, 1);
+        c = beta2 * c + (1 - beta2) * arma::sum(update, 0);
+        update = (r * c) / arma::accu(r);
+      }
+      else
+      {
+        v = beta2 * v + (1 - beta2) * update;
+        update = v;
+      }
+
+      update = g / arma::sqrt(update);
+      const double rms = arma::norm(update, "fro") /
+          std::sqrt((double) update.n_elem);
+      update /= std::max(1.0, rms / parent.clippingThreshold);
+
+      if (parent.beta1 > 0)
+      {
+        // beta1 may have been set after the policy was constructed.
+        if (m.n_elem != iterate.n_elem)
+          m.zeros(iterate.n_rows, iterate.n_cols);
+
+        m = parent.beta1 * m + (1 - parent.beta1) * update;
+        iterate -= stepSize * m;
+      }
+      else
+      {
+        iterate -= stepSize * update;
+      }
+    }
+
+    //! Dense version of Step(): reconstruct the second moments element by
+    //! element, without temporaries.
+    template<typename eT>
+    void Step(arma::Mat<eT>& iterate,
+              const arma::Mat<eT>& gradient,
+              const double stepSize,
+              const double beta2Double)
+    {
+      const eT beta2 = beta2Double;
+      const eT epsilon = parent.epsilon;
+      const size_t rows = iterate.n_rows;
+      const size_t cols = iterate.n_cols;
+      const size_t n = iterate.n_elem;
+
+      eT* x = iterate.memptr();
+      const eT* g = gradient.memptr();
+
+      // Update the second moment estimates, and find the sum of the squares of
+      // the unclipped update.
+      eT* rMem = r.memptr();
+      eT* cMem = c.memptr();
+      eT* vMem = v.memptr();
+      eT squaredSum = 0;
+      eT rSum = 1;
+      if (factored)
+      {
+        r *= beta2;
+        for (size_t j = 0; j < cols; ++j)
+        {
+          const eT* gCol = g + j * rows;
+          eT colSum = 0;
+          for (size_t i = 0; i < rows; ++i)
+          {
+            const eT gSquared = gCol[i] * gCol[i] + epsilon;
+            rMem[i] += (1 - beta2) * gSquared;
+            colSum += gSquared;
+          }
+          cMem[j] = beta2 * cMem[j] + (1 - beta2) * colSum;
+        }
+
+        rSum = arma::accu(r);
+        for (size_t j = 0; j < cols; ++j)
+        {
+          const eT* gCol = g + j * rows;
+          const eT cScaled = cMem[j] / rSum;
+          for (size_t i = 0; i < rows; ++i)
+            squaredSum += gCol[i] * gCol[i] / (rMem[i] * cScaled);
+        }
+      }
+      else
+      {
+        for (size_t i = 0; i < n; ++i)
+        {
+          vMem[i] = beta2 * vMem[i] + (1 - beta2) * (g[i] * g[i] + epsilon);
+          squaredSum += g[i] * g[i] / vMem[i];
+        }
+      }
+
+      // Clip the root mean square of the update, and take the step.
+      const eT rms = std::sqrt(squaredSum / n);
+      const eT a = stepSize / std::max((eT) 1,
+          rms / (eT) parent.clippingThreshold);
+      const eT beta1 = parent.beta1;
+      // beta1 may have been set after the policy was constructed.
+      if (beta1 > 0 && m.n_elem != n)
+        m.zeros(rows, cols);
+      eT* mMem = m.memptr();
+
+      for (size_t j = 0; j < cols; ++j)
+      {
+        const size_t offset = j * rows;
+        const eT cScaled = factored ? cMem[j] / rSum : 0;
+
+        ENS_PRAGMA_OMP_SIMD
+        for (size_t i = 0; i < rows; ++i)
+        {
+          const eT vHat = factored ? rMem[i] * cScaled : vMem[offset + i];
+          const eT u = g[offset + i] / std::sqrt(vHat);
+          if (beta1 > 0)
+          {
+            mMem[offset + i] = beta1 * mMem[offset + i] + (1 - beta1) * u;
+            x[offset + i] -= a * mMem[offset + i];
+          }
+          else
+          {
+            x[offset + i] -= a * u;
+          }
+        }
+      }
+    }
+
+    //! Instantiated parent object.
+    AdafactorUpdate& parent;
+
+    //! Whether the second moment estimate is factored.
+    bool factored;
+
+    //! The moving average of the row sums of the squared gradient.
+    arma::Col<ElemType> r;
+
+    //! The moving average of the column sums of the squared gradient.
+    arma::Row<ElemType> c;
+
+    //! The moving average of the squared gradient, if it is not factored.
+    arma::Mat<ElemType> v;
+
+    //! The moving average of the update, if beta1 is greater than 0.
+    arma::Mat<ElemType> m;
+
+    //! The number of iterations.
+    size_t iteration;
+  };
+
+ private:
+  //! The value added to the squared gradient.
+  double epsilon;
+
+  //! The maximum root mean square of an update.
+  double clippingThreshold;
+
+  //! The exponent of the decay of the second moment estimate.
+  double decayRate;
+
+  //! The smoothing parameter.
+  double beta1;
+};
+
+} // namespace ens
+
+#endif
@@ -13,6 +13,7 @@
  * simply a variant of Adam based on the infinity norm. AMSGrad is another
  * variant of Adam with guaranteed convergence. Nadam is another variant of
  * Adam based on NAG. NadaMax is a variant for Nadam based on Infinity form.
+ * QuantizedAdam is Adam with its moment estimates stored in 8 bits.
  *
  * ensmallen is free software; you may redistribute it and/or modify it under
  * the terms of the 3-clause BSD license.  You should have received a copy of
@@ -29,6 +30,7 @@
 #include "nadam_update.hpp"
 #include "nadamax_update.hpp"
 #include "optimisticadam_update.hpp"
+#include "quantized_adam_update.hpp"
 
 namespace ens {
 
@@ -213,6 +215,8 @@ using NadaMax = AdamType<NadaMaxUpdate>;
 
 using OptimisticAdam = AdamType<OptimisticAdamUpdate>;
 
+using QuantizedAdam = AdamType<QuantizedAdamUpdate>;
+
 } // namespace ens
 
 // Include implementation.
@@ -114,21 +114,62 @@ class AdaMaxUpdate
       // Increment the iteration counter variable.
       ++iteration;
 
-      // And update the iterate.
+      const double biasCorrection1 = 1.0 - std::pow(parent.beta1, iteration);
+
+      // The moments are always updated, but no step is taken while the bias
+      // correction is 0.
+      Step(iterate, gradient, (biasCorrection1 != 0) ?
+          stepSize / biasCorrection1 : 0.0, biasCorrection1 != 0);
+    }
+
+   private:
+    //! Update the moments and, if takeStep is true, take a step of size alpha.
+    template<typename IterateType, typename GType>
+    void Step(IterateType& iterate,
+              const GType& gradient,
+              const double alpha,
+              const bool takeStep)
+    {
       m *= parent.beta1;
       m += (1 - parent.beta1) * gradient;
 
       // Update the exponentially weighted infinity norm.
       u *= parent.beta2;
-      u = arma::max(u, arma::abs(gradient));
+      MaxAbsInPlace(u, gradient);
 
-      const double biasCorrection1 = 1.0 - std::pow(parent.beta1, iteration);
+      if (takeStep)
+        iterate -= (alpha * m / (u + parent.epsilon));
+    }
 
-      if (biasCorrection1 != 0)
-        iterate -= (stepSize / biasCorrection1 * m / (u + parent.epsilon));
+    //! Dense version of Step(): update the moments and the iterate in a single
+    //! pass over the memory.
+    template<typename eT>
+    void Step(arma::Mat<eT>& iterate,
+              const arma::Mat<eT>& gradient,
+              const double alpha,
+              const bool takeStep)
+    {
+      const eT beta1 = parent.beta1;
+      const eT beta2 = parent.beta2;
+      const eT epsilon = parent.epsilon;
+      const eT a = alpha;
+
+      eT* x = iterate.memptr();
+      eT* mMem = m.memptr();
+      eT* uMem = u.memptr();
+      const eT* g = gradient.memptr();
+
+      const size_t n = iterate.n_elem;
+      ENS_PRAGMA_OMP_SIMD
+      for (size_t i = 0; i < n; ++i)
+      {
+        mMem[i] = beta1 * mMem[i] + (1 - beta1) * g[i];
+        uMem[i] = std::max(beta2 * uMem[i], (eT) std::abs(g[i]));
+        if (takeStep)
+          x[i] -= a * mMem[i] / (uMem[i] + epsilon);
+      }
     }
 
-   private:
     // Instantiated parent object.
     AdaMaxUpdate& parent;
     // The exponential moving average of gradient values.
@@ -116,13 +116,6 @@ class NadamUpdate
       // Increment the iteration counter variable.
       ++iteration;
 
-      // And update the iterate.
-      m *= parent.beta1;
-      m += (1 - parent.beta1) * gradient;
-
-      v *= parent.beta2;
-      v += (1 - parent.beta2) * gradient % gradient;
-
       double beta1T = parent.beta1 * (1 - (0.5 *
           std::pow(0.96, iteration * parent.scheduleDecay)));
 
@@ -138,12 +131,64 @@ class NadamUpdate
       /* Note :- arma::sqrt(v) + epsilon * sqrt(biasCorrection2) is approximated
        * as arma::sqrt(v) + epsilon
        */
-      iterate -= (stepSize * (((1 - beta1T) / biasCorrection1) * gradient
-          + (beta1T1 / biasCorrection3) * m) * sqrt(biasCorrection2))
-          / (arma::sqrt(v) + parent.epsilon);
+      Step(iterate, gradient, (1 - beta1T) / biasCorrection1,
+          beta1T1 / biasCorrection3, stepSize * std::sqrt(biasCorrection2));
     }
 
    private:
+    /**
+     * Update the moments and take a step of size alpha in the direction
+     * gradientWeight * gradient + mWeight * m.
+     */
+    template<typename IterateType, typename GType>
+    void Step(IterateType& iterate,
+              const GType& gradient,
+              const double gradientWeight,
+              const double mWeight,
+              const double alpha)
+    {
+      m *= parent.beta1;
+      m += (1 - parent.beta1) * gradient;
+
+      v *= parent.beta2;
+      v += (1 - parent.beta2) * gradient % gradient;
+
+      iterate -= (alpha * (gradientWeight * gradient + mWeight * m)) /
+          (arma::sqrt(v) + parent.epsilon);
+    }
+
+    //! Dense version of Step(): update the moments and the iterate in a single
+    //! pass over the memory.
+    template<typename eT>
+    void Step(arma::Mat<eT>& iterate,
+              const arma::Mat<eT>& gradient,
+              const double gradientWeight,
+              const double mWeight,
+              const double alpha)
+    {
+      const eT beta1 = parent.beta1;
+      const eT beta2 = parent.beta2;
+      const eT epsilon = parent.epsilon;
+      const eT gw = gradientWeight;
+      const eT mw = mWeight;
+      const eT a = alpha;
+
+      eT* x = iterate.memptr();
+      eT* mMem = m.memptr();
+      eT* vMem = v.memptr();
+      const eT* g = gradient.memptr();
+
+      const size_t n = iterate.n_elem;
+      ENS_PRAGMA_OMP_SIMD
+      for (size_t i = 0; i < n; ++i)
+      {
+        mMem[i] = beta1 * mMem[i] + (1 - beta1) * g[i];
+        vMem[i] = beta2 * vMem[i] + (1 - beta2) * (g[i] * g[i]);
+        x[i] -= (a * (gw * g[i] + mw * mMem[i])) /
+            (std::sqrt(vMem[i]) + epsilon);
+      }
+    }
+
     // Instantiated parent object.
     NadamUpdate& parent;
 
@@ -116,12 +116,6 @@ class NadaMaxUpdate
       // Increment the iteration counter variable.
       ++iteration;
 
-      // And update the iterate.
-      m *= parent.beta1;
-      m += (1 - parent.beta1) * gradient;
-
-      u = arma::max(u * parent.beta2, arma::abs(gradient));
-
       double beta1T = parent.beta1 * (1 - (0.5 *
           std::pow(0.96, iteration * parent.scheduleDecay)));
 
@@ -134,14 +128,74 @@ class NadaMaxUpdate
 
       const double biasCorrection2 = 1.0 - (cumBeta1 * beta1T1);
 
-      if ((biasCorrection1 != 0) && (biasCorrection2 != 0))
+      // The moments are always updated, but no step is taken while a bias
+      // correction is 0.
+      const bool takeStep = (biasCorrection1 != 0) && (biasCorrection2 != 0);
+      Step(iterate, gradient,
+          takeStep ? (1 - beta1T) / biasCorrection1 : 0.0,
+          takeStep ? beta1T1 / biasCorrection2 : 0.0, stepSize, takeStep);
+    }
+
+   private:
+    /**
+     * Update the moments and, if takeStep is true, take a step of size alpha in
+     * the direction gradientWeight * gradient + mWeight * m.
+     */
+    template<typename IterateType, typename GType>
+    void Step(IterateType& iterate,
+              const GType& gradient,
+              const double gradientWeight,
+              const double mWeight,
+              const double alpha,
+              const bool takeStep)
+    {
+      m *= parent.beta1;
+      m += (1 - parent.beta1) * gradient;
+
+      // Update the exponentially weighted infinity norm.
+      u *= parent.beta2;
+      MaxAbsInPlace(u, gradient);
+
+      if (takeStep)
       {
-         iterate -= (stepSize * (((1 - beta1T) / biasCorrection1) * gradient
-             + (beta1T1 / biasCorrection2) * m)) / (u + parent.epsilon);
+        iterate -= (alpha * (gradientWeight * gradient + mWeight * m)) /
+            (u + parent.epsilon);
+      }
+    }
+
+    //! Dense version of Step(): update the moments and the iterate in a single
+    //! pass over the memory.
+    template<typename eT>
+    void Step(arma::Mat<eT>& iterate,
+              const arma::Mat<eT>& gradient,
+              const double gradientWeight,
+              const double mWeight,
+              const double alpha,
+              const bool takeStep)
+    {
+      const eT beta1 = parent.beta1;
+      const eT beta2 = parent.beta2;
+      const eT epsilon = parent.epsilon;
+      const eT gw = gradientWeight;
+      const eT mw = mWeight;
+      const eT a = alpha;
+
+      eT* x = iterate.memptr();
+      eT* mMem = m.memptr();
+      eT* uMem = u.memptr();
+      const eT* g = gradient.memptr();
+
+      const size_t n = iterate.n_elem;
+      ENS_PRAGMA_OMP_SIMD
+      for (size_t i = 0; i < n; ++i)
+      {
+        mMem[i] = beta1 * mMem[i] + (1 - beta1) * g[i];
+        uMem[i] = std::max(beta2 * uMem[i], (eT) std::abs(g[i]));
+        if (takeStep)
+          x[i] -= (a * (gw * g[i] + mw * mMem[i])) / (uMem[i] + epsilon);
       }
     }
 
-   private:
     // Instantiated parent object.
     NadaMaxUpdate& parent;
 
@@ -112,15 +112,28 @@ class OptimisticAdamUpdate
       // Increment the iteration counter variable.
       ++iteration;
 
-      // And update the iterate.
+      Step(iterate, gradient, stepSize,
+          1.0 - std::pow(parent.beta1, iteration),
+          1.0 - std::pow(parent.beta2, iteration));
+    }
+
+   private:
+    //! Update the moments, take the optimistic step and save the update.
+    template<typename IterateType, typename GType>
+    void Step(IterateType& iterate,
+              const GType& gradient,
+              const double stepSize,
+              const double biasCorrection1,
+              const double biasCorrection2)
+    {
       m *= parent.beta1;
       m += (1 - parent.beta1) * gradient;
 
       v *= parent.beta2;
       v += (1 - parent.beta2) * arma::square(gradient);
 
-      GradType mCorrected = m / (1.0 - std::pow(parent.beta1, iteration));
-      GradType vCorrected = v / (1.0 - std::pow(parent.beta2, iteration));
+      GradType mCorrected = m / biasCorrection1;
+      GradType vCorrected = v / biasCorrection2;
 
       GradType update = mCorrected / (arma::sqrt(vCorrected) + parent.epsilon);
 
@@ -129,7 +142,41 @@ class OptimisticAdamUpdate
       g = std::move(update);
     }
 
-   private:
+    //! Dense version of Step(): update the moments, the iterate and the saved
+    //! update in a single pass over the memory.
+    template<typename eT>
+    void Step(arma::Mat<eT>& iterate,
+              const arma::Mat<eT>& gradient,
+              const double stepSize,
+              const double biasCorrection1,
+              const double biasCorrection2)
+    {
+      const eT beta1 = parent.beta1;
+      const eT beta2 = parent.beta2;
+      const eT epsilon = parent.epsilon;
+      const eT a = stepSize;
+      const eT bc1 = biasCorrection1;
+      const eT bc2 = biasCorrection2;
+
+      eT* x = iterate.memptr();
+      eT* mMem = m.memptr();
+      eT* vMem = v.memptr();
+      eT* gOld = g.memptr();
+      const eT* gNew = gradient.memptr();
+
+      const size_t n = iterate.n_elem;
+      ENS_PRAGMA_OMP_SIMD
+      for (size_t i = 0; i < n; ++i)
+      {
+        mMem[i] = beta1 * mMem[i] + (1 - beta1) * gNew[i];
+        vMem[i] = beta2 * vMem[i] + (1 - beta2) * (gNew[i] * gNew[i]);
+        const eT update = (mMem[i] / bc1) /
+            (std::sqrt(vMem[i] / bc2) + epsilon);
+        x[i] -= 2 * a * update - a * gOld[i];
+        gOld[i] = update;
+      }
+    }
+
     // Instantiated parent object.
     OptimisticAdamUpdate& parent;
 
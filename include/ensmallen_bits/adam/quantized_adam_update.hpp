@@ -0,0 +1,213 @@
+/**
+ * @file quantized_adam_update.hpp
+ *
+ * Adam update policy that stores the moment estimates with 8 bits per element.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_ADAM_QUANTIZED_ADAM_UPDATE_HPP
+#define ENSMALLEN_ADAM_QUANTIZED_ADAM_UPDATE_HPP
+
+namespace ens {
+
+/**
+ * QuantizedAdamUpdate takes the same steps as AdamUpdate, but stores the first
+ * and second moment estimates as blockwise quantized 8-bit values (see
+ * QuantizedBlocks) instead of at the precision of the coordinates.  The state
+ * then takes about one byte per parameter and moment, instead of eight for
+ * arma::mat (or four for arma::fmat).  Every step decodes one block of the
+ * moments at a time, updates it in full precision together with the
+ * coordinates, and encodes it again, so only a single block is ever held in
+ * full precision.
+ *
+ * The moments are approximations: every element is rounded to a resolution
+ * relative to the largest element of its block, so smaller blocks give more
+ * accurate (but slightly larger) state.  The coordinates and the gradient must
+ * be dense matrices.
+ *
+ * For more information, see the following.
+ *
+ * @code
+ * @inproceedings{Dettmers2022,
+ *   author    = {Tim Dettmers and Mike Lewis and Sam Shleifer and
+ *                Luke Zettlemoyer},
+ *   title     = {8-bit Optimizers via Block-wise Quantization},
+ *   booktitle = {International Conference on Learning Representations},
+ *   year      = {2022}
+ * }
+ * @endcode
+ */
+class QuantizedAdamUpdate
+{
+ public:
+  /**
+   * Construct the quantized Adam update policy with the given parameters.
+   *
+   * @param epsilon The epsilon value used to initialise the squared gradient
+   *        parameter.
+   * @param beta1 The smoothing parameter.
+   * @param beta2 The second moment coefficient.
+   * @param blockSize Number of elements of the moments that share a scale.
+   */
+  QuantizedAdamUpdate(const double epsilon = 1e-8,
+                      const double beta1 = 0.9,
+                      const double beta2 = 0.999,
+                      const size_t blockSize = 256) :
+    epsilon(epsilon),
+    beta1(beta1),
+    beta2(beta2),
+    blockSize(blockSize)
+  {
+    // Nothing to do.
+  }
+
+  //! Get the value used to initialise the squared gradient parameter.
+  double Epsilon() const { return epsilon; }
+  //! Modify the value used to initialise the squared gradient parameter.
+  double& Epsilon() { return epsilon; }
+
+  //! Get the smoothing parameter.
+  double Beta1() const { return beta1; }
+  //! Modify the smoothing parameter.
+  double& Beta1() { return beta1; }
+
+  //! Get the second moment coefficient.
+  double Beta2() const { return beta2; }
+  //! Modify the second moment coefficient.
+  double& Beta2() { return beta2; }
+
+  //! Get the number of elements that share a scale.
+  size_t BlockSize() const { return blockSize; }
+  //! Modify the number of elements that share a scale.
+  size_t& BlockSize() { return blockSize; }
+
+  /**
+   * The UpdatePolicyType policy classes must contain an internal 'Policy'
+   * template class with two template arguments: MatType and GradType.  This is
+   * instantiated at the start of the optimization, and holds parameters
+   * specific to an individual optimization.
+   */
+  template<typename MatType, typename GradType>
+  class Policy
+  {
+   public:
+    typedef typename MatType::elem_type ElemType;
+
+    static_assert(
+        std::is_base_of<arma::Mat<ElemType>, MatType>::value &&
+        std::is_base_of<arma::Mat<ElemType>, GradType>::value,
+        "QuantizedAdamUpdate requires dense coordinates and gradients");
+
+    /**
+     * This constructor is called by the SGD Optimize() method before the start
+     * of the iteration update process.
+     *
+     * @param parent QuantizedAdamUpdate object.
+     * @param rows Number of rows in the gradient matrix.
+     * @param cols Number of columns in the gradient matrix.
+     */
+    Policy(QuantizedAdamUpdate& parent, const size_t rows, const size_t cols) :
+        parent(parent),
+        m(rows * cols, parent.blockSize, true),
+        v(rows * cols, parent.blockSize, false),
+        mBlock(m.BlockSize()),
+        vBlock(v.BlockSize()),
+        iteration(0)
+    {
+      // Nothing to do.
+    }
+
+    /**
+     * Update step for Adam.
+     *
+     * @param iterate Parameters that minimize the function.
+     * @param stepSize Step size to be used for the given iteration.
+     * @param gradient The gradient matrix.
+     */
+    void Update(MatType& iterate,
+                const double stepSize,
+                const GradType& gradient)
+    {
+      // Increment the iteration counter variable.
+      ++iteration;
+
+      const double biasCorrection1 = 1.0 - std::pow(parent.beta1, iteration);
+      const double biasCorrection2 = 1.0 - std::pow(parent.beta2, iteration);
+
+      const ElemType beta1 = parent.beta1;
+      const ElemType beta2 = parent.beta2;
+      const ElemType epsilon = parent.epsilon;
+      const ElemType alpha = stepSize * std::sqrt(biasCorrection2) /
+          biasCorrection1;
+
+      ElemType* x = iterate.memptr();
+      const ElemType* g = gradient.memptr();
+      ElemType* mMem = mBlock.data();
+      ElemType* vMem = vBlock.data();
+
+      for (size_t b = 0; b < m.Blocks(); ++b)
+      {
+        const size_t offset = b * m.BlockSize();
+        const size_t length = m.BlockLength(b);
+
+        m.Decode(b, mMem);
+        v.Decode(b, vMem);
+
+        for (size_t i = 0; i < length; ++i)
+        {
+          const ElemType gi = g[offset + i];
+          mMem[i] = beta1 * mMem[i] + (1 - beta1) * gi;
+          vMem[i] = beta2 * vMem[i] + (1 - beta2) * (gi * gi);
+          x[offset + i] -= alpha * mMem[i] / (std::sqrt(vMem[i]) + epsilon);
+        }
+
+        m.Encode(b, mMem);
+        v.Encode(b, vMem);
+      }
+    }
+
+    //! Get the quantized first moment estimate.
+    const QuantizedBlocks& M() const { return m; }
+    //! Get the quantized second moment estimate.
+    const QuantizedBlocks& V() const { return v; }
+
+   private:
+    // Instantiated parent object.
+    QuantizedAdamUpdate& parent;
+
+    // The exponential moving average of gradient values.
+    QuantizedBlocks m;
+
+    // The exponential moving average of squared gradient values.
+    QuantizedBlocks v;
+
+    // The decoded block of the first moment.
+    std::vector<ElemType> mBlock;
+
+    // The decoded block of the second moment.
+    std::vector<ElemType> vBlock;
+
+    // The number of iterations.
+    size_t iteration;
+  };
+
+ private:
+  // The epsilon value used to initialise the squared gradient parameter.
+  double epsilon;
+
+  // The smoothing parameter.
+  double beta1;
+
+  // The second moment coefficient.
+  double beta2;
+
+  // The number of elements that share a scale.
+  size_t blockSize;
+};
+
+} // namespace ens
+
+#endif
@@ -269,12 +269,15 @@ AGEMOEA::EvaluateObjectives(
     std::tuple<ArbitraryFunctionType...>& objectives,
     std::vector<arma::Col<typename MatType::elem_type> >& calculatedObjectives)
 {
-  for (size_t i = 0; i < populationSize; i++)
-  {
-    calculatedObjectives[i](I) = std::get<I>(objectives).Evaluate(population[i]);
-    EvaluateObjectives<I+1, MatType, ArbitraryFunctionType...>(population, objectives,
-                                                               calculatedObjectives);
-  }
+  // Evaluate objective I for all the candidates at once.
+  arma::Col<typename MatType::elem_type> values;
+  EvaluatePopulation(std::get<I>(objectives), population, populationSize,
+      values);
+  for (size_t i = 0; i < values.n_elem; i++)
+    calculatedObjectives[i](I) = values[i];
+
+  EvaluateObjectives<I+1, MatType, ArbitraryFunctionType...>(population, objectives,
+                                                             calculatedObjectives);
 }
 
 //! Reproduce and generate new candidates.
@@ -0,0 +1,536 @@
+/**
+ * @file profile_trace.hpp
+ *
+ * Implementation of a profiling callback that writes a Chrome trace.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_CALLBACKS_PROFILE_TRACE_HPP
+#define ENSMALLEN_CALLBACKS_PROFILE_TRACE_HPP
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+
+namespace ens {
+
+class ProfileTraceMarker;
+
+/**
+ * Profiling callback that timestamps every callback hook and writes the
+ * timeline of the optimization as a Chrome trace (the trace-event JSON format
+ * read by chrome://tracing, Perfetto and speedscope).
+ *
+ * The time between two hooks is attributed to the phase that ends with the
+ * second hook: the time up to an Evaluate() or Gradient() hook is the cost of
+ * the function ("Evaluate", "Gradient"; an EvaluateWithGradient() call shows up
+ * as "Evaluate" followed by an empty "Gradient"), the time up to StepTaken() is
+ * the cost of the update ("Update"), and so on.  Iterations (between two
+ * StepTaken() hooks) and epochs (from BeginEpoch() to EndEpoch()) are shown on
+ * separate tracks.
+ *
+ * The time spent in the other callbacks is part of the following phase.  To
+ * see it separately, pass Marker() as the last callback; the time between this
+ * callback and the marker is then shown as "Callbacks":
+ *
+ * @code
+ * ProfileTrace profiler("trace.json");
+ * optimizer.Optimize(f, coordinates, profiler, PrintLoss(), profiler.Marker());
+ * @endcode
+ *
+ * Events are stored in a ring buffer of `capacity` events (24 bytes each on
+ * 64-bit platforms) that is allocated up front, so recording an event takes one
+ * clock read and never allocates; when the buffer is full, the oldest events
+ * are overwritten.  The trace is written at the end of the optimization.  The
+ * callback must only be used by one optimization at a time.
+ */
+class ProfileTrace
+{
+ public:
+  /**
+   * Set up the profiling callback.
+   *
+   * @param filename File to write the trace to at the end of the optimization;
+   *     if empty, the trace is only kept in memory (see Write()).
+   * @param capacity Maximum number of events to keep; the buffer is allocated
+   *     when the callback is constructed.
+   */
+  ProfileTrace(const std::string& filename = "trace.json",
+               const size_t capacity = 1 << 16) :
+      filename(filename),
+      events(std::max(capacity, (size_t) 1)),
+      next(0),
+      recorded(0),
+      origin(Clock::now())
+  { /* Nothing to do here. */ }
+
+  /**
+   * Callback function called at the beginning of the optimization process.
+   *
+   * @param optimizer The optimizer used to update the function.
+   * @param function Function to optimize.
+   * @param coordinates Starting point.
+   */
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void BeginOptimization(OptimizerType& /* optimizer */,
+                         FunctionType& /* function */,
+                         MatType& /* coordinates */)
+  {
+    Record(BEGIN_OPTIMIZATION);
+  }
+
+  /**
+   * Callback function called at the end of the optimization process; writes
+   * the trace.
+   *
+   * @param optimizer The optimizer used to update the function.
+   * @param function Function to optimize.
+   * @param coordinates Final point.
+   */
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void EndOptimization(OptimizerType& /* optimizer */,
+                       FunctionType& /* function */,
+                       MatType& /* coordinates */)
+  {
+    Record(END_OPTIMIZATION);
+
+    if (filename.empty())
+      return;
+
+    std::ofstream stream(filename.c_str());
+    if (!stream.is_open())
+    {
+      Warn << "ProfileTrace: cannot open '" << filename << "' for writing."
+          << std::endl;
+      return;
+    }
+
+    Write(stream);
+  }
+
+  /**
+   * Callback function called at any call to Evaluate().
+   *
+   * @param optimizer The optimizer used to update the function.
+   * @param function Function to optimize.
+   * @param coordinates Current point.
+   * @param objective Objective value of the current point.
+   */
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  bool Evaluate(OptimizerType& /* optimizer */,
+                FunctionType& /* function */,
+                const MatType& /* coordinates */,
+                const double /* objective */)
+  {
+    Record(EVALUATE);
+    return false;
+  }
+
+  /**
+   * Callback function called at any call to EvaluateConstraint().
+   *
+   * @param optimizer The optimizer used to update the function.
+   * @param function Function to optimize.
+   * @param coordinates Current point.
+   * @param constraint The index of the constraint.
+   * @param constraintValue Value of the constraint at the current point.
+   */
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  bool EvaluateConstraint(OptimizerType& /* optimizer */,
+                          FunctionType& /* function */,
+                          const MatType& /* coordinates */,
+                          const size_t /* constraint */,
+                          const double /* constraintValue */)
+  {
+    Record(EVALUATE_CONSTRAINT);
+    return false;
+  }
+
+  /**
+   * Callback function called at any call to Gradient().
+   *
+   * @param optimizer The optimizer used to update the function.
+   * @param function Function to optimize.
+   * @param coordinates Current point.
+   * @param gradient Matrix that holds the gradient.
+   */
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  bool Gradient(OptimizerType& /* optimizer */,
+                FunctionType& /* function */,
+                const MatType& /* coordinates */,
+                const MatType& /* gradient */)
+  {
+    Record(GRADIENT);
+    return false;
+  }
+
+  /**
+   * Callback function called at any call to GradientConstraint().
+   *
+   * @param optimizer The optimizer used to update the function.
+   * @param function Function to optimize.
+   * @param coordinates Current point.
+   * @param constraint The index of the constraint.
+   * @param gradient Matrix that holds the gradient of the constraint.
+   */
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  bool GradientConstraint(OptimizerType& /* optimizer */,
+                          FunctionType& /* function */,
+                          const MatType& /* coordinates */,
+                          const size_t /* constraint */,
+                          const MatType& /* gradient */)
+  {
+    Record(GRADIENT_CONSTRAINT);
+    return false;
+  }
+
+  /**
+   * Callback function called once a step is taken.
+   *
+   * @param optimizer The optimizer used to update the function.
+   * @param function Function to optimize.
+   * @param coordinates Current point.
+   */
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  bool StepTaken(OptimizerType& /* optimizer */,
+                 FunctionType& /* function */,
+                 const MatType& /* coordinates */)
+  {
+    Record(STEP_TAKEN);
+    return false;
+  }
+
+  /**
+   * Callback function called at the beginning of a pass over the data.
+   *
+   * @param optimizer The optimizer used to update the function.
+   * @param function Function to optimize.
+   * @param coordinates Current point.
+   * @param epoch The index of the current epoch.
+   * @param objective Objective value of the current point.
+   */
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  bool BeginEpoch(OptimizerType& /* optimizer */,
+                  FunctionType& /* function */,
+                  const MatType& /* coordinates */,
+                  const size_t epoch,
+                  const double /* objective */)
+  {
+    Record(BEGIN_EPOCH, epoch);
+    return false;
+  }
+
+  /**
+   * Callback function called at the end of a pass over the data.
+   *
+   * @param optimizer The optimizer used to update the function.
+   * @param function Function to optimize.
+   * @param coordinates Current point.
+   * @param epoch The index of the current epoch.
+   * @param objective Objective value of the current point.
+   */
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  bool EndEpoch(OptimizerType& /* optimizer */,
+                FunctionType& /* function */,
+                const MatType& /* coordinates */,
+                const size_t epoch,
+                const double /* objective */)
+  {
+    Record(END_EPOCH, epoch);
+    return false;
+  }
+
+  /**
+   * Return a callback that marks the end of the callbacks of every hook; pass
+   * it after all other callbacks.  It refers to this object, which must
+   * outlive it.
+   */
+  ProfileTraceMarker Marker();
+
+  /**
+   * Write the recorded events as a Chrome trace.  Timestamps are given in
+   * microseconds since the construction of the callback.
+   *
+   * @param stream Stream to write the trace to.
+   */
+  void Write(std::ostream& stream) const
+  {
+    const std::streamsize precision = stream.precision(3);
+    const std::ios_base::fmtflags flags = stream.flags();
+    stream << std::fixed;
+
+    stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[" << std::endl;
+    stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,"
+        << "\"args\":{\"name\":\"phases\"}}," << std::endl;
+    stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,"
+        << "\"args\":{\"name\":\"iterations\"}}," << std::endl;
+    stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":3,"
+        << "\"args\":{\"name\":\"epochs\"}}";
+
+    const size_t count = Events();
+    const size_t first = (recorded > events.size()) ? next : 0;
+
+    const Event* previous = NULL;
+    const Event* iterationStart = NULL;
+    const Event* epochStart = NULL;
+    size_t iteration = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+      const Event& event = events[(first + i) % events.size()];
+
+      if (previous != NULL && event.type != BEGIN_OPTIMIZATION)
+        WriteSpan(stream, PhaseName(event.type), 1, *previous, event);
+
+      if (event.type == BEGIN_OPTIMIZATION)
+      {
+        iterationStart = &event;
+        epochStart = NULL;
+        iteration = 0;
+      }
+      else if (event.type == STEP_TAKEN)
+      {
+        if (iterationStart != NULL)
+        {
+          WriteSpan(stream, "Iteration " + std::to_string(iteration), 2,
+              *iterationStart, event);
+        }
+        iterationStart = &event;
+        ++iteration;
+      }
+      else if (event.type == BEGIN_EPOCH)
+      {
+        epochStart = &event;
+      }
+      else if (event.type == END_EPOCH && epochStart != NULL)
+      {
+        WriteSpan(stream, "Epoch " + std::to_string(event.value), 3,
+            *epochStart, event);
+        epochStart = NULL;
+      }
+
+      previous = &event;
+    }
+
+    stream << std::endl << "]}" << std::endl;
+
+    stream.precision(precision);
+    stream.flags(flags);
+  }
+
+  //! Get the number of events kept in the buffer.
+  size_t Events() const { return std::min(recorded, events.size()); }
+  //! Get the number of events that were overwritten because the buffer was
+  //! full.
+  size_t Dropped() const
+  {
+    return (recorded > events.size()) ? recorded - events.size() : 0;
+  }
+
+  //! Forget all recorded events.
+  void Clear() { next = 0; recorded = 0; }
+
+  //! Get the file the trace is written to.
+  const std::string& Filename() const { return filename; }
+  //! Modify the file the trace is written to.
+  std::string& Filename() { return filename; }
+
+ private:
+  friend class ProfileTraceMarker;
+
+  //! The clock used to timestamp the events.
+  typedef std::chrono::steady_clock Clock;
+
+  //! The hooks that are recorded.
+  enum EventType
+  {
+    BEGIN_OPTIMIZATION,
+    END_OPTIMIZATION,
+    EVALUATE,
+    EVALUATE_CONSTRAINT,
+    GRADIENT,
+    GRADIENT_CONSTRAINT,
+    STEP_TAKEN,
+    BEGIN_EPOCH,
+    END_EPOCH,
+    CALLBACKS
+  };
+
+  //! A recorded hook.
+  struct Event
+  {
+    //! Nanoseconds since the construction of the callback.
+    uint64_t time;
+    //! The hook.
+    EventType type;
+    //! The epoch, for BEGIN_EPOCH and END_EPOCH.
+    size_t value;
+  };
+
+  //! Record the given hook.
+  void Record(const EventType type, const size_t value = 0)
+  {
+    Event& event = events[next];
+    event.time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        Clock::now() - origin).count();
+    event.type = type;
+    event.value = value;
+
+    if (++next == events.size())
+      next = 0;
+    ++recorded;
+  }
+
+  //! Return the name of the phase that ends with the given hook.
+  static const char* PhaseName(const EventType type)
+  {
+    switch (type)
+    {
+      case EVALUATE: return "Evaluate";
+      case EVALUATE_CONSTRAINT: return "EvaluateConstraint";
+      case GRADIENT: return "Gradient";
+      case GRADIENT_CONSTRAINT: return "GradientConstraint";
+      case STEP_TAKEN: return "Update";
+      case BEGIN_EPOCH: return "BeginEpoch";
+      case END_EPOCH: return "EndEpoch";
+      case CALLBACKS: return "Callbacks";
+      case END_OPTIMIZATION: return "Finalize";
+      default: return "Optimization";
+    }
+  }
+
+  //! Write a complete event that covers the time between the given events.
+  static void WriteSpan(std::ostream& stream,
+                        const std::string& name,
+                        const size_t track,
+                        const Event& begin,
+                        const Event& end)
+  {
+    stream << "," << std::endl << "{\"name\":\"" << name
+        << "\",\"cat\":\"ensmallen\",\"ph\":\"X\",\"pid\":1,\"tid\":" << track
+        << ",\"ts\":" << begin.time / 1e3 << ",\"dur\":"
+        << (end.time - begin.time) / 1e3 << "}";
+  }
+
+  //! The file the trace is written to.
+  std::string filename;
+  //! The ring buffer of events.
+  std::vector<Event> events;
+  //! The position of the next event in the buffer.
+  size_t next;
+  //! The number of events recorded since the last Clear().
+  size_t recorded;
+  //! The time all timestamps are relative to.
+  Clock::time_point origin;
+};
+
+/**
+ * Callback that marks the end of the callbacks of every hook for a
+ * ProfileTrace; see ProfileTrace::Marker().
+ */
+class ProfileTraceMarker
+{
+ public:
+  /**
+   * Create a marker for the given profiling callback.
+   *
+   * @param profiler Profiling callback to record the marks in.
+   */
+  ProfileTraceMarker(ProfileTrace& profiler) : profiler(profiler)
+  { /* Nothing to do here. */ }
+
+  //! Mark the end of the Evaluate() callbacks.
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  bool Evaluate(OptimizerType& /* optimizer */,
+                FunctionType& /* function */,
+                const MatType& /* coordinates */,
+                const double /* objective */)
+  {
+    profiler.Record(ProfileTrace::CALLBACKS);
+    return false;
+  }
+
+  //! Mark the end of the EvaluateConstraint() callbacks.
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  bool EvaluateConstraint(OptimizerType& /* optimizer */,
+                          FunctionType& /* function */,
+                          const MatType& /* coordinates */,
+                          const size_t /* constraint */,
+                          const double /* constraintValue */)
+  {
+    profiler.Record(ProfileTrace::CALLBACKS);
+    return false;
+  }
+
+  //! Mark the end of the Gradient() callbacks.
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  bool Gradient(OptimizerType& /* optimizer */,
+                FunctionType& /* function */,
+                const MatType& /* coordinates */,
+                const MatType& /* gradient */)
+  {
+    profiler.Record(ProfileTrace::CALLBACKS);
+    return false;
+  }
+
+  //! Mark the end of the GradientConstraint() callbacks.
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  bool GradientConstraint(OptimizerType& /* optimizer */,
+                          FunctionType& /* function */,
+                          const MatType& /* coordinates */,
+                          const size_t /* constraint */,
+                          const MatType& /* gradient */)
+  {
+    profiler.Record(ProfileTrace::CALLBACKS);
+    return false;
+  }
+
+  //! Mark the end of the StepTaken() callbacks.
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  bool StepTaken(OptimizerType& /* optimizer */,
+                 FunctionType& /* function */,
+                 const MatType& /* coordinates */)
+  {
+    profiler.Record(ProfileTrace::CALLBACKS);
+    return false;
+  }
+
+  //! Mark the end of the BeginEpoch() callbacks.
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  bool BeginEpoch(OptimizerType& /* optimizer */,
+                  FunctionType& /* function */,
+                  const MatType& /* coordinates */,
+                  const size_t /* epoch */,
+                  const double /* objective */)
+  {
+    profiler.Record(ProfileTrace::CALLBACKS);
+    return false;
+  }
+
+  //! Mark the end of the EndEpoch() callbacks.
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  bool EndEpoch(OptimizerType& /* optimizer */,
+                FunctionType& /* function */,
+                const MatType& /* coordinates */,
+                const size_t /* epoch */,
+                const double /* objective */)
+  {
+    profiler.Record(ProfileTrace::CALLBACKS);
+    return false;
+  }
+
+ private:
+  //! The profiling callback.
+  ProfileTrace& profiler;
+};
+
+inline ProfileTraceMarker ProfileTrace::Marker()
+{
+  return ProfileTraceMarker(*this);
+}
+
+} // namespace ens
+
+#endif
@@ -0,0 +1,459 @@
+/**
+ * @file prometheus_metrics.hpp
+ *
+ * Implementation of a callback that exports optimization metrics in the
+ * Prometheus text format.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_CALLBACKS_PROMETHEUS_METRICS_HPP
+#define ENSMALLEN_CALLBACKS_PROMETHEUS_METRICS_HPP
+
+#include <ensmallen_bits/function.hpp>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+
+#ifdef _WIN32
+// std::rename() can't replace an existing file on Windows.  Only declare
+// MoveFileExA(), so that <windows.h> and its macros (min(), max(), ...) are not
+// pulled into every translation unit; the declaration matches the one in
+// <winbase.h>.
+extern "C" __declspec(dllimport) int __stdcall MoveFileExA(
+    const char* existingFileName,
+    const char* newFileName,
+    unsigned long flags);
+#endif
+
+namespace ens {
+
+/**
+ * Callback that keeps counters and gauges of the optimization and periodically
+ * rewrites a file in the Prometheus text exposition format, e.g. for the
+ * textfile collector of the node exporter.  The file is written to a temporary
+ * file first and then renamed, so a scraper never sees a partial file.
+ *
+ * The following metrics are exported (with the given prefix):
+ *
+ *  - iterations_total, epochs_total, evaluations_total,
+ *    gradient_evaluations_total (counters);
+ *  - iterations_per_second, evaluations_per_second (gauges, averaged over the
+ *    time since the previous write);
+ *  - objective, gradient_norm, and step_size if the optimizer has a
+ *    StepSize() method (gauges);
+ *  - elapsed_seconds, last_step_timestamp_seconds (Unix time of the last step,
+ *    for stall alerts) and running (gauges).
+ *
+ * Counters accumulate over all the optimizations the callback is used for.
+ * The file is written at the beginning and the end of every optimization, and
+ * after a step or an epoch when at least `interval` seconds passed since the
+ * previous write.
+ */
+class PrometheusMetrics
+{
+ public:
+  /**
+   * Set up the metrics callback.
+   *
+   * @param filename File to write the metrics to.
+   * @param interval Minimum number of seconds between two writes.
+   * @param prefix Prefix of the metric names.
+   */
+  PrometheusMetrics(const std::string& filename,
+                    const double interval = 10.0,
+                    const std::string& prefix = "ensmallen") :
+      filename(filename),
+      interval(interval),
+      prefix(prefix),
+      iterations(0),
+      epochs(0),
+      evaluations(0),
+      gradientEvaluations(0),
+      objective(0),
+      gradientNorm(0),
+      stepSize(0),
+      hasGradient(false),
+      hasStepSize(false),
+      running(false),
+      writes(0),
+      lastIterations(0),
+      lastEvaluations(0),
+      lastStepTime(0),
+      elapsedAtEnd(0)
+  { /* Nothing to do here. */ }
+
+  /**
+   * Callback function called at the beginning of the optimization process.
+   *
+   * @param optimizer The optimizer used to update the function.
+   * @param function Function to optimize.
+   * @param coordinates Starting point.
+   */
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void BeginOptimization(OptimizerType& optimizer,
+                         FunctionType& /* function */,
+                         MatType& /* coordinates */)
+  {
+    start = Clock::now();
+    lastWrite = start;
+    lastAttempt = start;
+    lastIterations = iterations;
+    lastEvaluations = evaluations;
+    lastStepTime = UnixTime();
+    running = true;
+
+    SaveStepSize(optimizer);
+    Write(start);
+  }
+
+  /**
+   * Callback function called at the end of the optimization process.
+   *
+   * @param optimizer The optimizer used to update the function.
+   * @param function Function to optimize.
+   * @param coordinates Final point.
+   */
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void EndOptimization(OptimizerType& optimizer,
+                       FunctionType& /* function */,
+                       MatType& /* coordinates */)
+  {
+    running = false;
+    SaveStepSize(optimizer);
+    Write(Clock::now());
+  }
+
+  /**
+   * Callback function called at any call to Evaluate().
+   *
+   * @param optimizer The optimizer used to update the function.
+   * @param function Function to optimize.
+   * @param coordinates Current point.
+   * @param objectiveIn Objective value of the current point.
+   */
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  bool Evaluate(OptimizerType& /* optimizer */,
+                FunctionType& /* function */,
+                const MatType& /* coordinates */,
+                const double objectiveIn)
+  {
+    objective = objectiveIn;
+    ++evaluations;
+    return false;
+  }
+
+  /**
+   * Callback function called at any call to Gradient().  The norm of the
+   * gradient is only computed when the next write is due.
+   *
+   * @param optimizer The optimizer used to update the function.
+   * @param function Function to optimize.
+   * @param coordinates Current point.
+   * @param gradient Matrix that holds the gradient.
+   */
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  bool Gradient(OptimizerType& /* optimizer */,
+                FunctionType& /* function */,
+                const MatType& /* coordinates */,
+                const MatType& gradient)
+  {
+    ++gradientEvaluations;
+    if (!hasGradient || Due(Clock::now()))
+    {
+      gradientNorm = arma::norm(gradient);
+      hasGradient = true;
+    }
+    return false;
+  }
+
+  /**
+   * Callback function called once a step is taken.
+   *
+   * @param optimizer The optimizer used to update the function.
+   * @param function Function to optimize.
+   * @param coordinates Current point.
+   */
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  bool StepTaken(OptimizerType& optimizer,
+                 FunctionType& /* function */,
+                 const MatType& /* coordinates */)
+  {
+    ++iterations;
+    const Clock::time_point now = Clock::now();
+    if (Due(now))
+    {
+      lastStepTime = UnixTime();
+      SaveStepSize(optimizer);
+      Write(now);
+    }
+    return false;
+  }
+
+  /**
+   * Callback function called at the end of a pass over the data.
+   *
+   * @param optimizer The optimizer used to update the function.
+   * @param function Function to optimize.
+   * @param coordinates Current point.
+   * @param epoch The index of the current epoch.
+   * @param objectiveIn Objective value of the current point.
+   */
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  bool EndEpoch(OptimizerType& optimizer,
+                FunctionType& /* function */,
+                const MatType& /* coordinates */,
+                const size_t /* epoch */,
+                const double objectiveIn)
+  {
+    ++epochs;
+    objective = objectiveIn;
+    const Clock::time_point now = Clock::now();
+    if (Due(now))
+    {
+      lastStepTime = UnixTime();
+      SaveStepSize(optimizer);
+      Write(now);
+    }
+    return false;
+  }
+
+  //! Get the number of steps taken.
+  size_t Iterations() const { return iterations; }
+  //! Get the number of completed epochs.
+  size_t Epochs() const { return epochs; }
+  //! Get the number of objective evaluations.
+  size_t Evaluations() const { return evaluations; }
+  //! Get the number of gradient evaluations.
+  size_t GradientEvaluations() const { return gradientEvaluations; }
+  //! Get the number of times the file was written.
+  size_t Writes() const { return writes; }
+
+  //! Get the file the metrics are written to.
+  const std::string& Filename() const { return filename; }
+  //! Modify the file the metrics are written to.
+  std::string& Filename() { return filename; }
+
+  //! Get the minimum number of seconds between two writes.
+  double Interval() const { return interval; }
+  //! Modify the minimum number of seconds between two writes.
+  double& Interval() { return interval; }
+
+  //! Get the prefix of the metric names.
+  const std::string& Prefix() const { return prefix; }
+  //! Modify the prefix of the metric names.
+  std::string& Prefix() { return prefix; }
+
+  /**
+   * Write the current metrics in the Prometheus text exposition format.
+   *
+   * @param stream Stream to write the metrics to.
+   */
+  void WriteMetrics(std::ostream& stream) const
+  {
+    const Clock::time_point now = Clock::now();
+    const double elapsed = running ? Seconds(now - start) : elapsedAtEnd;
+    const double sinceWrite = Seconds(now - lastWrite);
+
+    const std::streamsize precision = stream.precision(17);
+
+    WriteMetric(stream, "iterations_total", "counter",
+        "Number of steps taken.", (double) iterations);
+    WriteMetric(stream, "epochs_total", "counter",
+        "Number of completed passes over the data.", (double) epochs);
+    WriteMetric(stream, "evaluations_total", "counter",
+        "Number of objective evaluations.", (double) evaluations);
+    WriteMetric(stream, "gradient_evaluations_total", "counter",
+        "Number of gradient evaluations.", (double) gradientEvaluations);
+    WriteMetric(stream, "iterations_per_second", "gauge",
+        "Steps per second since the previous write.",
+        Rate(iterations - lastIterations, sinceWrite));
+    WriteMetric(stream, "evaluations_per_second", "gauge",
+        "Objective evaluations per second since the previous write.",
+        Rate(evaluations - lastEvaluations, sinceWrite));
+    WriteMetric(stream, "objective", "gauge",
+        "Most recent objective value.", objective);
+    if (hasGradient)
+    {
+      WriteMetric(stream, "gradient_norm", "gauge",
+          "Norm of a recent gradient.", gradientNorm);
+    }
+    if (hasStepSize)
+    {
+      WriteMetric(stream, "step_size", "gauge",
+          "Current step size of the optimizer.", stepSize);
+    }
+    WriteMetric(stream, "elapsed_seconds", "gauge",
+        "Seconds since the beginning of the optimization.", elapsed);
+    WriteMetric(stream, "last_step_timestamp_seconds", "gauge",
+        "Unix time of the most recent reported step.", lastStepTime);
+    WriteMetric(stream, "running", "gauge",
+        "Whether an optimization is in progress.", running ? 1.0 : 0.0);
+
+    stream.precision(precision);
+  }
+
+ private:
+  //! The clock used to measure intervals.
+  typedef std::chrono::steady_clock Clock;
+
+  //! Return whether the next write is due.
+  bool Due(const Clock::time_point now) const
+  {
+    return Seconds(now - lastAttempt) >= interval;
+  }
+
+  //! Write the metrics file and reset the rates.
+  void Write(const Clock::time_point now)
+  {
+    if (!running)
+      elapsedAtEnd = Seconds(now - start);
+
+    // A failed write is not retried before the next interval either.
+    lastAttempt = now;
+
+    // Write to a temporary file and rename it, so that the file is replaced
+    // atomically.
+    const std::string temporary = filename + ".tmp";
+    {
+      std::ofstream stream(temporary.c_str());
+      if (!stream.is_open())
+      {
+        Warn << "PrometheusMetrics: cannot open '" << temporary << "' for "
+            << "writing." << std::endl;
+        return;
+      }
+
+      WriteMetrics(stream);
+    }
+
+    #ifdef _WIN32
+      // 0x1 is MOVEFILE_REPLACE_EXISTING.
+      const bool renamed = (MoveFileExA(temporary.c_str(), filename.c_str(),
+          0x1) != 0);
+    #else
+      const bool renamed = (std::rename(temporary.c_str(),
+          filename.c_str()) == 0);
+    #endif
+    if (!renamed)
+    {
+      Warn << "PrometheusMetrics: cannot rename '" << temporary << "' to '"
+          << filename << "'." << std::endl;
+      return;
+    }
+
+    ++writes;
+    lastWrite = now;
+    lastIterations = iterations;
+    lastEvaluations = evaluations;
+  }
+
+  //! Write one metric with its help and type lines.
+  void WriteMetric(std::ostream& stream,
+                   const char* name,
+                   const char* type,
+                   const char* help,
+                   const double value) const
+  {
+    stream << "# HELP " << prefix << "_" << name << " " << help << std::endl;
+    stream << "# TYPE " << prefix << "_" << name << " " << type << std::endl;
+    stream << prefix << "_" << name << " ";
+    if (std::isnan(value))
+      stream << "NaN";
+    else if (std::isinf(value))
+      stream << (value > 0 ? "+Inf" : "-Inf");
+    else
+      stream << value;
+    stream << std::endl;
+  }
+
+  //! Return the given count per second.
+  static double Rate(const size_t count, const double seconds)
+  {
+    return (seconds > 0) ? count / seconds : 0.0;
+  }
+
+  //! Convert a duration to seconds.
+  static double Seconds(const Clock::duration duration)
+  {
+    return std::chrono::duration<double>(duration).count();
+  }
+
+  //! Return the current Unix time in seconds.
+  static double UnixTime()
+  {
+    return std::chrono::duration<double>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+  }
+
+  /**
+   * Helper function to store the step-size.
+   *
+   * @param optimizer The instantiated optimzer that implements StepSize().
+   */
+  template<typename OptimizerType>
+  typename std::enable_if<traits::HasStepSizeSignature<OptimizerType>::value,
+      void>::type
+  SaveStepSize(const OptimizerType& optimizer)
+  {
+    stepSize = optimizer.StepSize();
+    hasStepSize = true;
+  }
+
+  template<typename OptimizerType>
+  typename std::enable_if<!traits::HasStepSizeSignature<OptimizerType>::value,
+      void>::type
+  SaveStepSize(const OptimizerType& /* optimizer */) { }
+
+  //! The file the metrics are written to.
+  std::string filename;
+  //! The minimum number of seconds between two writes.
+  double interval;
+  //! The prefix of the metric names.
+  std::string prefix;
+
+  //! The number of steps taken.
+  size_t iterations;
+  //! The number of completed epochs.
+  size_t epochs;
+  //! The number of objective evaluations.
+  size_t evaluations;
+  //! The number of gradient evaluations.
+  size_t gradientEvaluations;
+
+  //! The most recent objective.
+  double objective;
+  //! The norm of a recent gradient.
+  double gradientNorm;
+  //! The most recent step size.
+  double stepSize;
+  //! Whether a gradient norm is known.
+  bool hasGradient;
+  //! Whether the optimizer has a step size.
+  bool hasStepSize;
+  //! Whether an optimization is in progress.
+  bool running;
+
+  //! The number of times the file was written.
+  size_t writes;
+  //! The number of steps at the previous write.
+  size_t lastIterations;
+  //! The number of evaluations at the previous write.
+  size_t lastEvaluations;
+  //! The Unix time of the most recent reported step.
+  double lastStepTime;
+  //! The duration of the last finished optimization.
+  double elapsedAtEnd;
+  //! The beginning of the current optimization.
+  Clock::time_point start;
+  //! The time of the previous write.
+  Clock::time_point lastWrite;
+  //! The time of the previous write attempt, successful or not.
+  Clock::time_point lastAttempt;
+};
+
+} // namespace ens
+
+#endif
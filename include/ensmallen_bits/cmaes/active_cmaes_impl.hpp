@@ -196,27 +196,32 @@ typename MatType::elem_type ActiveCMAES<SelectionPolicyType,
 
     arma::eig_sym(eigval, eigvec, C[idx0]);
 
+    BaseMatType z(iterate.n_rows, iterate.n_cols);
+    typedef BatchGeneration<SelectionPolicyType, SeparableFunctionType,
+        BaseMatType> BatchGenerationType;
     for (size_t j = 0; j < lambda; ++j)
     {
+      engine.FillNormal(z);
       if (iterate.n_rows > iterate.n_cols)
-      {
-        pStep[idx(j)] = covLower *
-          arma::randn<BaseMatType>(iterate.n_rows, iterate.n_cols);
-      }
+        pStep[idx(j)] = covLower * z;
       else
-      {
-        pStep[idx(j)] = arma::randn<BaseMatType>(iterate.n_rows, iterate.n_cols)
-          * covLower.t();
-      }
+        pStep[idx(j)] = z * covLower.t();
 
       pPosition[idx(j)] = mPosition[idx0] + sigma(idx0) * pStep[idx(j)];
 
-      // Calculate the objective function.
-      pObjective(idx(j)) = selectionPolicy.Select(function, batchSize,
-          transformationPolicy.Transform(pPosition[idx(j)]), terminate,
-          callbacks...);
+      // Calculate the objective function, unless the whole generation is
+      // scored at once below.
+      if (!BatchGenerationType::value)
+      {
+        pObjective(idx(j)) = selectionPolicy.Select(function, batchSize,
+            transformationPolicy.Transform(pPosition[idx(j)]), terminate,
+            callbacks...);
+      }
     }
 
+    EvaluateGeneration(BatchGenerationType(), *this, transformationPolicy,
+        function, pPosition, pObjective, terminate, callbacks...);
+
     // Sort population.
     idx = arma::sort_index(pObjective);
 
@@ -17,6 +17,7 @@
 
 #include "full_selection.hpp"
 #include "random_selection.hpp"
+#include "evaluate_generation.hpp"
 #include "transformation_policies/empty_transformation.hpp"
 #include "transformation_policies/boundary_box_constraint.hpp"
 
@@ -172,7 +173,15 @@ class CMAES
   double& StepSize()
   { return stepSize; }
 
+  //! Get the random number engine.
+  const RandomEngine& Engine() const { return engine; }
+  //! Modify the random number engine.
+  RandomEngine& Engine() { return engine; }
+
  private:
+  //! The source of random numbers.
+  RandomEngine engine;
+
   //! Population size.
   size_t lambda;
 
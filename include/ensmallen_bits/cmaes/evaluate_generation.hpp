@@ -0,0 +1,95 @@
+/**
+ * @file evaluate_generation.hpp
+ *
+ * Score a whole CMA-ES generation with a single EvaluateBatch() call.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_CMAES_EVALUATE_GENERATION_HPP
+#define ENSMALLEN_CMAES_EVALUATE_GENERATION_HPP
+
+#include <ensmallen_bits/function.hpp>
+#include "full_selection.hpp"
+
+namespace ens {
+
+/**
+ * Whether CMA-ES scores a whole generation at once: the function has to
+ * implement EvaluateBatch(), and every candidate has to be scored on all of
+ * the separable functions (FullSelection), so that the sum computed by the
+ * selection policy is the objective EvaluateBatch() computes.  Otherwise each
+ * candidate is scored by the selection policy as soon as it is sampled.
+ */
+template<typename SelectionPolicyType, typename FunctionType, typename MatType>
+struct BatchGeneration : std::integral_constant<bool,
+    std::is_same<SelectionPolicyType, FullSelection>::value &&
+    traits::HasEvaluateBatchSignature<FunctionType,
+        arma::Mat<typename MatType::elem_type>>::value>
+{ };
+
+/**
+ * Score every candidate of a generation with one EvaluateBatch() call, and
+ * call the Evaluate() callbacks with the objective of every candidate.
+ *
+ * @param optimizer The optimizer, passed to the callbacks.
+ * @param transformationPolicy The transformation applied to every candidate.
+ * @param function Function to evaluate.
+ * @param positions The candidates of the generation.
+ * @param objectives Vector-shaped matrix to store the objectives in.
+ * @param terminate Set to true if a callback asks to terminate.
+ * @param callbacks Callback functions.
+ */
+template<typename OptimizerType,
+         typename TransformationPolicyType,
+         typename FunctionType,
+         typename MatType,
+         typename... CallbackTypes>
+void EvaluateGeneration(std::true_type /* batch */,
+                        OptimizerType& optimizer,
+                        TransformationPolicyType& transformationPolicy,
+                        FunctionType& function,
+                        const std::vector<MatType>& positions,
+                        MatType& objectives,
+                        bool& terminate,
+                        CallbackTypes&... callbacks)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  std::vector<MatType> transformed(positions.size());
+  for (size_t i = 0; i < positions.size(); ++i)
+    transformed[i] = transformationPolicy.Transform(positions[i]);
+
+  arma::Row<ElemType> values;
+  EvaluatePopulation(function, transformed, values);
+  for (size_t i = 0; i < positions.size(); ++i)
+  {
+    objectives(i) = values[i];
+    terminate |= Callback::Evaluate(optimizer, function, transformed[i],
+        values[i], callbacks...);
+  }
+}
+
+//! The generation has already been scored by the selection policy.
+template<typename OptimizerType,
+         typename TransformationPolicyType,
+         typename FunctionType,
+         typename MatType,
+         typename... CallbackTypes>
+void EvaluateGeneration(std::false_type /* batch */,
+                        OptimizerType& /* optimizer */,
+                        TransformationPolicyType& /* transformationPolicy */,
+                        FunctionType& /* function */,
+                        const std::vector<MatType>& /* positions */,
+                        MatType& /* objectives */,
+                        bool& /* terminate */,
+                        CallbackTypes&... /* callbacks */)
+{
+  // Nothing to do.
+}
+
+} // namespace ens
+
+#endif
@@ -89,13 +89,16 @@ class CNE
    *     the next generation.
    * @param tolerance The final value of the objective function for termination.
    *     If set to negative value, tolerance is not considered.
+   * @param numThreads Number of threads used to score each generation (0
+   *     means all available), passed on to ens::EvaluateBatch().
    */
   CNE(const size_t populationSize = 500,
       const size_t maxGenerations = 5000,
       const double mutationProb = 0.1,
       const double mutationSize = 0.02,
       const double selectPercent = 0.2,
-      const double tolerance = 1e-5);
+      const double tolerance = 1e-5,
+      const size_t numThreads = 1);
 
   /**
    * Optimize the given function using CNE. The given
@@ -147,35 +150,52 @@ class CNE
   //! Modify the tolerance.
   double& Tolerance() { return tolerance; }
 
+  //! Get the number of threads used to evaluate the candidates.
+  size_t NumThreads() const { return numThreads; }
+  //! Modify the number of threads used to evaluate the candidates.
+  size_t& NumThreads() { return numThreads; }
+
+  //! Get the random number engine.
+  const RandomEngine& Engine() const { return engine; }
+  //! Modify the random number engine.
+  RandomEngine& Engine() { return engine; }
+
  private:
-  //! Reproduce candidates to create the next generation.
+  //! The source of random numbers.
+  RandomEngine engine;
+
+  //! Reproduce candidates to create the next generation.  Each column of the
+  //! population is a candidate.
   template<typename MatType>
-  void Reproduce(std::vector<MatType>& population,
-                 const MatType& fitnessValues,
+  void Reproduce(MatType& population,
+                 const arma::Row<typename MatType::elem_type>& fitnessValues,
                  arma::uvec& index);
 
   //! Modify weights with some noise for the evolution of next generation.
   template<typename MatType>
-  void Mutate(std::vector<MatType>& population, arma::uvec& index);
+  void Mutate(MatType& population, const arma::uvec& index);
 
   /**
-   * Crossover parents and create new childs. Two parents create two new childs.
+   * Crossover parents and create new childs. Two parents create two new childs;
+   * all pairs of parents are processed at once.
    *
-   * @param mom First parent from the elite population.
-   * @param dad Second parent from the elite population.
-   * @param dropout1 The place to delete the candidate of the present
-   *                 generation and place a child over there for the
-   *                 next generation.
-   * @param dropout2 The place to delete the candidate of the present
-   *                 generation and place a child over there for the
-   *                 next generation.
+   * @param population Population matrix, one candidate per column.
+   * @param moms First parents from the elite population.
+   * @param dads Second parents from the elite population.
+   * @param dropouts1 The places to delete the candidates of the present
+   *                  generation and place the first children over there for
+   *                  the next generation.
+   * @param dropouts2 The places to delete the candidates of the present
+   *                  generation and place the second children over there for
+   *                  the next generation (may hold one entry less than the
+   *                  other arguments, if the number of dropouts is odd).
    */
   template<typename MatType>
-  void Crossover(std::vector<MatType>& population,
-                 const size_t mom,
-                 const size_t dad,
-                 const size_t dropout1,
-                 const size_t dropout2);
+  void Crossover(MatType& population,
+                 const arma::uvec& moms,
+                 const arma::uvec& dads,
+                 const arma::uvec& dropouts1,
+                 const arma::uvec& dropouts2);
 
   //! The number of candidates in the population.
   size_t populationSize;
@@ -195,6 +215,9 @@ class CNE
   //! The final value of the objective function.
   double tolerance;
 
+  //! The number of threads used to evaluate the candidates.
+  size_t numThreads;
+
   //! Number of candidates to become parent for the next generation.
   size_t numElite;
 
@@ -25,13 +25,15 @@ inline CNE::CNE(const size_t populationSize,
                 const double mutationProb,
                 const double mutationSize,
                 const double selectPercent,
-                const double tolerance) :
+                const double tolerance,
+                const size_t numThreads) :
     populationSize(populationSize),
     maxGenerations(maxGenerations),
     mutationProb(mutationProb),
     mutationSize(mutationSize),
     selectPercent(selectPercent),
     tolerance(tolerance),
+    numThreads(numThreads),
     numElite(0),
     elements(0)
 { /* Nothing to do here. */ }
@@ -54,7 +56,7 @@ typename MatType::elem_type CNE::Optimize(ArbitraryFunctionType& function,
   RequireDenseFloatingPointType<BaseMatType>();
 
   // Vector of fitness values corresponding to each candidate.
-  BaseMatType fitnessValues;
+  arma::Row<ElemType> fitnessValues;
   //! Index of sorted fitness values.
   arma::uvec index;
 
@@ -87,21 +89,17 @@ typename MatType::elem_type CNE::Optimize(ArbitraryFunctionType& function,
   }
 
   BaseMatType& iterate = (BaseMatType&) iterateIn;
-
-  // Generate the population based on a Gaussian distribution around the given
-  // starting point.
-  std::vector<BaseMatType> population;
-  for (size_t i = 0 ; i < populationSize; ++i)
-  {
-    population.push_back(arma::randn<BaseMatType>(iterate.n_rows,
-        iterate.n_cols) + iterate);
-  }
+  const size_t rows = iterate.n_rows;
+  const size_t cols = iterate.n_cols;
 
   // Store the number of elements in the objective matrix.
   elements = iterate.n_rows * iterate.n_cols;
 
-  // Initialize helper variables.
-  fitnessValues.set_size(populationSize);
+  // Generate the population based on a Gaussian distribution around the given
+  // starting point.  Each column of the population matrix is a candidate.
+  arma::Mat<ElemType> population(elements, populationSize);
+  engine.FillNormal(population);
+  population.each_col() += arma::vectorise(iterate);
 
   // Controls early termination of the optimization process.
   bool terminate = false;
@@ -118,18 +116,18 @@ typename MatType::elem_type CNE::Optimize(ArbitraryFunctionType& function,
   Callback::BeginOptimization(*this, function, iterate, callbacks...);
   for (size_t gen = 1; gen <= maxGenerations && !terminate; gen++)
   {
-    // Calculating fitness values of all candidates.
+    // Calculating fitness values of all candidates at once.
+    EvaluateBatch(function, population, rows, cols, fitnessValues, numThreads);
+
     for (size_t i = 0; i < populationSize; i++)
     {
-        // Select a candidate and insert the parameters in the function.
-        iterate = population[i];
-        terminate |= Callback::StepTaken(*this, function, iterate,
+        // View the candidate with the shape of the iterate.
+        arma::Mat<ElemType> candidate(population.colptr(i), rows, cols, false,
+            true);
+        terminate |= Callback::StepTaken(*this, function, candidate,
             callbacks...);
 
-        // Find fitness of candidate.
-        fitnessValues[i] = function.Evaluate(iterate);
-
-        terminate |= Callback::Evaluate(*this, function, iterate,
+        terminate |= Callback::Evaluate(*this, function, candidate,
             fitnessValues[i], callbacks...);
     }
 
@@ -152,7 +150,8 @@ typename MatType::elem_type CNE::Optimize(ArbitraryFunctionType& function,
   }
 
   // Set the best candidate into the network parameters.
-  iterateIn = population[index(0)];
+  if (!index.is_empty())
+    iterate = arma::reshape(population.col(index(0)), rows, cols);
 
   // The output of the callback doesn't matter because the optimization is
   // finished.
@@ -165,27 +164,26 @@ typename MatType::elem_type CNE::Optimize(ArbitraryFunctionType& function,
 
 //! Reproduce candidates to create the next generation.
 template<typename MatType>
-inline void CNE::Reproduce(std::vector<MatType>& population,
-                           const MatType& fitnessValues,
+inline void CNE::Reproduce(MatType& population,
+                           const arma::Row<typename MatType::elem_type>&
+                               fitnessValues,
                            arma::uvec& index)
 {
   // Sort fitness values. Smaller fitness value means better performance.
   index = arma::sort_index(fitnessValues);
 
-  // First parent.
-  size_t mom;
-
-  // Second parent.
-  size_t dad;
-
-  for (size_t i = numElite; i < populationSize - 1; i++)
+  // Every pair of dropped-out candidates is replaced by the two children of
+  // two different parents selected randomly from the elite group
+  // [0, numElite).  If the number of dropped-out candidates is odd, the last
+  // pair of parents only replaces one candidate.
+  const size_t numDropouts = populationSize - numElite;
+  const size_t numPairs = (numDropouts + 1) / 2;
+  arma::uvec moms(numPairs), dads(numPairs), children1(numPairs),
+      children2(numDropouts / 2);
+  for (size_t i = 0; i < numPairs; i++)
   {
-    // Select 2 different parents from elite group randomly [0, numElite).
-    mom = arma::as_scalar(arma::randi<arma::uvec>(
-          1, arma::distr_param(0, numElite - 1)));
-
-    dad = arma::as_scalar(arma::randi<arma::uvec>(
-          1, arma::distr_param(0, numElite - 1)));
+    size_t mom = engine.Integer(0, numElite - 1);
+    size_t dad = engine.Integer(0, numElite - 1);
 
     // Making sure both parents are not the same.
     if (mom == dad)
@@ -200,11 +198,15 @@ inline void CNE::Reproduce(std::vector<MatType>& population,
       }
     }
 
-    // Parents generate 2 children replacing the dropped-out candidates.
-    // Also finding the index of these candidates in the population matrix.
-    Crossover(population, index[mom], index[dad], index[i], index[i + 1]);
+    moms[i] = index[mom];
+    dads[i] = index[dad];
+    children1[i] = index[numElite + 2 * i];
+    if (i < children2.n_elem)
+      children2[i] = index[numElite + 2 * i + 1];
   }
 
+  Crossover(population, moms, dads, children1, children2);
+
   // Mutating the weights with small noise values.
   // This is done to bring change in the next generation.
   Mutate(population, index);
@@ -212,47 +214,45 @@ inline void CNE::Reproduce(std::vector<MatType>& population,
 
 //! Crossover parents to create new children.
 template<typename MatType>
-inline void CNE::Crossover(std::vector<MatType>& population,
-                           const size_t mom,
-                           const size_t dad,
-                           const size_t child1,
-                           const size_t child2)
+inline void CNE::Crossover(MatType& population,
+                           const arma::uvec& moms,
+                           const arma::uvec& dads,
+                           const arma::uvec& dropouts1,
+                           const arma::uvec& dropouts2)
 {
-  // Replace the candidates with parents at their place.
-  population[child1] = population[mom];
-  population[child2] = population[dad];
+  typedef typename MatType::elem_type ElemType;
 
-  // Randomly alter mom and dad genome weights to get two different children.
-  for (size_t i = 0; i < elements; i++)
-  {
-    // Using it to alter the weights of the children.
-    const double random = arma::randu<typename MatType::elem_type>();
-    if (random > 0.5)
-    {
-      population[child1](i) = population[mom](i);
-      population[child2](i) = population[dad](i);
-    }
-    else
-    {
-      population[child1](i) = population[dad](i);
-      population[child2](i) = population[mom](i);
-    }
-  }
+  // Each weight of the first child comes from the mom or the dad with equal
+  // probability, and the second child gets the weight of the other parent.
+  // There may be one second child less than there are pairs of parents.
+  const MatType momWeights = population.cols(moms);
+  const MatType dadWeights = population.cols(dads);
+  MatType fromMom(elements, moms.n_elem);
+  engine.FillUniform(fromMom);
+  fromMom.transform([](const ElemType u)
+      { return (u > ElemType(0.5)) ? ElemType(1) : ElemType(0); });
+
+  const MatType children2 = momWeights + fromMom % (dadWeights - momWeights);
+  population.cols(dropouts1) = dadWeights + fromMom % (momWeights - dadWeights);
+  if (dropouts2.n_elem > 0)
+    population.cols(dropouts2) = children2.head_cols(dropouts2.n_elem);
 }
 
 //! Modify weights with some noise for the evolution of next generation.
 template<typename MatType>
-inline void CNE::Mutate(std::vector<MatType>& population, arma::uvec& index)
+inline void CNE::Mutate(MatType& population, const arma::uvec& index)
 {
   // Mutate the whole matrix with the given rate and probability.
+  MatType draws(population.n_rows, population.n_cols);
+  MatType noise(population.n_rows, population.n_cols);
+  engine.FillUniform(draws);
+  engine.FillNormal(noise);
+  noise.elem(arma::find(draws >= mutationProb)).zeros();
+
   // The best candidate is not altered.
-  for (size_t i = 1; i < populationSize; i++)
-  {
-    population[index(i)] += (arma::randu<MatType>(population[index(i)].n_rows,
-        population[index(i)].n_cols) < mutationProb) %
-        (mutationSize * arma::randn<MatType>(population[index(i)].n_rows,
-        population[index(i)].n_cols));
-  }
+  noise.col(index(0)).zeros();
+
+  population += mutationSize * noise;
 }
 
 } // namespace ens
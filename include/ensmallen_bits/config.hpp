@@ -23,6 +23,26 @@
   #define ENS_USE_OPENMP
 #endif
 
+#if !defined(ENS_DETERMINISTIC)
+  // #define ENS_DETERMINISTIC
+  // Uncomment the above line (or define ENS_DETERMINISTIC before including
+  // ensmallen.hpp) to make the parallel code paths bitwise reproducible
+  // regardless of thread scheduling.
+#endif
+
+#if !defined(ENS_USE_PERF_EVENTS)
+  // #define ENS_USE_PERF_EVENTS
+  // Uncomment the above line (or define ENS_USE_PERF_EVENTS before including
+  // ensmallen.hpp) to read hardware performance counters (see PerfCounters)
+  // with perf_event_open(); this is only available on Linux.
+#endif
+
+#if !defined(ENS_DETERMINISTIC_SHARDS)
+  // Number of shards that reductions are split into in deterministic mode;
+  // this is independent of the number of threads.
+  #define ENS_DETERMINISTIC_SHARDS 16
+#endif
+
 
 //
 
@@ -39,6 +59,10 @@
   #undef ENS_USE_OPENMP
 #endif
 
+#if defined(ENS_DONT_USE_PERF_EVENTS) || !defined(__linux__)
+  #undef ENS_USE_PERF_EVENTS
+#endif
+
 
 //
 
@@ -48,11 +72,13 @@
   #define ENS_PRAGMA_OMP_ATOMIC   _Pragma("omp atomic")
   #define ENS_PRAGMA_OMP_CRITICAL _Pragma("omp critical")
   #define ENS_PRAGMA_OMP_CRITICAL_NAMED _Pragma("omp critical(section)")
+  #define ENS_PRAGMA_OMP_SIMD     _Pragma("omp simd")
 #else
   #define ENS_PRAGMA_OMP_PARALLEL
   #define ENS_PRAGMA_OMP_ATOMIC
   #define ENS_PRAGMA_OMP_CRITICAL
   #define ENS_PRAGMA_OMP_CRITICAL_NAMED
+  #define ENS_PRAGMA_OMP_SIMD
 #endif
 
 
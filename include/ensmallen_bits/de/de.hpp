@@ -26,7 +26,8 @@ namespace ens {
  * given starting point. At each pass through the population, the algorithm
  * mutates each candidate solution to create a trial solution. If the trial
  * solution is better than the candidate, it is replaced in the
- * population.
+ * population.  All the trial solutions of a generation are created from the
+ * same population and are evaluated together, optionally on several threads.
  *
  * The evolution takes place in two steps:
  * - Mutation
@@ -73,12 +74,15 @@ class DE
    * @param differentialWeight A parameter used in the mutation of candidate
    *     solutions controls amplification factor of the differentiation.
    * @param tolerance The final value of the objective function for termination.
+   * @param numThreads Number of threads used to evaluate the trial solutions
+   *     of a generation (0 means all available); see ens::EvaluateBatch().
    */
   DE(const size_t populationSize = 100,
      const size_t maxGenerations = 2000,
      const double crossoverRate = 0.6,
      const double differentialWeight = 0.8,
-     const double tolerance = 1e-5);
+     const double tolerance = 1e-5,
+     const size_t numThreads = 1);
 
   /**
    * Optimize the given function using DE. The given
@@ -125,7 +129,20 @@ class DE
   //! Modify the tolerance.
   double& Tolerance() { return tolerance; }
 
+  //! Get the number of threads used to evaluate trial solutions.
+  size_t NumThreads() const { return numThreads; }
+  //! Modify the number of threads used to evaluate trial solutions.
+  size_t& NumThreads() { return numThreads; }
+
+  //! Get the random number engine.
+  const RandomEngine& Engine() const { return engine; }
+  //! Modify the random number engine.
+  RandomEngine& Engine() { return engine; }
+
  private:
+  //! The source of random numbers.
+  RandomEngine engine;
+
   //! The number of candidates in the population.
   size_t populationSize;
 
@@ -140,6 +157,9 @@ class DE
 
   //! The tolerance for termination.
   double tolerance;
+
+  //! The number of threads used to evaluate trial solutions.
+  size_t numThreads;
 };
 
 } // namespace ens
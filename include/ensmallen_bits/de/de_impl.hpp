@@ -21,12 +21,14 @@ inline DE::DE(const size_t populationSize ,
               const size_t maxGenerations,
               const double crossoverRate,
               const double differentialWeight,
-              const double tolerance):
+              const double tolerance,
+              const size_t numThreads):
     populationSize(populationSize),
     maxGenerations(maxGenerations),
     crossoverRate(crossoverRate),
     differentialWeight(differentialWeight),
-    tolerance(tolerance)
+    tolerance(tolerance),
+    numThreads(numThreads)
 { /* Nothing to do here. */ }
 
 //!Optimize the function
@@ -43,12 +45,6 @@ typename MatType::elem_type DE::Optimize(FunctionType& function,
 
   BaseMatType& iterate = (BaseMatType&) iterateIn;
 
-  // Population matrix. Each column is a candidate.
-  std::vector<BaseMatType> population;
-  population.resize(populationSize);
-  // Vector of fitness values corresponding to each candidate.
-  arma::Col<ElemType> fitnessValues;
-
   // Make sure that we have the methods that we need.  Long name...
   traits::CheckArbitraryFunctionTypeAPI<
       FunctionType, BaseMatType>();
@@ -57,96 +53,102 @@ typename MatType::elem_type DE::Optimize(FunctionType& function,
   // Population Size must be at least 3 for DE to work.
   if (populationSize < 3)
   {
-    throw std::logic_error("CNE::Optimize(): population size should be at least"
+    throw std::logic_error("DE::Optimize(): population size should be at least"
         " 3!");
   }
 
-  // Initialize helper variables.
-  fitnessValues.set_size(populationSize);
-  ElemType lastBestFitness = DBL_MAX;
-  BaseMatType bestElement;
+  const size_t rows = iterate.n_rows;
+  const size_t cols = iterate.n_cols;
+
+  // Population matrix. Each column is a candidate, and each candidate of the
+  // generation has a trial vector in the same column of trials.
+  arma::Mat<ElemType> population(iterate.n_elem, populationSize);
+  arma::Mat<ElemType> trials(iterate.n_elem, populationSize);
+  arma::Mat<ElemType> crossoverDraws(iterate.n_elem, populationSize);
+  // Fitness values corresponding to each candidate and trial.
+  arma::Row<ElemType> fitnessValues, trialValues;
+  // Indices of the two random members used for the mutation of every member.
+  arma::uvec l(populationSize), m(populationSize);
 
   // Controls early termination of the optimization process.
   bool terminate = false;
 
   // Generate a population based on a Gaussian distribution around the given
   // starting point. Also finds the best element of the population.
+  engine.FillNormal(population);
+  population.each_col() += arma::vectorise(iterate);
+  EvaluateBatch(function, population, rows, cols, fitnessValues, numThreads);
   for (size_t i = 0; i < populationSize; i++)
   {
-    population[i].randn(iterate.n_rows, iterate.n_cols);
-    population[i] += iterate;
-    fitnessValues[i] = function.Evaluate(population[i]);
-
-    terminate |= Callback::Evaluate(*this, function, population[i],
+    const arma::Mat<ElemType> candidate(population.colptr(i), rows, cols,
+        false, true);
+    terminate |= Callback::Evaluate(*this, function, candidate,
         fitnessValues[i], callbacks...);
-
-    if (fitnessValues[i] < lastBestFitness)
-    {
-      lastBestFitness = fitnessValues[i];
-      bestElement = population[i];
-    }
   }
 
+  size_t bestIndex = fitnessValues.index_min();
+  ElemType lastBestFitness = fitnessValues[bestIndex];
+  arma::Col<ElemType> bestElement = population.col(bestIndex);
+
   // Iterate until maximum number of generations are completed.
   Callback::BeginOptimization(*this, function, iterate, callbacks...);
   for (size_t gen = 0; gen < maxGenerations && !terminate; gen++)
   {
-    // Generate new population based on /best/1/bin strategy.
+    // Generate the trial vectors of the whole generation based on the
+    // /best/1/bin strategy.  For every member, choose two other random
+    // members that differ from each other.
     for (size_t member = 0; member < populationSize; member++)
     {
-      iterate = population[member];
-
-      // Generate two different random numbers to choose two random members.
-      size_t l = 0, m = 0;
       do
       {
-        l = arma::randi<arma::uword>(arma::distr_param(0, populationSize - 1));
+        l[member] = engine.Integer(0, populationSize - 1);
       }
-      while (l == member);
+      while (l[member] == member);
 
       do
       {
-        m = arma::randi<arma::uword>(arma::distr_param(0, populationSize - 1));
+        m[member] = engine.Integer(0, populationSize - 1);
       }
-      while (m == member && m == l);
-
-      // Generate new "mutant" from two randomly chosen members.
-      BaseMatType mutant = bestElement + differentialWeight *
-          (population[l] - population[m]);
+      while (m[member] == member || m[member] == l[member]);
+    }
 
-      // Perform crossover.
-      const BaseMatType cr = arma::randu<BaseMatType>(iterate.n_rows);
-      for (size_t it = 0; it < iterate.n_rows; it++)
-      {
-        if (cr[it] >= crossoverRate)
-        {
-          mutant[it] = iterate[it];
-        }
-      }
+    // Generate new "mutants" from the randomly chosen members.
+    trials = differentialWeight * (population.cols(l) - population.cols(m));
+    trials.each_col() += bestElement;
 
-      ElemType iterateValue = function.Evaluate(iterate);
-      terminate |= Callback::Evaluate(*this, function, iterate, iterateValue,
-          callbacks...);
+    // Perform crossover: keep the parameters of the current member where the
+    // draw is at least the crossover rate.
+    engine.FillUniform(crossoverDraws);
+    const arma::uvec keep = arma::find(crossoverDraws >= crossoverRate);
+    trials.elem(keep) = population.elem(keep);
 
-      const ElemType mutantValue = function.Evaluate(mutant);
-      terminate |= Callback::Evaluate(*this, function, mutant, mutantValue,
-          callbacks...);
+    // Score all the trial vectors; the fitness of the current members is
+    // already known.
+    EvaluateBatch(function, trials, rows, cols, trialValues, numThreads);
+    for (size_t member = 0; member < populationSize; member++)
+    {
+      const arma::Mat<ElemType> trial(trials.colptr(member), rows, cols,
+          false, true);
+      terminate |= Callback::Evaluate(*this, function, trial,
+          trialValues[member], callbacks...);
+    }
 
-      if (terminate)
-        break;
+    if (terminate)
+      break;
 
-      // Replace the current member if mutant is better.
-      if (mutantValue < iterateValue)
+    // Replace the members whose trial vector is better.
+    for (size_t member = 0; member < populationSize; member++)
+    {
+      if (trialValues[member] < fitnessValues[member])
       {
-        iterate = mutant;
-        iterateValue = mutantValue;
+        population.col(member) = trials.col(member);
+        fitnessValues[member] = trialValues[member];
 
-        terminate |= Callback::StepTaken(*this, function, iterate,
+        arma::Mat<ElemType> candidate(population.colptr(member), rows, cols,
+            false, true);
+        terminate |= Callback::StepTaken(*this, function, candidate,
             callbacks...);
       }
-
-      fitnessValues[member] = iterateValue;
-      population[member] = iterate;
     }
 
     // Check for termination criteria.
@@ -158,18 +160,12 @@ typename MatType::elem_type DE::Optimize(FunctionType& function,
     }
 
     // Update helper variables.
-    lastBestFitness = fitnessValues.min();
-    for (size_t it = 0; it < populationSize; it++)
-    {
-      if (fitnessValues[it] == lastBestFitness)
-      {
-        bestElement = population[it];
-        break;
-      }
-    }
+    bestIndex = fitnessValues.index_min();
+    lastBestFitness = fitnessValues[bestIndex];
+    bestElement = population.col(bestIndex);
   }
 
-  iterate = bestElement;
+  iterate = arma::reshape(bestElement, rows, cols);
 
   Callback::EndOptimization(*this, function, iterate, callbacks...);
   return lastBestFitness;
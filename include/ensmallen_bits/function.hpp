@@ -22,6 +22,7 @@ class Function;
 
 #include "function/traits.hpp"
 #include "function/static_checks.hpp"
+#include "function/evaluate_batch.hpp"
 #include "function/add_evaluate.hpp"
 #include "function/add_gradient.hpp"
 #include "function/add_evaluate_with_gradient.hpp"
@@ -0,0 +1,165 @@
+/**
+ * @file evaluate_batch.hpp
+ *
+ * Utilities to evaluate a whole population of candidates at once, using the
+ * EvaluateBatch() method of the function if it has one and falling back to
+ * one Evaluate() call per candidate otherwise.  The optimizers built on these
+ * utilities forward their numThreads parameter here: it spreads the Evaluate()
+ * calls over threads, which requires Evaluate() to be thread-safe, and it is
+ * ignored for functions with EvaluateBatch().
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_FUNCTION_EVALUATE_BATCH_HPP
+#define ENSMALLEN_FUNCTION_EVALUATE_BATCH_HPP
+
+#include "traits.hpp"
+#include <ensmallen_bits/utility/parallel.hpp>
+
+namespace ens {
+
+/**
+ * Evaluate the objective of every column of `candidates` with the
+ * EvaluateBatch() method of the function.  Every column holds one candidate
+ * stored in column-major order, so a candidate of size rows x cols occupies
+ * rows * cols elements.
+ *
+ * @param function Function to evaluate.
+ * @param candidates Matrix that holds one candidate per column.
+ * @param rows Number of rows of a candidate (unused).
+ * @param cols Number of columns of a candidate (unused).
+ * @param values Row vector to store the objective of every candidate in.
+ * @param numThreads Unused; EvaluateBatch() is responsible for its own
+ *     parallelism.
+ */
+template<typename FunctionType, typename ElemType>
+typename std::enable_if<traits::HasEvaluateBatchSignature<
+    FunctionType, arma::Mat<ElemType>>::value, void>::type
+EvaluateBatch(FunctionType& function,
+              const arma::Mat<ElemType>& candidates,
+              const size_t /* rows */,
+              const size_t /* cols */,
+              arma::Row<ElemType>& values,
+              const size_t /* numThreads */ = 1)
+{
+  values.set_size(candidates.n_cols);
+  function.EvaluateBatch(candidates, values);
+}
+
+/**
+ * Evaluate the objective of every column of `candidates` with one Evaluate()
+ * call per candidate, for functions without an EvaluateBatch() method.  The
+ * candidates are not copied; every column is viewed as a rows x cols matrix.
+ * If numThreads is not 1, the candidates are evaluated concurrently, so
+ * Evaluate() must be safe to call from several threads at once.
+ *
+ * @param function Function to evaluate.
+ * @param candidates Matrix that holds one candidate per column.
+ * @param rows Number of rows of a candidate.
+ * @param cols Number of columns of a candidate.
+ * @param values Row vector to store the objective of every candidate in.
+ * @param numThreads Number of threads to use (0 means all available).
+ */
+template<typename FunctionType, typename ElemType>
+typename std::enable_if<!traits::HasEvaluateBatchSignature<
+    FunctionType, arma::Mat<ElemType>>::value, void>::type
+EvaluateBatch(FunctionType& function,
+              const arma::Mat<ElemType>& candidates,
+              const size_t rows,
+              const size_t cols,
+              arma::Row<ElemType>& values,
+              const size_t numThreads = 1)
+{
+  values.set_size(candidates.n_cols);
+  ParallelFor(candidates.n_cols, numThreads, [&](const size_t i)
+  {
+    const arma::Mat<ElemType> candidate(
+        const_cast<ElemType*>(candidates.colptr(i)), rows, cols, false, true);
+    values[i] = function.Evaluate(candidate);
+  });
+}
+
+/**
+ * Evaluate the objective of the first `count` members of the given population.
+ * If the function has an EvaluateBatch() method, these members are packed into
+ * a matrix with one candidate per column and evaluated with a single call;
+ * otherwise Evaluate() is called for every member.
+ *
+ * @param function Function to evaluate.
+ * @param population Candidates to evaluate; all must have the same size.
+ * @param count Number of members to evaluate.
+ * @param values Vector to store the objective of every candidate in.
+ * @param numThreads Unused; EvaluateBatch() is responsible for its own
+ *     parallelism.
+ */
+template<typename FunctionType, typename MatType, typename VecType>
+typename std::enable_if<traits::HasEvaluateBatchSignature<FunctionType,
+    arma::Mat<typename MatType::elem_type>>::value, void>::type
+EvaluatePopulation(FunctionType& function,
+                   const std::vector<MatType>& population,
+                   const size_t count,
+                   VecType& values,
+                   const size_t /* numThreads */ = 1)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  values.set_size(count);
+  if (count == 0)
+    return;
+
+  arma::Mat<ElemType> candidates(population[0].n_elem, count);
+  for (size_t i = 0; i < count; ++i)
+    candidates.col(i) = arma::vectorise(population[i]);
+
+  arma::Row<ElemType> batchValues(count);
+  function.EvaluateBatch(candidates, batchValues);
+  for (size_t i = 0; i < count; ++i)
+    values[i] = batchValues[i];
+}
+
+/**
+ * Evaluate the objective of the first `count` members of the given population
+ * with one Evaluate() call per member, for functions without an
+ * EvaluateBatch() method.  If numThreads is not 1, the members are evaluated
+ * concurrently, so Evaluate() must be safe to call from several threads at
+ * once.
+ *
+ * @param function Function to evaluate.
+ * @param population Candidates to evaluate.
+ * @param count Number of members to evaluate.
+ * @param values Vector to store the objective of every candidate in.
+ * @param numThreads Number of threads to use (0 means all available).
+ */
+template<typename FunctionType, typename MatType, typename VecType>
+typename std::enable_if<!traits::HasEvaluateBatchSignature<FunctionType,
+    arma::Mat<typename MatType::elem_type>>::value, void>::type
+EvaluatePopulation(FunctionType& function,
+                   const std::vector<MatType>& population,
+                   const size_t count,
+                   VecType& values,
+                   const size_t numThreads = 1)
+{
+  values.set_size(count);
+  ParallelFor(count, numThreads, [&](const size_t i)
+  {
+    values[i] = function.Evaluate(population[i]);
+  });
+}
+
+//! Evaluate the objective of every member of the given population.
+template<typename FunctionType, typename MatType, typename VecType>
+void EvaluatePopulation(FunctionType& function,
+                        const std::vector<MatType>& population,
+                        VecType& values,
+                        const size_t numThreads = 1)
+{
+  EvaluatePopulation(function, population, population.size(), values,
+      numThreads);
+}
+
+} // namespace ens
+
+#endif
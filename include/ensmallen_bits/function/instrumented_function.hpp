@@ -0,0 +1,481 @@
+/**
+ * @file instrumented_function.hpp
+ *
+ * A wrapper that counts and times the calls an optimizer makes to a function.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_FUNCTION_INSTRUMENTED_FUNCTION_HPP
+#define ENSMALLEN_FUNCTION_INSTRUMENTED_FUNCTION_HPP
+
+#include <chrono>
+#include <iomanip>
+#include <mutex>
+
+namespace ens {
+
+/**
+ * CallStatistics accumulates the number, the batch sizes and the latencies of
+ * the calls to one method of a function.  Latencies are kept in a logarithmic
+ * histogram with four buckets per power of two, so percentiles are accurate to
+ * about 19% and recording a call takes constant time and memory.
+ */
+class CallStatistics
+{
+ public:
+  //! Create empty statistics.
+  CallStatistics() { Reset(); }
+
+  /**
+   * Record a call.
+   *
+   * @param seconds Duration of the call.
+   * @param batchSize Number of points (or separable functions) the call
+   *     handled.
+   */
+  void Record(const double seconds, const size_t batchSize)
+  {
+    ++calls;
+    points += batchSize;
+    totalTime += seconds;
+    minTime = std::min(minTime, seconds);
+    maxTime = std::max(maxTime, seconds);
+    ++histogram[Bucket(seconds)];
+  }
+
+  //! Forget all recorded calls.
+  void Reset()
+  {
+    calls = 0;
+    points = 0;
+    totalTime = 0.0;
+    minTime = std::numeric_limits<double>::infinity();
+    maxTime = 0.0;
+    std::fill(histogram, histogram + NumBuckets, (size_t) 0);
+  }
+
+  //! Get the number of calls.
+  size_t Calls() const { return calls; }
+  //! Get the total number of points (or separable functions) handled.
+  size_t Points() const { return points; }
+  //! Get the mean batch size of the calls.
+  double MeanBatchSize() const
+  {
+    return (calls == 0) ? 0.0 : (double) points / calls;
+  }
+
+  //! Get the total time spent in the calls, in seconds.
+  double TotalTime() const { return totalTime; }
+  //! Get the mean duration of a call, in seconds.
+  double MeanTime() const { return (calls == 0) ? 0.0 : totalTime / calls; }
+  //! Get the shortest call, in seconds.
+  double MinTime() const { return (calls == 0) ? 0.0 : minTime; }
+  //! Get the longest call, in seconds.
+  double MaxTime() const { return maxTime; }
+
+  /**
+   * Return an estimate of the given percentile of the call durations, in
+   * seconds (e.g. Percentile(0.99) for the 99th percentile).
+   *
+   * @param p Percentile, between 0 and 1.
+   */
+  double Percentile(const double p) const
+  {
+    if (calls == 0)
+      return 0.0;
+
+    const size_t rank = std::max((size_t) std::ceil(p * calls), (size_t) 1);
+    size_t seen = 0;
+    for (size_t b = 0; b < NumBuckets; ++b)
+    {
+      seen += histogram[b];
+      if (seen >= rank)
+      {
+        // Report the geometric center of the bucket, clamped to the observed
+        // range.
+        const double center = std::pow(2.0, (b + 0.5) / BucketsPerOctave) *
+            1e-9;
+        return std::min(std::max(center, minTime), maxTime);
+      }
+    }
+
+    return maxTime;
+  }
+
+ private:
+  //! The number of histogram buckets per power of two.
+  static const size_t BucketsPerOctave = 4;
+  //! The number of histogram buckets; they cover 1ns to about 2^48ns.
+  static const size_t NumBuckets = 48 * BucketsPerOctave;
+
+  //! Return the histogram bucket of the given duration.
+  static size_t Bucket(const double seconds)
+  {
+    const double nanoseconds = seconds * 1e9;
+    if (!(nanoseconds > 1.0))
+      return 0;
+
+    const size_t b = (size_t) (std::log2(nanoseconds) * BucketsPerOctave);
+    return std::min(b, NumBuckets - 1);
+  }
+
+  //! The number of calls.
+  size_t calls;
+  //! The total number of points handled.
+  size_t points;
+  //! The total duration of the calls.
+  double totalTime;
+  //! The shortest call.
+  double minTime;
+  //! The longest call.
+  double maxTime;
+  //! The histogram of the call durations.
+  size_t histogram[NumBuckets];
+};
+
+/**
+ * InstrumentedFunction wraps a function and records how often, with which
+ * batch sizes and for how long an optimizer calls each of its methods.
+ * Comparing the time spent in the function with the total optimization time
+ * shows how much time the optimizer itself takes.
+ *
+ * The wrapper has exactly the methods of the wrapped function (every method is
+ * a forwarding template that only exists if the wrapped function has the
+ * corresponding method), so all the function type checks in
+ * function/traits.hpp see the same function, and the wrapper can be passed to
+ * any optimizer the wrapped function can be passed to.
+ *
+ * @code
+ * RosenbrockFunction f;
+ * InstrumentedFunction<RosenbrockFunction> instrumented(f);
+ *
+ * arma::mat coordinates = f.GetInitialPoint();
+ * L_BFGS optimizer;
+ * optimizer.Optimize(instrumented, coordinates);
+ *
+ * instrumented.Print(std::cout);
+ * @endcode
+ *
+ * The statistics can be recorded from several threads at once.
+ *
+ * @tparam FunctionType Type of the wrapped function.
+ */
+template<typename FunctionType>
+class InstrumentedFunction
+{
+ public:
+  /**
+   * Wrap the given function.  The function is held by reference, so it must
+   * outlive the wrapper.
+   *
+   * @param function Function to wrap.
+   */
+  InstrumentedFunction(FunctionType& function) : function(function) { }
+
+  //! Forward Evaluate() and record the call.
+  template<typename MatType>
+  auto Evaluate(const MatType& coordinates)
+      -> decltype(std::declval<FunctionType&>().Evaluate(coordinates))
+  {
+    const Clock::time_point start = Clock::now();
+    auto objective = function.Evaluate(coordinates);
+    Record(evaluateStats, start, 1);
+    return objective;
+  }
+
+  //! Forward separable Evaluate() and record the call.
+  template<typename MatType>
+  auto Evaluate(const MatType& coordinates,
+                const size_t begin,
+                const size_t batchSize)
+      -> decltype(std::declval<FunctionType&>().Evaluate(coordinates, begin,
+          batchSize))
+  {
+    const Clock::time_point start = Clock::now();
+    auto objective = function.Evaluate(coordinates, begin, batchSize);
+    Record(evaluateStats, start, batchSize);
+    return objective;
+  }
+
+  //! Forward EvaluateDelta() and record the call as an Evaluate() call.
+  template<typename MatType, typename ElemType>
+  auto EvaluateDelta(const MatType& coordinates,
+                     const size_t i,
+                     const ElemType value)
+      -> decltype(std::declval<FunctionType&>().EvaluateDelta(coordinates, i,
+          value))
+  {
+    const Clock::time_point start = Clock::now();
+    auto objective = function.EvaluateDelta(coordinates, i, value);
+    Record(evaluateStats, start, 1);
+    return objective;
+  }
+
+  //! Forward LowerBound().
+  template<typename MatType>
+  auto LowerBound(const MatType& coordinates, const size_t numFixed)
+      -> decltype(std::declval<FunctionType&>().LowerBound(coordinates,
+          numFixed))
+  {
+    return function.LowerBound(coordinates, numFixed);
+  }
+
+  //! Forward Gradient() and record the call.
+  template<typename MatType, typename GradType>
+  auto Gradient(const MatType& coordinates, GradType& gradient)
+      -> decltype(std::declval<FunctionType&>().Gradient(coordinates,
+          gradient))
+  {
+    const Clock::time_point start = Clock::now();
+    function.Gradient(coordinates, gradient);
+    Record(gradientStats, start, 1);
+  }
+
+  //! Forward separable Gradient() and record the call.
+  template<typename MatType, typename GradType>
+  auto Gradient(const MatType& coordinates,
+                const size_t begin,
+                GradType& gradient,
+                const size_t batchSize)
+      -> decltype(std::declval<FunctionType&>().Gradient(coordinates, begin,
+          gradient, batchSize))
+  {
+    const Clock::time_point start = Clock::now();
+    function.Gradient(coordinates, begin, gradient, batchSize);
+    Record(gradientStats, start, batchSize);
+  }
+
+  //! Forward EvaluateWithGradient() and record the call.
+  template<typename MatType, typename GradType>
+  auto EvaluateWithGradient(const MatType& coordinates, GradType& gradient)
+      -> decltype(std::declval<FunctionType&>().EvaluateWithGradient(
+          coordinates, gradient))
+  {
+    const Clock::time_point start = Clock::now();
+    auto objective = function.EvaluateWithGradient(coordinates, gradient);
+    Record(evaluateWithGradientStats, start, 1);
+    return objective;
+  }
+
+  //! Forward separable EvaluateWithGradient() and record the call.
+  template<typename MatType, typename GradType>
+  auto EvaluateWithGradient(const MatType& coordinates,
+                            const size_t begin,
+                            GradType& gradient,
+                            const size_t batchSize)
+      -> decltype(std::declval<FunctionType&>().EvaluateWithGradient(
+          coordinates, begin, gradient, batchSize))
+  {
+    const Clock::time_point start = Clock::now();
+    auto objective = function.EvaluateWithGradient(coordinates, begin,
+        gradient, batchSize);
+    Record(evaluateWithGradientStats, start, batchSize);
+    return objective;
+  }
+
+  //! Forward EvaluateBatch() and record the call.
+  template<typename MatType, typename ValuesType>
+  auto EvaluateBatch(const MatType& candidates, ValuesType& values)
+      -> decltype(std::declval<FunctionType&>().EvaluateBatch(candidates,
+          values))
+  {
+    const Clock::time_point start = Clock::now();
+    function.EvaluateBatch(candidates, values);
+    Record(evaluateBatchStats, start, candidates.n_cols);
+  }
+
+  //! Forward EvaluateConstraint() and record the call.
+  template<typename MatType>
+  auto EvaluateConstraint(const size_t i, const MatType& coordinates)
+      -> decltype(std::declval<FunctionType&>().EvaluateConstraint(i,
+          coordinates))
+  {
+    const Clock::time_point start = Clock::now();
+    auto value = function.EvaluateConstraint(i, coordinates);
+    Record(evaluateConstraintStats, start, 1);
+    return value;
+  }
+
+  //! Forward GradientConstraint() and record the call.
+  template<typename MatType, typename GradType>
+  auto GradientConstraint(const size_t i,
+                          const MatType& coordinates,
+                          GradType& gradient)
+      -> decltype(std::declval<FunctionType&>().GradientConstraint(i,
+          coordinates, gradient))
+  {
+    const Clock::time_point start = Clock::now();
+    function.GradientConstraint(i, coordinates, gradient);
+    Record(gradientConstraintStats, start, 1);
+  }
+
+  //! Forward PartialGradient() and record the call.
+  template<typename MatType, typename GradType>
+  auto PartialGradient(const MatType& coordinates,
+                       const size_t j,
+                       GradType& gradient)
+      -> decltype(std::declval<FunctionType&>().PartialGradient(coordinates, j,
+          gradient))
+  {
+    const Clock::time_point start = Clock::now();
+    function.PartialGradient(coordinates, j, gradient);
+    Record(gradientStats, start, 1);
+  }
+
+  //! Forward Shuffle() and record the call.
+  template<typename F = FunctionType>
+  auto Shuffle() -> decltype(std::declval<F&>().Shuffle())
+  {
+    const Clock::time_point start = Clock::now();
+    function.Shuffle();
+    Record(shuffleStats, start, 1);
+  }
+
+  //! Forward NumFunctions().
+  template<typename F = FunctionType>
+  auto NumFunctions() -> decltype(std::declval<F&>().NumFunctions())
+  {
+    return function.NumFunctions();
+  }
+
+  //! Forward NumConstraints().
+  template<typename F = FunctionType>
+  auto NumConstraints() -> decltype(std::declval<F&>().NumConstraints())
+  {
+    return function.NumConstraints();
+  }
+
+  //! Forward NumFeatures().
+  template<typename F = FunctionType>
+  auto NumFeatures() -> decltype(std::declval<F&>().NumFeatures())
+  {
+    return function.NumFeatures();
+  }
+
+  //! Get the statistics of the Evaluate() calls.
+  const CallStatistics& EvaluateStats() const { return evaluateStats; }
+  //! Get the statistics of the Gradient() and PartialGradient() calls.
+  const CallStatistics& GradientStats() const { return gradientStats; }
+  //! Get the statistics of the EvaluateWithGradient() calls.
+  const CallStatistics& EvaluateWithGradientStats() const
+  { return evaluateWithGradientStats; }
+  //! Get the statistics of the EvaluateBatch() calls.
+  const CallStatistics& EvaluateBatchStats() const
+  { return evaluateBatchStats; }
+  //! Get the statistics of the EvaluateConstraint() calls.
+  const CallStatistics& EvaluateConstraintStats() const
+  { return evaluateConstraintStats; }
+  //! Get the statistics of the GradientConstraint() calls.
+  const CallStatistics& GradientConstraintStats() const
+  { return gradientConstraintStats; }
+  //! Get the statistics of the Shuffle() calls.
+  const CallStatistics& ShuffleStats() const { return shuffleStats; }
+
+  //! Get the total time spent in the wrapped function, in seconds.
+  double TotalTime() const
+  {
+    return evaluateStats.TotalTime() + gradientStats.TotalTime() +
+        evaluateWithGradientStats.TotalTime() +
+        evaluateBatchStats.TotalTime() +
+        evaluateConstraintStats.TotalTime() +
+        gradientConstraintStats.TotalTime() + shuffleStats.TotalTime();
+  }
+
+  //! Forget all recorded calls.
+  void Reset()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    evaluateStats.Reset();
+    gradientStats.Reset();
+    evaluateWithGradientStats.Reset();
+    evaluateBatchStats.Reset();
+    evaluateConstraintStats.Reset();
+    gradientConstraintStats.Reset();
+    shuffleStats.Reset();
+  }
+
+  /**
+   * Print a table with the statistics of every method that was called.  Times
+   * are given in microseconds.
+   *
+   * @param stream Stream to print to.
+   */
+  void Print(std::ostream& stream) const
+  {
+    stream << std::left << std::setw(22) << "method" << std::right
+        << std::setw(10) << "calls" << std::setw(12) << "mean batch"
+        << std::setw(14) << "total (s)" << std::setw(12) << "mean (us)"
+        << std::setw(12) << "p50 (us)" << std::setw(12) << "p99 (us)"
+        << std::endl;
+    PrintRow(stream, "Evaluate", evaluateStats);
+    PrintRow(stream, "Gradient", gradientStats);
+    PrintRow(stream, "EvaluateWithGradient", evaluateWithGradientStats);
+    PrintRow(stream, "EvaluateBatch", evaluateBatchStats);
+    PrintRow(stream, "EvaluateConstraint", evaluateConstraintStats);
+    PrintRow(stream, "GradientConstraint", gradientConstraintStats);
+    PrintRow(stream, "Shuffle", shuffleStats);
+  }
+
+  //! Get the wrapped function.
+  const FunctionType& Wrapped() const { return function; }
+  //! Modify the wrapped function.
+  FunctionType& Wrapped() { return function; }
+
+ private:
+  //! The clock used to time the calls.
+  typedef std::chrono::steady_clock Clock;
+
+  //! Record a call that started at the given time.
+  void Record(CallStatistics& stats,
+              const Clock::time_point start,
+              const size_t batchSize)
+  {
+    const double seconds = std::chrono::duration<double>(
+        Clock::now() - start).count();
+    std::lock_guard<std::mutex> lock(mutex);
+    stats.Record(seconds, batchSize);
+  }
+
+  //! Print the statistics of a method, if it was called.
+  static void PrintRow(std::ostream& stream,
+                       const char* name,
+                       const CallStatistics& stats)
+  {
+    if (stats.Calls() == 0)
+      return;
+
+    stream << std::left << std::setw(22) << name << std::right
+        << std::setw(10) << stats.Calls()
+        << std::setw(12) << std::setprecision(4) << stats.MeanBatchSize()
+        << std::setw(14) << std::setprecision(6) << stats.TotalTime()
+        << std::setw(12) << std::setprecision(4) << stats.MeanTime() * 1e6
+        << std::setw(12) << stats.Percentile(0.5) * 1e6
+        << std::setw(12) << stats.Percentile(0.99) * 1e6 << std::endl;
+  }
+
+  //! The wrapped function.
+  FunctionType& function;
+  //! Statistics of the Evaluate() calls.
+  CallStatistics evaluateStats;
+  //! Statistics of the Gradient() and PartialGradient() calls.
+  CallStatistics gradientStats;
+  //! Statistics of the EvaluateWithGradient() calls.
+  CallStatistics evaluateWithGradientStats;
+  //! Statistics of the EvaluateBatch() calls.
+  CallStatistics evaluateBatchStats;
+  //! Statistics of the EvaluateConstraint() calls.
+  CallStatistics evaluateConstraintStats;
+  //! Statistics of the GradientConstraint() calls.
+  CallStatistics gradientConstraintStats;
+  //! Statistics of the Shuffle() calls.
+  CallStatistics shuffleStats;
+  //! Protects the statistics.
+  std::mutex mutex;
+};
+
+} // namespace ens
+
+#endif
@@ -0,0 +1,328 @@
+/**
+ * @file memoized_function.hpp
+ *
+ * A wrapper that caches the objective and gradient of recently evaluated
+ * coordinates.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_FUNCTION_MEMOIZED_FUNCTION_HPP
+#define ENSMALLEN_FUNCTION_MEMOIZED_FUNCTION_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace ens {
+
+/**
+ * MemoizedFunction wraps a function and remembers the objective and the
+ * gradient of the most recently used coordinates, so that evaluating the same
+ * coordinates again does not call the wrapped function.  This pays off for
+ * expensive objectives when an optimizer revisits points (e.g. population-based
+ * optimizers or grid searches), or calls Evaluate() and EvaluateWithGradient()
+ * on the same coordinates.
+ *
+ * Coordinates are looked up by a hash of their elements and compared
+ * element-wise, so only bitwise identical coordinates match.  At most
+ * `capacity` coordinates are kept; when the cache is full the least recently
+ * used entry is evicted.  All methods can be called from several threads at
+ * once (as long as the wrapped function can); the wrapped function is never
+ * called while the cache is locked.
+ *
+ * The wrapper provides Evaluate(), Gradient() and EvaluateWithGradient() for
+ * the given MatType and GradType, deriving the ones the wrapped function does
+ * not implement in the same way as the optimizers do.  Separable functions are
+ * not supported, since their results depend on the batch.
+ *
+ * @code
+ * RosenbrockFunction f;
+ * MemoizedFunction<RosenbrockFunction> memoized(f);
+ *
+ * arma::mat coordinates = f.GetInitialPoint();
+ * DE optimizer;
+ * optimizer.Optimize(memoized, coordinates);
+ * @endcode
+ *
+ * @tparam FunctionType Type of the wrapped function.
+ * @tparam MatType Type of the coordinates.
+ * @tparam GradType Type of the gradient.
+ */
+template<typename FunctionType,
+         typename MatType = arma::mat,
+         typename GradType = MatType>
+class MemoizedFunction
+{
+ public:
+  //! The type of the objective.
+  typedef typename MatType::elem_type ElemType;
+
+  /**
+   * Wrap the given function.  The function is held by reference, so it must
+   * outlive the wrapper.
+   *
+   * @param function Function to wrap.
+   * @param capacity Maximum number of coordinates to remember.
+   */
+  MemoizedFunction(FunctionType& function, const size_t capacity = 1024) :
+      function(function),
+      capacity(capacity),
+      hits(0),
+      misses(0)
+  {
+    // Nothing to do.
+  }
+
+  /**
+   * Return the objective of the given coordinates, from the cache if possible.
+   *
+   * @param coordinates Coordinates to evaluate.
+   */
+  ElemType Evaluate(const MatType& coordinates)
+  {
+    const uint64_t hash = Hash(coordinates);
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      Entry* entry = Find(hash, coordinates);
+      if (entry != NULL && entry->hasObjective)
+      {
+        ++hits;
+        return entry->objective;
+      }
+      ++misses;
+    }
+
+    const ElemType objective = Full().Evaluate(coordinates);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    Entry& entry = Insert(hash, coordinates);
+    entry.objective = objective;
+    entry.hasObjective = true;
+    return objective;
+  }
+
+  /**
+   * Store the gradient of the given coordinates, from the cache if possible.
+   *
+   * @param coordinates Coordinates to evaluate the gradient at.
+   * @param gradient Matrix to store the gradient in.
+   */
+  void Gradient(const MatType& coordinates, GradType& gradient)
+  {
+    const uint64_t hash = Hash(coordinates);
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      Entry* entry = Find(hash, coordinates);
+      if (entry != NULL && entry->hasGradient)
+      {
+        ++hits;
+        gradient = entry->gradient;
+        return;
+      }
+      ++misses;
+    }
+
+    Full().Gradient(coordinates, gradient);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    Entry& entry = Insert(hash, coordinates);
+    entry.gradient = gradient;
+    entry.hasGradient = true;
+  }
+
+  /**
+   * Return the objective and store the gradient of the given coordinates,
+   * from the cache if possible.
+   *
+   * @param coordinates Coordinates to evaluate.
+   * @param gradient Matrix to store the gradient in.
+   */
+  ElemType EvaluateWithGradient(const MatType& coordinates, GradType& gradient)
+  {
+    const uint64_t hash = Hash(coordinates);
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      Entry* entry = Find(hash, coordinates);
+      if (entry != NULL && entry->hasObjective && entry->hasGradient)
+      {
+        ++hits;
+        gradient = entry->gradient;
+        return entry->objective;
+      }
+      ++misses;
+    }
+
+    const ElemType objective = Full().EvaluateWithGradient(coordinates,
+        gradient);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    Entry& entry = Insert(hash, coordinates);
+    entry.objective = objective;
+    entry.hasObjective = true;
+    entry.gradient = gradient;
+    entry.hasGradient = true;
+    return objective;
+  }
+
+  //! Forget all remembered coordinates.
+  void Clear()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    index.clear();
+  }
+
+  //! Get the number of calls answered from the cache.
+  size_t Hits() const { return hits.load(); }
+  //! Get the number of calls forwarded to the wrapped function.
+  size_t Misses() const { return misses.load(); }
+  //! Get the number of remembered coordinates.
+  size_t Size() const
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+  }
+
+  //! Get the maximum number of remembered coordinates.
+  size_t Capacity() const { return capacity; }
+  //! Modify the maximum number of remembered coordinates (this takes effect
+  //! on the next insertion).
+  size_t& Capacity() { return capacity; }
+
+  //! Get the wrapped function.
+  const FunctionType& Wrapped() const { return function; }
+  //! Modify the wrapped function.  Call Clear() if this changes its results.
+  FunctionType& Wrapped() { return function; }
+
+ private:
+  //! A remembered point.
+  struct Entry
+  {
+    Entry(const uint64_t hash, const MatType& coordinates) :
+        hash(hash),
+        coordinates(coordinates),
+        objective(0),
+        hasObjective(false),
+        hasGradient(false)
+    { }
+
+    //! The hash of the coordinates.
+    uint64_t hash;
+    //! The coordinates.
+    MatType coordinates;
+    //! The objective, if hasObjective is true.
+    ElemType objective;
+    //! The gradient, if hasGradient is true.
+    GradType gradient;
+    //! Whether the objective is known.
+    bool hasObjective;
+    //! Whether the gradient is known.
+    bool hasGradient;
+  };
+
+  //! Entries, from the most to the least recently used.
+  typedef std::list<Entry> EntryList;
+
+  //! The wrapped function with all the methods it can provide.
+  Function<FunctionType, MatType, GradType>& Full()
+  {
+    return static_cast<Function<FunctionType, MatType, GradType>&>(function);
+  }
+
+  //! Hash the size and the elements of the given coordinates.
+  static uint64_t Hash(const MatType& coordinates)
+  {
+    uint64_t hash = CounterRNG::Mix(coordinates.n_rows ^
+        ((uint64_t) coordinates.n_cols << 32));
+    const unsigned char* bytes =
+        reinterpret_cast<const unsigned char*>(coordinates.memptr());
+    const size_t numBytes = coordinates.n_elem * sizeof(ElemType);
+
+    // FNV-1a over 64-bit words.
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= numBytes; i += sizeof(uint64_t))
+    {
+      uint64_t word;
+      std::memcpy(&word, bytes + i, sizeof(uint64_t));
+      hash = (hash ^ word) * 0x100000001B3ULL;
+    }
+    for (; i < numBytes; ++i)
+      hash = (hash ^ bytes[i]) * 0x100000001B3ULL;
+
+    return CounterRNG::Mix(hash);
+  }
+
+  //! Return the entry of the given coordinates (and mark it as the most
+  //! recently used), or NULL.  The mutex must be held.
+  Entry* Find(const uint64_t hash, const MatType& coordinates)
+  {
+    typename std::unordered_map<uint64_t,
+        typename EntryList::iterator>::iterator it = index.find(hash);
+    if (it == index.end() || !Equal(it->second->coordinates, coordinates))
+      return NULL;
+
+    entries.splice(entries.begin(), entries, it->second);
+    return &entries.front();
+  }
+
+  //! Return the entry of the given coordinates, creating it if needed.  The
+  //! mutex must be held.
+  Entry& Insert(const uint64_t hash, const MatType& coordinates)
+  {
+    Entry* entry = Find(hash, coordinates);
+    if (entry != NULL)
+      return *entry;
+
+    // Coordinates with the same hash are replaced.
+    typename std::unordered_map<uint64_t,
+        typename EntryList::iterator>::iterator it = index.find(hash);
+    if (it != index.end())
+    {
+      entries.erase(it->second);
+      index.erase(it);
+    }
+
+    while (!entries.empty() && entries.size() >= std::max(capacity,
+        (size_t) 1))
+    {
+      index.erase(entries.back().hash);
+      entries.pop_back();
+    }
+
+    entries.push_front(Entry(hash, coordinates));
+    index[hash] = entries.begin();
+    return entries.front();
+  }
+
+  //! Return whether the given coordinates are bitwise identical.
+  static bool Equal(const MatType& a, const MatType& b)
+  {
+    return a.n_rows == b.n_rows && a.n_cols == b.n_cols &&
+        std::memcmp(a.memptr(), b.memptr(), a.n_elem * sizeof(ElemType)) == 0;
+  }
+
+  //! The wrapped function.
+  FunctionType& function;
+  //! The maximum number of remembered coordinates.
+  size_t capacity;
+  //! The remembered coordinates, from the most to the least recently used.
+  EntryList entries;
+  //! The position of the entry of every hash in the list.
+  std::unordered_map<uint64_t, typename EntryList::iterator> index;
+  //! Protects the cache.
+  mutable std::mutex mutex;
+  //! The number of calls answered from the cache.
+  std::atomic<size_t> hits;
+  //! The number of calls forwarded to the wrapped function.
+  std::atomic<size_t> misses;
+};
+
+} // namespace ens
+
+#endif
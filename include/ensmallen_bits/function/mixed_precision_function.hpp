@@ -0,0 +1,262 @@
+/**
+ * @file mixed_precision_function.hpp
+ *
+ * A wrapper that evaluates a function with a lower-precision copy of the
+ * coordinates.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_FUNCTION_MIXED_PRECISION_FUNCTION_HPP
+#define ENSMALLEN_FUNCTION_MIXED_PRECISION_FUNCTION_HPP
+
+#include <memory>
+#include <mutex>
+
+namespace ens {
+
+/**
+ * MixedPrecisionFunction wraps a function that is evaluated in a lower
+ * precision (by default, with arma::fmat) so that it can be optimized with
+ * coordinates of a higher precision (e.g. arma::mat).  The optimizer then
+ * keeps the master coordinates and all of its state (such as the moments of
+ * Adam) in the higher precision, so small updates still accumulate, while the
+ * wrapped function only ever sees the low-precision copy.
+ *
+ * Every call converts the coordinates into a low-precision buffer, calls the
+ * wrapped function with it, and converts the gradient back.  The buffers are
+ * reused between calls, so after the first step no memory is allocated; calls
+ * from several threads at once (as SGD makes when it shards batches) get
+ * separate buffers.
+ *
+ * @code
+ * // The function is implemented for arma::fmat; SGD and Adam work in double.
+ * LogisticRegressionFunction<arma::fmat> lr(data, responses);
+ * MixedPrecisionFunction<LogisticRegressionFunction<arma::fmat>> f(lr);
+ *
+ * arma::mat coordinates = arma::conv_to<arma::mat>::from(
+ *     lr.GetInitialPoint());
+ * Adam optimizer;
+ * optimizer.Optimize(f, coordinates);
+ * @endcode
+ *
+ * The wrapper has the Evaluate(), Gradient() and EvaluateWithGradient()
+ * methods (both the non-separable and the separable forms) that the wrapped
+ * function has for LowMatType, as well as Shuffle() and NumFunctions().  The
+ * coordinates and the gradient must be dense matrices.
+ *
+ * @tparam FunctionType Type of the wrapped function.
+ * @tparam LowMatType Type of the coordinates and the gradient the wrapped
+ *     function is called with.
+ */
+template<typename FunctionType, typename LowMatType = arma::fmat>
+class MixedPrecisionFunction
+{
+ public:
+  /**
+   * Wrap the given function.  The function is held by reference, so it must
+   * outlive the wrapper.
+   *
+   * @param function Function to wrap.
+   */
+  MixedPrecisionFunction(FunctionType& function) :
+      function(function),
+      buffers(0)
+  {
+    // Nothing to do.
+  }
+
+  //! Evaluate the function with a low-precision copy of the coordinates.
+  template<typename MatType, typename F = FunctionType>
+  auto Evaluate(const MatType& coordinates)
+      -> decltype((typename MatType::elem_type)
+          std::declval<F&>().Evaluate(std::declval<const LowMatType&>()))
+  {
+    Lease lease(*this);
+    Convert(coordinates, lease->coordinates);
+    return (typename MatType::elem_type) function.Evaluate(
+        lease->coordinates);
+  }
+
+  //! Evaluate the given batch of separable functions with a low-precision
+  //! copy of the coordinates.
+  template<typename MatType, typename F = FunctionType>
+  auto Evaluate(const MatType& coordinates,
+                const size_t begin,
+                const size_t batchSize)
+      -> decltype((typename MatType::elem_type)
+          std::declval<F&>().Evaluate(std::declval<const LowMatType&>(), begin,
+          batchSize))
+  {
+    Lease lease(*this);
+    Convert(coordinates, lease->coordinates);
+    return (typename MatType::elem_type) function.Evaluate(
+        lease->coordinates, begin, batchSize);
+  }
+
+  //! Compute the gradient with a low-precision copy of the coordinates.
+  template<typename MatType, typename GradType, typename F = FunctionType>
+  auto Gradient(const MatType& coordinates, GradType& gradient)
+      -> decltype(std::declval<F&>().Gradient(
+          std::declval<const LowMatType&>(), std::declval<LowMatType&>()))
+  {
+    Lease lease(*this);
+    Convert(coordinates, lease->coordinates);
+    function.Gradient(lease->coordinates, lease->gradient);
+    Convert(lease->gradient, gradient);
+  }
+
+  //! Compute the gradient of the given batch of separable functions with a
+  //! low-precision copy of the coordinates.
+  template<typename MatType, typename GradType, typename F = FunctionType>
+  auto Gradient(const MatType& coordinates,
+                const size_t begin,
+                GradType& gradient,
+                const size_t batchSize)
+      -> decltype(std::declval<F&>().Gradient(
+          std::declval<const LowMatType&>(), begin,
+          std::declval<LowMatType&>(), batchSize))
+  {
+    Lease lease(*this);
+    Convert(coordinates, lease->coordinates);
+    function.Gradient(lease->coordinates, begin, lease->gradient, batchSize);
+    Convert(lease->gradient, gradient);
+  }
+
+  //! Evaluate the function and compute the gradient with a low-precision copy
+  //! of the coordinates.
+  template<typename MatType, typename GradType, typename F = FunctionType>
+  auto EvaluateWithGradient(const MatType& coordinates, GradType& gradient)
+      -> decltype((typename MatType::elem_type)
+          std::declval<F&>().EvaluateWithGradient(
+          std::declval<const LowMatType&>(), std::declval<LowMatType&>()))
+  {
+    Lease lease(*this);
+    Convert(coordinates, lease->coordinates);
+    const typename MatType::elem_type objective =
+        function.EvaluateWithGradient(lease->coordinates, lease->gradient);
+    Convert(lease->gradient, gradient);
+    return objective;
+  }
+
+  //! Evaluate the given batch of separable functions and compute its gradient
+  //! with a low-precision copy of the coordinates.
+  template<typename MatType, typename GradType, typename F = FunctionType>
+  auto EvaluateWithGradient(const MatType& coordinates,
+                            const size_t begin,
+                            GradType& gradient,
+                            const size_t batchSize)
+      -> decltype((typename MatType::elem_type)
+          std::declval<F&>().EvaluateWithGradient(
+          std::declval<const LowMatType&>(), begin,
+          std::declval<LowMatType&>(), batchSize))
+  {
+    Lease lease(*this);
+    Convert(coordinates, lease->coordinates);
+    const typename MatType::elem_type objective =
+        function.EvaluateWithGradient(lease->coordinates, begin,
+        lease->gradient, batchSize);
+    Convert(lease->gradient, gradient);
+    return objective;
+  }
+
+  //! Forward Shuffle().
+  template<typename F = FunctionType>
+  auto Shuffle() -> decltype(std::declval<F&>().Shuffle())
+  {
+    function.Shuffle();
+  }
+
+  //! Forward NumFunctions().
+  template<typename F = FunctionType>
+  auto NumFunctions() -> decltype(std::declval<F&>().NumFunctions())
+  {
+    return function.NumFunctions();
+  }
+
+  //! Get the number of low-precision buffers created so far (one per
+  //! concurrent call).
+  size_t Buffers() const { return buffers; }
+
+  //! Get the wrapped function.
+  const FunctionType& Wrapped() const { return function; }
+  //! Modify the wrapped function.
+  FunctionType& Wrapped() { return function; }
+
+ private:
+  //! The low-precision copies used by one call.
+  struct Workspace
+  {
+    //! The coordinates passed to the wrapped function.
+    LowMatType coordinates;
+    //! The gradient computed by the wrapped function.
+    LowMatType gradient;
+  };
+
+  //! Takes a workspace from the pool (creating one if all are in use) and
+  //! returns it when it goes out of scope.
+  class Lease
+  {
+   public:
+    Lease(MixedPrecisionFunction& parent) : parent(parent)
+    {
+      std::lock_guard<std::mutex> lock(parent.mutex);
+      if (parent.pool.empty())
+      {
+        workspace.reset(new Workspace());
+        ++parent.buffers;
+      }
+      else
+      {
+        workspace = std::move(parent.pool.back());
+        parent.pool.pop_back();
+      }
+    }
+
+    ~Lease()
+    {
+      std::lock_guard<std::mutex> lock(parent.mutex);
+      parent.pool.push_back(std::move(workspace));
+    }
+
+    Workspace* operator->() { return workspace.get(); }
+
+   private:
+    //! The wrapper that owns the pool.
+    MixedPrecisionFunction& parent;
+    //! The leased workspace.
+    std::unique_ptr<Workspace> workspace;
+  };
+
+  //! Copy the given dense matrix into out, converting every element.  The
+  //! memory of out is reused if it already has the right size.
+  template<typename InType, typename OutType>
+  static void Convert(const InType& in, OutType& out)
+  {
+    typedef typename OutType::elem_type OutElemType;
+
+    out.set_size(in.n_rows, in.n_cols);
+    const typename InType::elem_type* inMem = in.memptr();
+    OutElemType* outMem = out.memptr();
+    const size_t n = in.n_elem;
+
+    ENS_PRAGMA_OMP_SIMD
+    for (size_t i = 0; i < n; ++i)
+      outMem[i] = (OutElemType) inMem[i];
+  }
+
+  //! The wrapped function.
+  FunctionType& function;
+  //! The workspaces not in use.
+  std::vector<std::unique_ptr<Workspace>> pool;
+  //! The number of workspaces created.
+  size_t buffers;
+  //! Protects the pool.
+  std::mutex mutex;
+};
+
+} // namespace ens
+
+#endif
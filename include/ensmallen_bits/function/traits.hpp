@@ -47,6 +47,12 @@ ENS_HAS_EXACT_METHOD_FORM(ResetPolicy, HasResetPolicy)
 ENS_HAS_EXACT_METHOD_FORM(BatchSize, HasBatchSize)
 //! Detect an StepSize() method.
 ENS_HAS_EXACT_METHOD_FORM(StepSize, HasStepSize)
+//! Detect an EvaluateBatch() method.
+ENS_HAS_EXACT_METHOD_FORM(EvaluateBatch, HasEvaluateBatch)
+//! Detect a LowerBound() method.
+ENS_HAS_EXACT_METHOD_FORM(LowerBound, HasLowerBound)
+//! Detect an EvaluateDelta() method.
+ENS_HAS_EXACT_METHOD_FORM(EvaluateDelta, HasEvaluateDelta)
 
 template<typename MatType, typename GradType>
 struct TypedForms
@@ -275,6 +281,52 @@ struct TypedForms
   using PartialGradientStaticForm = void(*)(
       const BaseMatType&, const size_t, BaseGradType&);
 
+  //! This is the form of a non-const EvaluateBatch() method.
+  template<typename FunctionType>
+  using EvaluateBatchForm = void(FunctionType::*)(
+      const BaseMatType&, arma::Row<typename BaseMatType::elem_type>&);
+
+  //! This is the form of a const EvaluateBatch() method.
+  template<typename FunctionType>
+  using EvaluateBatchConstForm = void(FunctionType::*)(
+      const BaseMatType&, arma::Row<typename BaseMatType::elem_type>&) const;
+
+  //! This is the form of a static EvaluateBatch() method.
+  template<typename FunctionType>
+  using EvaluateBatchStaticForm = void(*)(
+      const BaseMatType&, arma::Row<typename BaseMatType::elem_type>&);
+
+  //! This is the form of a non-const LowerBound() method.
+  template<typename FunctionType>
+  using LowerBoundForm = typename BaseMatType::elem_type(FunctionType::*)(
+      const BaseMatType&, const size_t);
+
+  //! This is the form of a const LowerBound() method.
+  template<typename FunctionType>
+  using LowerBoundConstForm = typename BaseMatType::elem_type(FunctionType::*)(
+      const BaseMatType&, const size_t) const;
+
+  //! This is the form of a static LowerBound() method.
+  template<typename FunctionType>
+  using LowerBoundStaticForm = typename BaseMatType::elem_type(*)(
+      const BaseMatType&, const size_t);
+
+  //! This is the form of a non-const EvaluateDelta() method.
+  template<typename FunctionType>
+  using EvaluateDeltaForm = typename BaseMatType::elem_type(FunctionType::*)(
+      const BaseMatType&, const size_t, const typename BaseMatType::elem_type);
+
+  //! This is the form of a const EvaluateDelta() method.
+  template<typename FunctionType>
+  using EvaluateDeltaConstForm =
+      typename BaseMatType::elem_type(FunctionType::*)(const BaseMatType&,
+      const size_t, const typename BaseMatType::elem_type) const;
+
+  //! This is the form of a static EvaluateDelta() method.
+  template<typename FunctionType>
+  using EvaluateDeltaStaticForm = typename BaseMatType::elem_type(*)(
+      const BaseMatType&, const size_t, const typename BaseMatType::elem_type);
+
   //! This is a utility struct that will match any non-const form.
   template<typename FunctionType, typename... Ts>
   using OtherForm = typename BaseMatType::elem_type(FunctionType::*)(Ts...);
@@ -447,6 +499,49 @@ struct HasResetPolicySignature
       HasResetPolicy<OptimizerType, HasResetPolicyForm>::value;
 };
 
+//! Utility struct, check if a non-const, const or static EvaluateBatch()
+//! method that evaluates every column of a matrix of type MatType exists.
+template<typename FunctionType, typename MatType>
+struct HasEvaluateBatchSignature
+{
+  const static bool value =
+      HasEvaluateBatch<FunctionType, TypedForms<MatType, MatType>::template
+          EvaluateBatchForm>::value ||
+      HasEvaluateBatch<FunctionType, TypedForms<MatType, MatType>::template
+          EvaluateBatchConstForm>::value ||
+      HasEvaluateBatch<FunctionType, TypedForms<MatType, MatType>::template
+          EvaluateBatchStaticForm>::value;
+};
+
+//! Utility struct, check if a non-const, const or static LowerBound() method
+//! that bounds the objective of a block of grid points exists.
+template<typename FunctionType, typename MatType>
+struct HasLowerBoundSignature
+{
+  const static bool value =
+      HasLowerBound<FunctionType, TypedForms<MatType, MatType>::template
+          LowerBoundForm>::value ||
+      HasLowerBound<FunctionType, TypedForms<MatType, MatType>::template
+          LowerBoundConstForm>::value ||
+      HasLowerBound<FunctionType, TypedForms<MatType, MatType>::template
+          LowerBoundStaticForm>::value;
+};
+
+//! Utility struct, check if a non-const, const or static EvaluateDelta()
+//! method that gives the change of the objective of a single-coordinate move
+//! exists.
+template<typename FunctionType, typename MatType>
+struct HasEvaluateDeltaSignature
+{
+  const static bool value =
+      HasEvaluateDelta<FunctionType, TypedForms<MatType, MatType>::template
+          EvaluateDeltaForm>::value ||
+      HasEvaluateDelta<FunctionType, TypedForms<MatType, MatType>::template
+          EvaluateDeltaConstForm>::value ||
+      HasEvaluateDelta<FunctionType, TypedForms<MatType, MatType>::template
+          EvaluateDeltaStaticForm>::value;
+};
+
 } // namespace traits
 } // namespace ens
 
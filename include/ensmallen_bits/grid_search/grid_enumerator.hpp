@@ -0,0 +1,123 @@
+/**
+ * @file grid_enumerator.hpp
+ *
+ * Lazy enumeration of the points of a multidimensional categorical grid.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_GRID_SEARCH_GRID_ENUMERATOR_HPP
+#define ENSMALLEN_GRID_SEARCH_GRID_ENUMERATOR_HPP
+
+namespace ens {
+
+/**
+ * GridEnumerator numbers the points of a grid with numCategories(i) values in
+ * dimension i as a mixed-radix counter: the first dimension is the most
+ * significant digit and the last dimension varies fastest.  No point is ever
+ * stored; Point() decodes any index in constant memory and Increment() steps
+ * from one point to the next, so the grid can be split into contiguous ranges
+ * of indices and enumerated by several threads independently.
+ *
+ * All the points whose first k coordinates are fixed form a contiguous block
+ * of Stride(k) indices, which makes it possible to skip whole sub-grids at
+ * once.
+ */
+class GridEnumerator
+{
+ public:
+  /**
+   * Create the enumerator of the grid with the given number of categories in
+   * each dimension.
+   *
+   * @param numCategories Number of categories in each dimension.
+   */
+  GridEnumerator(const arma::Row<size_t>& numCategories) :
+      numCategories(numCategories),
+      strides(numCategories.n_elem + 1)
+  {
+    strides[numCategories.n_elem] = 1;
+    for (size_t i = numCategories.n_elem; i > 0; --i)
+    {
+      if (numCategories[i - 1] != 0 && strides[i] >
+          std::numeric_limits<size_t>::max() / numCategories[i - 1])
+      {
+        throw std::invalid_argument("GridEnumerator::GridEnumerator(): the grid"
+            " has too many points to be enumerated");
+      }
+
+      strides[i - 1] = strides[i] * numCategories[i - 1];
+    }
+  }
+
+  //! Get the number of dimensions of the grid.
+  size_t Dimensions() const { return numCategories.n_elem; }
+
+  //! Get the number of points of the grid.
+  size_t Size() const { return strides[0]; }
+
+  //! Get the number of points that share their first numFixed coordinates.
+  size_t Stride(const size_t numFixed) const { return strides[numFixed]; }
+
+  /**
+   * Store the point with the given index in the first Dimensions() elements
+   * of the given matrix.
+   *
+   * @param index Index of the point; must be less than Size().
+   * @param point Matrix to store the coordinates in.
+   */
+  template<typename MatType>
+  void Point(size_t index, MatType& point) const
+  {
+    typedef typename MatType::elem_type ElemType;
+
+    for (size_t i = numCategories.n_elem; i > 0; --i)
+    {
+      point[i - 1] = (ElemType) (index % numCategories[i - 1]);
+      index /= numCategories[i - 1];
+    }
+  }
+
+  /**
+   * Step the given point forward by Stride(dimension + 1) indices: the
+   * coordinate in the given dimension is incremented with carry towards the
+   * first dimension and all the following coordinates are reset to 0.  With
+   * dimension = Dimensions() - 1 this moves to the next point of the grid.
+   *
+   * @param point Point to advance.
+   * @param dimension Dimension to increment.
+   * @return false if the point moved past the end of the grid (it is then
+   *     reset to the first point), true otherwise.
+   */
+  template<typename MatType>
+  bool Increment(MatType& point, const size_t dimension) const
+  {
+    typedef typename MatType::elem_type ElemType;
+
+    for (size_t i = dimension + 1; i < numCategories.n_elem; ++i)
+      point[i] = ElemType(0);
+
+    for (size_t i = dimension + 1; i > 0; --i)
+    {
+      point[i - 1] += ElemType(1);
+      if ((size_t) point[i - 1] < numCategories[i - 1])
+        return true;
+
+      point[i - 1] = ElemType(0);
+    }
+
+    return false;
+  }
+
+ private:
+  //! The number of categories in each dimension.
+  arma::Row<size_t> numCategories;
+  //! strides[k] is the number of points that share their first k coordinates.
+  std::vector<size_t> strides;
+};
+
+} // namespace ens
+
+#endif
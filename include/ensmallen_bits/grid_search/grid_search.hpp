@@ -12,12 +12,32 @@
 #ifndef ENSMALLEN_GRID_SEARCH_GRID_SEARCH_HPP
 #define ENSMALLEN_GRID_SEARCH_GRID_SEARCH_HPP
 
+#include "grid_enumerator.hpp"
+
 namespace ens {
 
 /**
  * An optimizer that finds the minimum of a given function by iterating through
  * points on a multidimensional grid.
  *
+ * The points are enumerated lazily with a GridEnumerator, so the grid is never
+ * stored, and the grid is split into blocks of points that share their leading
+ * coordinates.  The blocks are searched concurrently when numThreads is not 1;
+ * the points along the last dimension are evaluated together with
+ * EvaluateBatch().
+ *
+ * If the function has a method
+ *
+ * @code
+ * double LowerBound(const arma::mat& coordinates, const size_t numFixed);
+ * @endcode
+ *
+ * that returns a lower bound on the objective of every grid point whose first
+ * numFixed coordinates are equal to those of `coordinates` (the remaining
+ * coordinates are unspecified), every sub-grid whose bound is greater than the
+ * best objective found so far is skipped without being evaluated.  The result
+ * is the same as without pruning as long as the bounds are valid.
+ *
  * GridSearch can optimize categorical functions.  For more details, see the
  * documentation on function types included with this distribution or on the
  * ensmallen website.
@@ -25,6 +45,15 @@ namespace ens {
 class GridSearch
 {
  public:
+  /**
+   * Construct the GridSearch optimizer.
+   *
+   * @param numThreads Number of threads used to search the grid (0 means all
+   *     available).  Values other than 1 require the function's Evaluate()
+   *     (and LowerBound(), if any) to be thread-safe.
+   */
+  GridSearch(const size_t numThreads = 1) : numThreads(numThreads) { }
+
   /**
    * Optimize (minimize) the given function by iterating through the all
    * possible combinations of values for the parameters specified in
@@ -46,23 +75,38 @@ class GridSearch
       const std::vector<bool>& categoricalDimensions,
       const arma::Row<size_t>& numCategories);
 
+  //! Get the number of threads used to search the grid.
+  size_t NumThreads() const { return numThreads; }
+  //! Modify the number of threads used to search the grid.
+  size_t& NumThreads() { return numThreads; }
+
  private:
-  /**
-   * Iterate through the last (parameterValueCollections.size() - i) dimensions
-   * of the grid and change the arguments bestObjective and bestParameters if
-   * there is something better. The values for the first i dimensions
-   * (parameters) are specified in the first i rows of the currentParameters
-   * argument.
-   */
-  template<typename FunctionType, typename MatType>
-  void Optimize(
-      FunctionType& function,
-      typename MatType::elem_type& bestObjective,
-      MatType& bestParameters,
-      MatType& currentParameters,
-      const std::vector<bool>& categoricalDimensions,
-      const arma::Row<size_t>& numCategories,
-      size_t i);
+  //! Return a lower bound on the objective of the sub-grid whose first
+  //! numFixed coordinates are given, using the LowerBound() method of the
+  //! function.
+  template<typename FunctionType, typename ElemType>
+  static typename std::enable_if<traits::HasLowerBoundSignature<
+      FunctionType, arma::Mat<ElemType>>::value, ElemType>::type
+  LowerBound(FunctionType& function,
+             const arma::Mat<ElemType>& coordinates,
+             const size_t numFixed)
+  {
+    return function.LowerBound(coordinates, numFixed);
+  }
+
+  //! Without a LowerBound() method, no sub-grid can be pruned.
+  template<typename FunctionType, typename ElemType>
+  static typename std::enable_if<!traits::HasLowerBoundSignature<
+      FunctionType, arma::Mat<ElemType>>::value, ElemType>::type
+  LowerBound(FunctionType& /* function */,
+             const arma::Mat<ElemType>& /* coordinates */,
+             const size_t /* numFixed */)
+  {
+    return std::numeric_limits<ElemType>::lowest();
+  }
+
+  //! The number of threads used to search the grid.
+  size_t numThreads;
 };
 
 } // namespace ens
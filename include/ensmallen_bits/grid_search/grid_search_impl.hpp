@@ -12,6 +12,7 @@
 #ifndef ENSMALLEN_GRID_SEARCH_GRID_SEARCH_IMPL_HPP
 #define ENSMALLEN_GRID_SEARCH_GRID_SEARCH_IMPL_HPP
 
+#include <atomic>
 #include <limits>
 #include <ensmallen_bits/function.hpp>
 
@@ -37,59 +38,145 @@ typename MatType::elem_type GridSearch::Optimize(
 
   // Convenience typedefs.
   typedef typename MatType::elem_type ElemType;
+  typedef typename MatTypeTraits<MatType>::BaseMatType BaseMatType;
+
+  // Make sure we have the methods that we need.  No restrictions on the matrix
+  // type are needed.
+  traits::CheckArbitraryFunctionTypeAPI<FunctionType, BaseMatType>();
 
+  const size_t dimensions = categoricalDimensions.size();
   ElemType bestObjective = std::numeric_limits<ElemType>::max();
-  bestParameters.set_size(categoricalDimensions.size(), 1);
-  MatType currentParameters(categoricalDimensions.size(), 1);
 
   /* Initialize best parameters for the case (very unlikely though) when no set
    * of parameters gives an objective value better than
    * std::numeric_limits<double>::max() */
-  for (size_t i = 0; i < categoricalDimensions.size(); ++i)
-    bestParameters(i, 0) = 0;
+  bestParameters.zeros(dimensions, 1);
 
-  Optimize(function, bestObjective, bestParameters, currentParameters,
-      categoricalDimensions, numCategories, 0);
+  if (dimensions == 0)
+  {
+    // There is only one (empty) point to evaluate.
+    const ElemType objective = function.Evaluate((BaseMatType&) bestParameters);
+    return std::min(objective, bestObjective);
+  }
 
-  return bestObjective;
-}
+  const GridEnumerator grid(numCategories.head(dimensions));
+  if (grid.Size() == 0)
+    return bestObjective;
 
-template<typename FunctionType, typename MatType>
-void GridSearch::Optimize(
-    FunctionType& function,
-    typename MatType::elem_type& bestObjective,
-    MatType& bestParameters,
-    MatType& currentParameters,
-    const std::vector<bool>& categoricalDimensions,
-    const arma::Row<size_t>& numCategories,
-    size_t i)
-{
-  // Convenience typedefs.
-  typedef typename MatType::elem_type ElemType;
-  typedef typename MatTypeTraits<MatType>::BaseMatType BaseMatType;
+  // Every "row" of the grid holds the points that only differ in the last
+  // coordinate; a row is evaluated at once.
+  const size_t rowLength = numCategories(dimensions - 1);
+  const size_t numRows = grid.Size() / rowLength;
 
-  // Make sure we have the methods that we need.  No restrictions on the matrix
-  // type are needed.
-  traits::CheckArbitraryFunctionTypeAPI<FunctionType, BaseMatType>();
+  // Split the grid into tasks by fixing the leading coordinates, until there
+  // are enough tasks to balance the load between the threads.
+  const size_t threads = NumThreads(numThreads);
+  size_t taskDepth = 0;
+  while (taskDepth + 1 < dimensions &&
+      grid.Size() / grid.Stride(taskDepth) < 16 * threads)
+  {
+    ++taskDepth;
+  }
+  const size_t numTasks = grid.Size() / grid.Stride(taskDepth);
+  const size_t rowsPerTask = numRows / numTasks;
+
+  // Pruning needs the best objective found by any task so far.
+  const bool prune = traits::HasLowerBoundSignature<FunctionType,
+      arma::Mat<ElemType>>::value;
+  std::atomic<ElemType> sharedBest(bestObjective);
 
-  if (i < categoricalDimensions.size())
+  std::vector<ElemType> taskObjectives(numTasks, bestObjective);
+  std::vector<size_t> taskIndices(numTasks, grid.Size());
+  ParallelFor(numTasks, numThreads, [&](const size_t task)
   {
-    for (size_t j = 0; j < numCategories(i); ++j)
+    const size_t firstRow = task * rowsPerTask;
+    arma::Mat<ElemType> point(dimensions, 1);
+    grid.Point(firstRow * rowLength, point);
+
+    arma::Mat<ElemType> candidates(dimensions, rowLength);
+    arma::Row<ElemType> objectives;
+    size_t row = 0;
+    while (row < rowsPerTask)
     {
-      currentParameters(i) = j;
-      Optimize(function, bestObjective, bestParameters, currentParameters,
-          categoricalDimensions, numCategories, i + 1);
+      // Skip the largest sub-grid starting at this row whose lower bound
+      // shows it can not contain a better point.  A sub-grid is only pruned if
+      // its bound is strictly greater than the best objective, so the best
+      // point (and the first one in case of ties) is never pruned.
+      size_t skipped = 0;
+      if (prune)
+      {
+        const ElemType threshold = sharedBest.load();
+        for (size_t k = std::max(taskDepth, (size_t) 1); k < dimensions; ++k)
+        {
+          if (((firstRow + row) * rowLength) % grid.Stride(k) != 0)
+            continue;
+
+          if (LowerBound(function, point, k) > threshold)
+          {
+            skipped = k;
+            break;
+          }
+        }
+      }
+
+      if (skipped != 0)
+      {
+        row += grid.Stride(skipped) / rowLength;
+        grid.Increment(point, skipped - 1);
+        continue;
+      }
+
+      // Evaluate the whole row at once.
+      candidates.each_col() = point;
+      for (size_t j = 0; j < rowLength; ++j)
+        candidates(dimensions - 1, j) = (ElemType) j;
+
+      EvaluateBatch(function, candidates, dimensions, 1, objectives);
+      for (size_t j = 0; j < rowLength; ++j)
+      {
+        if (objectives(j) < taskObjectives[task])
+        {
+          taskObjectives[task] = objectives(j);
+          taskIndices[task] = (firstRow + row) * rowLength + j;
+        }
+      }
+
+      // Share a better objective with the other tasks.
+      if (prune)
+      {
+        ElemType current = sharedBest.load();
+        while (taskObjectives[task] < current &&
+            !sharedBest.compare_exchange_weak(current, taskObjectives[task]))
+        { }
+      }
+
+      ++row;
+      if (dimensions > 1)
+        grid.Increment(point, dimensions - 2);
     }
-  }
-  else
+  });
+
+  // The tasks are ordered, so keeping the first of equal objectives gives the
+  // first best point in enumeration order, as a serial search would.
+  size_t bestIndex = grid.Size();
+  for (size_t task = 0; task < numTasks; ++task)
   {
-    ElemType objective = function.Evaluate((BaseMatType&) currentParameters);
-    if (objective < bestObjective)
+    if (taskObjectives[task] < bestObjective)
     {
-      bestObjective = objective;
-      bestParameters = currentParameters;
+      bestObjective = taskObjectives[task];
+      bestIndex = taskIndices[task];
     }
   }
+
+  if (bestIndex != grid.Size())
+  {
+    arma::Mat<ElemType> point(dimensions, 1);
+    grid.Point(bestIndex, point);
+    for (size_t i = 0; i < dimensions; ++i)
+      bestParameters(i, 0) = point(i);
+  }
+
+  return bestObjective;
 }
 
 } // namespace ens
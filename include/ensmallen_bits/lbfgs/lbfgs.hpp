@@ -220,6 +220,8 @@ class L_BFGS
    * @param s Differences between the iterate and old iterate matrix.
    * @param y Differences between the gradient and the old gradient matrix.
    * @param searchDirection Vector to store search direction in.
+   * @param rho Workspace of numBasis elements.
+   * @param alpha Workspace of numBasis elements.
    */
   template<typename MatType, typename CubeType>
   void SearchDirection(const MatType& gradient,
@@ -227,7 +229,9 @@ class L_BFGS
                        const double scalingFactor,
                        const CubeType& s,
                        const CubeType& y,
-                       MatType& searchDirection);
+                       MatType& searchDirection,
+                       arma::Col<typename CubeType::elem_type>& rho,
+                       arma::Col<typename CubeType::elem_type>& alpha);
 
   /**
    * Update the y and s matrices, which store the differences
@@ -114,6 +114,8 @@ double L_BFGS::ChooseScalingFactor(const size_t iterationNum,
  * @param s Differences between the iterate and old iterate matrix.
  * @param y Differences between the gradient and the old gradient matrix.
  * @param searchDirection Vector to store search direction in.
+ * @param rho Workspace of numBasis elements.
+ * @param alpha Workspace of numBasis elements.
  */
 template<typename MatType, typename CubeType>
 void L_BFGS::SearchDirection(const MatType& gradient,
@@ -121,7 +123,9 @@ void L_BFGS::SearchDirection(const MatType& gradient,
                              const double scalingFactor,
                              const CubeType& s,
                              const CubeType& y,
-                             MatType& searchDirection)
+                             MatType& searchDirection,
+                             arma::Col<typename CubeType::elem_type>& rho,
+                             arma::Col<typename CubeType::elem_type>& alpha)
 {
   // Start from this point.
   searchDirection = gradient;
@@ -130,10 +134,6 @@ void L_BFGS::SearchDirection(const MatType& gradient,
   // matrices with limited storage" (Nocedal, 1980).
   typedef typename CubeType::elem_type CubeElemType;
 
-  // Temporary variables.
-  arma::Col<CubeElemType> rho(numBasis);
-  arma::Col<CubeElemType> alpha(numBasis);
-
   size_t limit = (numBasis > iterationNum) ? 0 : (iterationNum - numBasis);
   for (size_t i = iterationNum; i != limit; i--)
   {
@@ -396,6 +396,10 @@ L_BFGS::Optimize(FunctionType& function,
   BaseGradType searchDirection(iterate.n_rows, iterate.n_cols);
   searchDirection.zeros();
 
+  // Workspace of SearchDirection(), allocated once.
+  arma::Col<ElemType> rho(numBasis);
+  arma::Col<ElemType> alpha(numBasis);
+
   // The initial function value and gradient.
   ElemType functionValue = f.EvaluateWithGradient(iterate, gradient);
 
@@ -451,7 +455,8 @@ L_BFGS::Optimize(FunctionType& function,
 
     // Build an approximation to the Hessian and choose the search
     // direction for the current iteration.
-    SearchDirection(gradient, itNum, scalingFactor, s, y, searchDirection);
+    SearchDirection(gradient, itNum, scalingFactor, s, y, searchDirection,
+        rho, alpha);
 
     // Save the old iterate and the gradient before stepping.
     oldIterate = iterate;
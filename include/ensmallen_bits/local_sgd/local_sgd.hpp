@@ -0,0 +1,208 @@
+/**
+ * @file local_sgd.hpp
+ *
+ * Local SGD: parallel SGD with periodic model averaging.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_LOCAL_SGD_LOCAL_SGD_HPP
+#define ENSMALLEN_LOCAL_SGD_LOCAL_SGD_HPP
+
+#include <ensmallen_bits/sgd/sgd.hpp>
+
+namespace ens {
+
+/**
+ * Local SGD (also known as parallel SGD with periodic averaging) runs one
+ * independent copy of the SGD update loop per thread.  The separable functions
+ * are split into one contiguous, disjoint shard per worker; each worker takes
+ * mini-batch steps on its own shard with its own copy of the iterate and its
+ * own update and decay policy state.  Every `averagingPeriod` steps the
+ * workers' iterates are averaged and the average is broadcast back to every
+ * worker.  Compared to synchronizing after every step, this reduces the
+ * number of synchronization points by a factor of `averagingPeriod`.
+ *
+ * For more information, see the following.
+ *
+ * @code
+ * @inproceedings{Stich2019,
+ *   author    = {Sebastian U. Stich},
+ *   title     = {Local {SGD} Converges Fast and Communicates Little},
+ *   booktitle = {International Conference on Learning Representations},
+ *   year      = {2019},
+ *   url       = {https://arxiv.org/abs/1805.09767}
+ * }
+ * @endcode
+ *
+ * LocalSGD can optimize differentiable separable functions.  The function's
+ * EvaluateWithGradient() (or Evaluate() and Gradient()) must be safe to call
+ * concurrently from multiple threads.  For more details, see the documentation
+ * on function types included with this distribution or on the ensmallen
+ * website.
+ *
+ * @tparam UpdatePolicyType Update policy used by each worker during the
+ *     iterative update process. By default vanilla update policy (see
+ *     ens::VanillaUpdate) is used.
+ * @tparam DecayPolicyType Decay policy used by each worker to adjust the step
+ *     size. By default the step size isn't going to be adjusted (i.e. NoDecay
+ *     is used).
+ */
+template<typename UpdatePolicyType = VanillaUpdate,
+         typename DecayPolicyType = NoDecay>
+class LocalSGD
+{
+ public:
+  /**
+   * Construct the LocalSGD optimizer with the given parameters.  The defaults
+   * here are not necessarily good for the given problem, so it is suggested
+   * that the values used be tailored to the task at hand.  The maximum number
+   * of iterations refers to the maximum number of points that are processed
+   * over all workers (i.e., one iteration equals one point; one iteration does
+   * not equal one pass over the dataset).
+   *
+   * @param stepSize Step size for each iteration.
+   * @param batchSize Batch size each worker uses for each step.
+   * @param maxIterations Maximum number of iterations allowed (0 means no
+   *     limit).
+   * @param tolerance Maximum absolute tolerance to terminate algorithm.
+   * @param shuffle If true, the function order is shuffled after every epoch;
+   *     otherwise, each function is visited in linear order.
+   * @param updatePolicy Instantiated update policy; every worker gets its own
+   *     instantiation of it.
+   * @param decayPolicy Instantiated decay policy; every worker gets its own
+   *     instantiation of it.
+   * @param numThreads Number of workers (0 means all available threads).
+   * @param averagingPeriod Number of local steps each worker takes between two
+   *     model averaging rounds.
+   */
+  LocalSGD(const double stepSize = 0.01,
+           const size_t batchSize = 32,
+           const size_t maxIterations = 100000,
+           const double tolerance = 1e-5,
+           const bool shuffle = true,
+           const UpdatePolicyType& updatePolicy = UpdatePolicyType(),
+           const DecayPolicyType& decayPolicy = DecayPolicyType(),
+           const size_t numThreads = 0,
+           const size_t averagingPeriod = 8);
+
+  /**
+   * Optimize the given function using Local SGD.  The given starting point
+   * will be modified to store the finishing point of the algorithm, and the
+   * final objective value is returned.
+   *
+   * @tparam SeparableFunctionType Type of the function to be optimized.
+   * @tparam MatType Type of matrix to optimize with.
+   * @tparam GradType Type of matrix to use to represent function gradients.
+   * @tparam CallbackTypes Types of callback functions.
+   * @param function Function to optimize.
+   * @param iterate Starting point (will be modified).
+   * @param callbacks Callback functions.
+   * @return Objective value of the final point.
+   */
+  template<typename SeparableFunctionType,
+           typename MatType,
+           typename GradType,
+           typename... CallbackTypes>
+  typename std::enable_if<IsArmaType<GradType>::value,
+      typename MatType::elem_type>::type
+  Optimize(SeparableFunctionType& function,
+           MatType& iterate,
+           CallbackTypes&&... callbacks);
+
+  //! Forward the MatType as GradType.
+  template<typename SeparableFunctionType,
+           typename MatType,
+           typename... CallbackTypes>
+  typename MatType::elem_type Optimize(SeparableFunctionType& function,
+                                       MatType& iterate,
+                                       CallbackTypes&&... callbacks)
+  {
+    return Optimize<SeparableFunctionType, MatType, MatType,
+        CallbackTypes...>(function, iterate,
+        std::forward<CallbackTypes>(callbacks)...);
+  }
+
+  //! Get the step size.
+  double StepSize() const { return stepSize; }
+  //! Modify the step size.
+  double& StepSize() { return stepSize; }
+
+  //! Get the batch size.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the batch size.
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the maximum number of iterations (0 indicates no limit).
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations (0 indicates no limit).
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance for termination.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for termination.
+  double& Tolerance() { return tolerance; }
+
+  //! Get whether or not the individual functions are shuffled.
+  bool Shuffle() const { return shuffle; }
+  //! Modify whether or not the individual functions are shuffled.
+  bool& Shuffle() { return shuffle; }
+
+  //! Get the update policy.
+  const UpdatePolicyType& UpdatePolicy() const { return updatePolicy; }
+  //! Modify the update policy.
+  UpdatePolicyType& UpdatePolicy() { return updatePolicy; }
+
+  //! Get the step size decay policy.
+  const DecayPolicyType& DecayPolicy() const { return decayPolicy; }
+  //! Modify the step size decay policy.
+  DecayPolicyType& DecayPolicy() { return decayPolicy; }
+
+  //! Get the number of workers (0 means all available threads).
+  size_t NumThreads() const { return numThreads; }
+  //! Modify the number of workers (0 means all available threads).
+  size_t& NumThreads() { return numThreads; }
+
+  //! Get the number of local steps between two averaging rounds.
+  size_t AveragingPeriod() const { return averagingPeriod; }
+  //! Modify the number of local steps between two averaging rounds.
+  size_t& AveragingPeriod() { return averagingPeriod; }
+
+ private:
+  //! The step size for each example.
+  double stepSize;
+
+  //! The batch size each worker uses for processing.
+  size_t batchSize;
+
+  //! The maximum number of allowed iterations.
+  size_t maxIterations;
+
+  //! The tolerance for termination.
+  double tolerance;
+
+  //! Controls whether or not the individual functions are shuffled when
+  //! iterating.
+  bool shuffle;
+
+  //! The update policy that is instantiated once per worker.
+  UpdatePolicyType updatePolicy;
+
+  //! The decay policy that is instantiated once per worker.
+  DecayPolicyType decayPolicy;
+
+  //! The number of workers.
+  size_t numThreads;
+
+  //! The number of local steps between two averaging rounds.
+  size_t averagingPeriod;
+};
+
+} // namespace ens
+
+// Include implementation.
+#include "local_sgd_impl.hpp"
+
+#endif
@@ -0,0 +1,233 @@
+/**
+ * @file local_sgd_impl.hpp
+ *
+ * Implementation of Local SGD.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_LOCAL_SGD_LOCAL_SGD_IMPL_HPP
+#define ENSMALLEN_LOCAL_SGD_LOCAL_SGD_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "local_sgd.hpp"
+
+#include <memory>
+#include <ensmallen_bits/function.hpp>
+#include <ensmallen_bits/utility/parallel.hpp>
+
+namespace ens {
+
+template<typename UpdatePolicyType, typename DecayPolicyType>
+LocalSGD<UpdatePolicyType, DecayPolicyType>::LocalSGD(
+    const double stepSize,
+    const size_t batchSize,
+    const size_t maxIterations,
+    const double tolerance,
+    const bool shuffle,
+    const UpdatePolicyType& updatePolicy,
+    const DecayPolicyType& decayPolicy,
+    const size_t numThreads,
+    const size_t averagingPeriod) :
+    stepSize(stepSize),
+    batchSize(batchSize),
+    maxIterations(maxIterations),
+    tolerance(tolerance),
+    shuffle(shuffle),
+    updatePolicy(updatePolicy),
+    decayPolicy(decayPolicy),
+    numThreads(numThreads),
+    averagingPeriod(averagingPeriod)
+{ /* Nothing to do. */ }
+
+//! Optimize the function (minimize).
+template<typename UpdatePolicyType, typename DecayPolicyType>
+template<typename SeparableFunctionType,
+         typename MatType,
+         typename GradType,
+         typename... CallbackTypes>
+typename std::enable_if<IsArmaType<GradType>::value,
+typename MatType::elem_type>::type
+LocalSGD<UpdatePolicyType, DecayPolicyType>::Optimize(
+    SeparableFunctionType& function,
+    MatType& iterateIn,
+    CallbackTypes&&... callbacks)
+{
+  // Convenience typedefs.
+  typedef typename MatType::elem_type ElemType;
+  typedef typename MatTypeTraits<MatType>::BaseMatType BaseMatType;
+  typedef typename MatTypeTraits<GradType>::BaseMatType BaseGradType;
+
+  typedef Function<SeparableFunctionType, BaseMatType, BaseGradType>
+      FullFunctionType;
+  FullFunctionType& f(static_cast<FullFunctionType&>(function));
+
+  typedef typename UpdatePolicyType::template Policy<BaseMatType, BaseGradType>
+      InstUpdatePolicyType;
+  typedef typename DecayPolicyType::template Policy<BaseMatType, BaseGradType>
+      InstDecayPolicyType;
+
+  // Make sure we have all the methods that we need.
+  traits::CheckSeparableFunctionTypeAPI<FullFunctionType, BaseMatType,
+      BaseGradType>();
+  RequireFloatingPointType<BaseMatType>();
+  RequireFloatingPointType<BaseGradType>();
+  RequireSameInternalTypes<BaseMatType, BaseGradType>();
+
+  if (batchSize == 0 || averagingPeriod == 0)
+  {
+    throw std::invalid_argument("LocalSGD::Optimize(): batchSize and "
+        "averagingPeriod must be greater than 0!");
+  }
+
+  BaseMatType& iterate = (BaseMatType&) iterateIn;
+
+  const size_t numFunctions = f.NumFunctions();
+  const size_t workers = std::max(std::min(NumThreads(numThreads),
+      numFunctions), (size_t) 1);
+
+  // Each worker owns a contiguous shard of the functions, a copy of the
+  // iterate, and its own update and decay policy state.
+  std::vector<BaseMatType> iterates(workers, iterate);
+  std::vector<BaseGradType> gradients(workers,
+      BaseGradType(iterate.n_rows, iterate.n_cols));
+  std::vector<double> stepSizes(workers, stepSize);
+  std::vector<ElemType> objectives(workers, ElemType(0));
+  std::vector<size_t> shardBegin(workers), shardEnd(workers), cursor(workers);
+  std::vector<size_t> processed(workers);
+  std::vector<std::unique_ptr<InstUpdatePolicyType>> updatePolicies(workers);
+  std::vector<std::unique_ptr<InstDecayPolicyType>> decayPolicies(workers);
+  for (size_t w = 0; w < workers; ++w)
+  {
+    shardBegin[w] = (w * numFunctions) / workers;
+    shardEnd[w] = ((w + 1) * numFunctions) / workers;
+    cursor[w] = shardBegin[w];
+    updatePolicies[w].reset(new InstUpdatePolicyType(updatePolicy,
+        iterate.n_rows, iterate.n_cols));
+    decayPolicies[w].reset(new InstDecayPolicyType(decayPolicy));
+  }
+
+  // To keep track of where we are and how things are going.
+  size_t epoch = 1;
+  ElemType overallObjective = 0;
+  ElemType lastObjective = DBL_MAX;
+
+  // Controls early termination of the optimization process.
+  bool terminate = false;
+
+  const size_t actualMaxIterations = (maxIterations == 0) ?
+      std::numeric_limits<size_t>::max() : maxIterations;
+  Callback::BeginOptimization(*this, f, iterate, callbacks...);
+  terminate |= Callback::BeginEpoch(*this, f, iterate, epoch,
+      overallObjective, callbacks...);
+  for (size_t i = 0; i < actualMaxIterations && !terminate;
+      /* incrementing done manually */)
+  {
+    // Split the remaining iteration budget evenly over the workers.
+    const size_t remaining = actualMaxIterations - i;
+    const size_t budget = remaining / workers +
+        ((remaining % workers != 0) ? 1 : 0);
+
+    // Every worker takes up to averagingPeriod local steps on its own shard.
+    ParallelFor(workers, workers, [&](const size_t w)
+    {
+      processed[w] = 0;
+      for (size_t step = 0; step < averagingPeriod &&
+          cursor[w] < shardEnd[w] && processed[w] < budget; ++step)
+      {
+        const size_t effectiveBatchSize = std::min(std::min(batchSize,
+            shardEnd[w] - cursor[w]), budget - processed[w]);
+
+        objectives[w] += f.EvaluateWithGradient(iterates[w], cursor[w],
+            gradients[w], effectiveBatchSize);
+        updatePolicies[w]->Update(iterates[w], stepSizes[w], gradients[w]);
+        decayPolicies[w]->Update(iterates[w], stepSizes[w], gradients[w]);
+
+        cursor[w] += effectiveBatchSize;
+        processed[w] += effectiveBatchSize;
+      }
+    });
+
+    // Average the workers' models and hand the average back to every worker.
+    iterate = iterates[0];
+    for (size_t w = 1; w < workers; ++w)
+    {
+      iterate += iterates[w];
+      i += processed[w];
+    }
+    i += processed[0];
+    iterate /= (ElemType) workers;
+    ParallelFor(workers, workers, [&](const size_t w)
+    {
+      iterates[w] = iterate;
+    });
+
+    terminate |= Callback::StepTaken(*this, f, iterate, callbacks...);
+
+    // Check if every worker has finished its shard.
+    bool epochDone = true;
+    for (size_t w = 0; w < workers; ++w)
+      epochDone &= (cursor[w] == shardEnd[w]);
+
+    if (epochDone)
+    {
+      overallObjective = 0;
+      for (size_t w = 0; w < workers; ++w)
+      {
+        overallObjective += objectives[w];
+        objectives[w] = 0;
+        cursor[w] = shardBegin[w];
+      }
+
+      terminate |= Callback::EndEpoch(*this, f, iterate, epoch++,
+          overallObjective / (ElemType) numFunctions, callbacks...);
+
+      // Output current objective function.
+      Info << "LocalSGD: iteration " << i << ", objective "
+          << overallObjective << "." << std::endl;
+
+      if (std::isnan(overallObjective) || std::isinf(overallObjective))
+      {
+        Warn << "LocalSGD: converged to " << overallObjective << "; "
+            << "terminating with failure.  Try a smaller step size?"
+            << std::endl;
+
+        Callback::EndOptimization(*this, f, iterate, callbacks...);
+        return overallObjective;
+      }
+
+      if (std::abs(lastObjective - overallObjective) < tolerance)
+      {
+        Info << "LocalSGD: minimized within tolerance " << tolerance << "; "
+            << "terminating optimization." << std::endl;
+
+        Callback::EndOptimization(*this, f, iterate, callbacks...);
+        return overallObjective;
+      }
+
+      terminate |= Callback::BeginEpoch(*this, f, iterate, epoch,
+          overallObjective, callbacks...);
+
+      lastObjective = overallObjective;
+
+      // The workers are idle here, so it is safe to reorder the functions.
+      if (shuffle)
+        f.Shuffle();
+    }
+  }
+
+  if (!terminate)
+  {
+    Info << "LocalSGD: maximum iterations (" << maxIterations << ") reached; "
+        << "terminating optimization." << std::endl;
+  }
+
+  Callback::EndOptimization(*this, f, iterate, callbacks...);
+  return overallObjective;
+}
+
+} // namespace ens
+
+#endif
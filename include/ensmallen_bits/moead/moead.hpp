@@ -219,7 +219,15 @@ class MOEAD {
   //! Modify the weight decomposition policy.
   DecompPolicyType& DecompPolicy() { return decompPolicy; }
 
+  //! Get the random number engine.
+  const RandomEngine& Engine() const { return engine; }
+  //! Modify the random number engine.
+  RandomEngine& Engine() { return engine; }
+
  private:
+  //! The source of random numbers.
+  RandomEngine engine;
+
   /**
    * @brief Randomly selects two members from the population.
    *
@@ -167,8 +167,9 @@ Optimize(std::tuple<ArbitraryFunctionType...>& objectives,
   std::vector<BaseMatType> population(populationSize);
   for (BaseMatType& individual : population)
   {
-    individual = arma::randu<BaseMatType>(
-        iterate.n_rows, iterate.n_cols) - 0.5 + iterate;
+    individual.set_size(iterate.n_rows, iterate.n_cols);
+    engine.FillUniform(individual);
+    individual += iterate - 0.5;
 
     // Constrain all genes to be within bounds.
     individual = arma::min(arma::max(individual, castedLowerBound), castedUpperBound);
@@ -194,8 +195,7 @@ Optimize(std::tuple<ArbitraryFunctionType...>& objectives,
   for (size_t generation = 1; generation <= maxGenerations && !terminate; ++generation)
   {
     // Shuffle indexes of subproblems.
-    const arma::uvec shuffle = arma::shuffle(
-        arma::linspace<arma::uvec>(0, populationSize - 1, populationSize));
+    const arma::uvec shuffle = engine.Permutation(populationSize);
     for (size_t subProblemIdx : shuffle)
     {
       // 2.1 Randomly select two indices in neighborIndices[subProblemIdx] and use them
@@ -203,7 +203,7 @@ Optimize(std::tuple<ArbitraryFunctionType...>& objectives,
       size_t r1, r2, r3;
       r1 = subProblemIdx;
       // Randomly choose to sample from the population or the neighbors.
-      const bool sampleNeighbor = arma::randu() < neighborProb;
+      const bool sampleNeighbor = engine.Uniform() < neighborProb;
       std::tie(r2, r3) =
           Mating(subProblemIdx, neighborIndices, sampleNeighbor);
 
@@ -213,7 +213,7 @@ Optimize(std::tuple<ArbitraryFunctionType...>& objectives,
 
       for (size_t geneIdx = 0; geneIdx < numVariables; ++geneIdx)
       {
-        if (arma::randu() < crossoverProb)
+        if (engine.Uniform() < crossoverProb)
         {
           candidate(geneIdx) = population[r1](geneIdx) +
               differentialWeight * (population[r2](geneIdx) -
@@ -223,12 +223,12 @@ Optimize(std::tuple<ArbitraryFunctionType...>& objectives,
           if (candidate(geneIdx) < castedLowerBound(geneIdx))
           {
             candidate(geneIdx) = castedLowerBound(geneIdx) +
-                arma::randu() * (population[r1](geneIdx) - castedLowerBound(geneIdx));
+                engine.Uniform() * (population[r1](geneIdx) - castedLowerBound(geneIdx));
           }
           if (candidate(geneIdx) > castedUpperBound(geneIdx))
           {
             candidate(geneIdx) = castedUpperBound(geneIdx) -
-                arma::randu() * (castedUpperBound(geneIdx) - population[r1](geneIdx));
+                engine.Uniform() * (castedUpperBound(geneIdx) - population[r1](geneIdx));
           }
         }
         else
@@ -255,8 +255,7 @@ Optimize(std::tuple<ArbitraryFunctionType...>& objectives,
       size_t replaceCounter = 0;
       const size_t sampleSize = sampleNeighbor ? neighborSize : populationSize;
 
-      const arma::uvec idxShuffle = arma::shuffle(
-          arma::linspace<arma::uvec>(0, sampleSize - 1, sampleSize));
+      const arma::uvec idxShuffle = engine.Permutation(sampleSize);
 
       for (size_t idx : idxShuffle)
       {
@@ -283,8 +282,8 @@ Optimize(std::tuple<ArbitraryFunctionType...>& objectives,
     } // End of pass over all subproblems.
 
     //  The final population itself is the best front.
-    const std::vector<arma::uvec> frontIndices { arma::shuffle(
-        arma::linspace<arma::uvec>(0, populationSize - 1, populationSize)) };
+    const std::vector<arma::uvec> frontIndices {
+        engine.Permutation(populationSize) };
 
     terminate |= Callback::GenerationalStepTaken(*this, objectives, iterate,
         populationFitness, frontIndices, callbacks...);
@@ -338,13 +337,13 @@ Mating(size_t subProblemIdx,
   //! Indexes of two points from the sample space.
   size_t pointA = sampleNeighbor
       ? neighborIndices(
-            arma::randi(arma::distr_param(0, neighborSize - 1u)), subProblemIdx)
-      : arma::randi(arma::distr_param(0, populationSize - 1u));
+            engine.Integer(0, neighborSize - 1u), subProblemIdx)
+      : engine.Integer(0, populationSize - 1u);
 
   size_t pointB = sampleNeighbor
       ? neighborIndices(
-            arma::randi(arma::distr_param(0, neighborSize - 1u)), subProblemIdx)
-      : arma::randi(arma::distr_param(0, populationSize - 1u));
+            engine.Integer(0, neighborSize - 1u), subProblemIdx)
+      : engine.Integer(0, populationSize - 1u);
 
   //! If the sampled points are equal, then modify one of them
   //! within reasonable bounds.
@@ -372,7 +371,7 @@ Mutate(MatType& candidate,
     for (size_t geneIdx = 0; geneIdx < numVariables; ++geneIdx)
     {
       // Should this gene be mutated?
-      if (arma::randu() > mutationRate)
+      if (engine.Uniform() > mutationRate)
         continue;
 
       const double geneRange = upperBound(geneIdx) - lowerBound(geneIdx);
@@ -380,7 +379,7 @@ Mutate(MatType& candidate,
       const double lowerDelta = (candidate(geneIdx) - lowerBound(geneIdx)) / geneRange;
       const double upperDelta = (upperBound(geneIdx) - candidate(geneIdx)) / geneRange;
       const double mutationPower = 1. / (distributionIndex + 1.0);
-      const double rand = arma::randu();
+      const double rand = engine.Uniform();
       double value, perturbationFactor;
       if (rand < 0.5)
       {
@@ -428,12 +427,14 @@ EvaluateObjectives(
     std::tuple<ArbitraryFunctionType...>& objectives,
     std::vector<arma::Col<typename MatType::elem_type> >& calculatedObjectives)
 {
-  for (size_t i = 0; i < population.size(); i++)
-  {
-    calculatedObjectives[i](I) = std::get<I>(objectives).Evaluate(population[i]);
-    EvaluateObjectives<I+1, MatType, ArbitraryFunctionType...>(population, objectives,
-                                                               calculatedObjectives);
-  }
+  // Evaluate objective I for all the candidates at once.
+  arma::Col<typename MatType::elem_type> values;
+  EvaluatePopulation(std::get<I>(objectives), population, values);
+  for (size_t i = 0; i < values.n_elem; i++)
+    calculatedObjectives[i](I) = values[i];
+
+  EvaluateObjectives<I+1, MatType, ArbitraryFunctionType...>(population, objectives,
+                                                             calculatedObjectives);
 }
 
 }  // namespace ens
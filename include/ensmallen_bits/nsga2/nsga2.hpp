@@ -198,7 +198,15 @@ class NSGA2
     return rcFront;
   }
 
+  //! Get the random number engine.
+  const RandomEngine& Engine() const { return engine; }
+  //! Modify the random number engine.
+  RandomEngine& Engine() { return engine; }
+
  private:
+  //! The source of random numbers.
+  RandomEngine engine;
+
   /**
    * Evaluate objectives for the elite population.
    *
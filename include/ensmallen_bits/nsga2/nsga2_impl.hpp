@@ -131,8 +131,9 @@ typename MatType::elem_type NSGA2::Optimize(
   // starting point.
   for (size_t i = 0; i < populationSize; i++)
   {
-    population.push_back(arma::randu<BaseMatType>(iterate.n_rows,
-        iterate.n_cols) - 0.5 + iterate);
+    BaseMatType candidate(iterate.n_rows, iterate.n_cols);
+    engine.FillUniform(candidate);
+    population.push_back(candidate - 0.5 + iterate);
 
     // Constrain all genes to be within bounds.
     population[i] = arma::min(arma::max(population[i], castedLowerBound), castedUpperBound);
@@ -257,12 +258,15 @@ NSGA2::EvaluateObjectives(
     std::tuple<ArbitraryFunctionType...>& objectives,
     std::vector<arma::Col<typename MatType::elem_type> >& calculatedObjectives)
 {
-  for (size_t i = 0; i < populationSize; i++)
-  {
-    calculatedObjectives[i](I) = std::get<I>(objectives).Evaluate(population[i]);
-    EvaluateObjectives<I+1, MatType, ArbitraryFunctionType...>(population, objectives,
-                                                               calculatedObjectives);
-  }
+  // Evaluate objective I for all the candidates at once.
+  arma::Col<typename MatType::elem_type> values;
+  EvaluatePopulation(std::get<I>(objectives), population, populationSize,
+      values);
+  for (size_t i = 0; i < values.n_elem; i++)
+    calculatedObjectives[i](I) = values[i];
+
+  EvaluateObjectives<I+1, MatType, ArbitraryFunctionType...>(population, objectives,
+                                                             calculatedObjectives);
 }
 
 //! Reproduce and generate new candidates.
@@ -276,8 +280,8 @@ inline void NSGA2::BinaryTournamentSelection(std::vector<MatType>& population,
   while (children.size() < population.size())
   {
     // Choose two random parents for reproduction from the elite population.
-    size_t indexA = arma::randi<size_t>(arma::distr_param(0, populationSize - 1));
-    size_t indexB = arma::randi<size_t>(arma::distr_param(0, populationSize - 1));
+    size_t indexA = engine.Integer(0, populationSize - 1);
+    size_t indexB = engine.Integer(0, populationSize - 1);
 
     // Make sure that the parents differ.
     if (indexA == indexB)
@@ -313,7 +317,9 @@ inline void NSGA2::Crossover(MatType& childA,
                              const MatType& parentB)
 {
   // Indices at which crossover is to occur.
-  const arma::umat idx = arma::randu<MatType>(childA.n_rows, childA.n_cols) < crossoverProb;
+  MatType draws(childA.n_rows, childA.n_cols);
+  engine.FillUniform(draws);
+  const arma::umat idx = draws < crossoverProb;
 
   // Use traits from parentA for indices where idx is 1 and parentB otherwise.
   childA = parentA % idx + parentB % (1 - idx);
@@ -327,8 +333,10 @@ inline void NSGA2::Mutate(MatType& child,
                           const MatType& lowerBound,
                           const MatType& upperBound)
 {
-  child += (arma::randu<MatType>(child.n_rows, child.n_cols) < mutationProb) %
-      (mutationStrength * arma::randn<MatType>(child.n_rows, child.n_cols));
+  MatType mask(child.n_rows, child.n_cols), noise(child.n_rows, child.n_cols);
+  engine.FillUniform(mask);
+  engine.FillNormal(noise);
+  child += (mask < mutationProb) % (mutationStrength * noise);
 
   // Constrain all genes to be between bounds.
   child = arma::min(arma::max(child, lowerBound), upperBound);
@@ -116,24 +116,61 @@ class PadamUpdate
       // Increment the iteration counter variable.
       ++iteration;
 
-      // And update the iterate.
+      const double biasCorrection1 = 1.0 - std::pow(parent.beta1, iteration);
+      const double biasCorrection2 = 1.0 - std::pow(parent.beta2, iteration);
+
+      Step(iterate, gradient,
+          stepSize * std::sqrt(biasCorrection2) / biasCorrection1);
+    }
+
+   private:
+    //! Update the moments and take a step of size alpha.
+    template<typename IterateType, typename GType>
+    void Step(IterateType& iterate, const GType& gradient, const double alpha)
+    {
       m *= parent.beta1;
       m += (1 - parent.beta1) * gradient;
 
       v *= parent.beta2;
       v += (1 - parent.beta2) * (gradient % gradient);
 
-      const double biasCorrection1 = 1.0 - std::pow(parent.beta1, iteration);
-      const double biasCorrection2 = 1.0 - std::pow(parent.beta2, iteration);
-
       // Element wise maximum of past and present squared gradients.
-      vImproved = arma::max(vImproved, v);
+      MaxInPlace(vImproved, v);
 
-      iterate -= (stepSize * std::sqrt(biasCorrection2) / biasCorrection1) *
-          m / arma::pow(vImproved + parent.epsilon, parent.partial);
+      iterate -= alpha * m / arma::pow(vImproved + parent.epsilon,
+          parent.partial);
+    }
+
+    //! Dense version of Step(): update the moments and the iterate in a single
+    //! pass over the memory.
+    template<typename eT>
+    void Step(arma::Mat<eT>& iterate,
+              const arma::Mat<eT>& gradient,
+              const double alpha)
+    {
+      const eT beta1 = parent.beta1;
+      const eT beta2 = parent.beta2;
+      const eT epsilon = parent.epsilon;
+      const eT partial = parent.partial;
+      const eT a = alpha;
+
+      eT* x = iterate.memptr();
+      eT* mMem = m.memptr();
+      eT* vMem = v.memptr();
+      eT* vImprovedMem = vImproved.memptr();
+      const eT* g = gradient.memptr();
+
+      const size_t n = iterate.n_elem;
+      ENS_PRAGMA_OMP_SIMD
+      for (size_t i = 0; i < n; ++i)
+      {
+        mMem[i] = beta1 * mMem[i] + (1 - beta1) * g[i];
+        vMem[i] = beta2 * vMem[i] + (1 - beta2) * (g[i] * g[i]);
+        vImprovedMem[i] = std::max(vImprovedMem[i], vMem[i]);
+        x[i] -= a * mMem[i] / std::pow(vImprovedMem[i] + epsilon, partial);
+      }
     }
 
-   private:
     //! Instantiated parent object.
     PadamUpdate& parent;
 
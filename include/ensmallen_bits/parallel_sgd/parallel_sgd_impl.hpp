@@ -16,6 +16,7 @@
 #include "parallel_sgd.hpp"
 
 #include <ensmallen_bits/function.hpp>
+#include <ensmallen_bits/utility/parallel.hpp>
 
 namespace ens {
 
@@ -95,6 +96,16 @@ typename MatType::elem_type>::type ParallelSGD<DecayPolicyType>::Optimize(
   arma::Col<size_t> visitationOrder = arma::linspace<arma::Col<size_t>>(0,
       (function.NumFunctions() - 1), function.NumFunctions());
 
+  #ifdef ENS_DETERMINISTIC
+  // The gradients of the points visited in one iteration; they are reused
+  // across iterations.  The number of points must not depend on the number of
+  // threads, so every one of a fixed number of shards visits threadShareSize
+  // points.
+  const size_t points = std::min((size_t) ENS_DETERMINISTIC_SHARDS *
+      threadShareSize, (size_t) visitationOrder.n_elem);
+  std::vector<BaseGradType> gradients(points);
+  #endif
+
   // Iterate till the objective is within tolerance or the maximum number of
   // allowed iterations is reached. If maxIterations is 0, this will iterate
   // till convergence.
@@ -139,9 +150,37 @@ typename MatType::elem_type>::type ParallelSGD<DecayPolicyType>::Optimize(
     if (shuffle)
     {
       // Determine order of visitation.
-      visitationOrder = arma::shuffle(visitationOrder);
+      engine.ShuffleInPlace(visitationOrder);
     }
 
+  #ifdef ENS_DETERMINISTIC
+    // In deterministic mode the gradients of this iteration's points are
+    // computed in parallel, all at the same iterate, and then applied in
+    // visitation order, so the result does not depend on thread scheduling.
+    ParallelFor(points, 0, [&](const size_t j)
+    {
+      function.Gradient(iterate, visitationOrder[j], gradients[j], 1);
+    });
+
+    for (size_t j = 0; j < points; ++j)
+    {
+      terminate |= Callback::Gradient(*this, function, iterate, gradients[j],
+          callbacks...);
+
+      for (size_t c = 0; c < gradients[j].n_cols; ++c)
+      {
+        const typename BaseGradType::iterator curEnd = gradients[j].end_col(c);
+        for (typename BaseGradType::iterator cur = gradients[j].begin_col(c);
+            cur != curEnd; ++cur)
+        {
+          iterate(cur.row(), c) -= stepSize * (*cur);
+        }
+      }
+
+      terminate |= Callback::StepTaken(*this, function, iterate,
+          callbacks...);
+    }
+  #else
     ENS_PRAGMA_OMP_PARALLEL
     {
       // Each processor gets a subset of the instances.
@@ -151,14 +190,15 @@ typename MatType::elem_type>::type ParallelSGD<DecayPolicyType>::Optimize(
         threadId = omp_get_thread_num();
       #endif
 
+      // Each instance affects only some components of the decision variable,
+      // so the gradient is sparse.  It is reused for all of the thread's
+      // instances.
+      BaseGradType gradient;
+
       for (size_t j = threadId * threadShareSize;
           j < (threadId + 1) * threadShareSize && j < visitationOrder.n_elem;
           ++j)
       {
-        // Each instance affects only some components of the decision variable.
-        // So the gradient is sparse.
-        BaseGradType gradient;
-
         // Evaluate the sparse gradient.
         // TODO: support for batch size > 1 could be really useful.
         function.Gradient(iterate, visitationOrder[j], gradient, 1);
@@ -187,6 +227,7 @@ typename MatType::elem_type>::type ParallelSGD<DecayPolicyType>::Optimize(
             callbacks...);
       }
     }
+  #endif
   }
 
   Info << "\nParallel SGD terminated with objective : " << overallObjective
@@ -0,0 +1,204 @@
+/**
+ * @file parameter_server_sgd.hpp
+ *
+ * Multi-process parameter server SGD over Unix domain sockets.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_PARAMETER_SERVER_PARAMETER_SERVER_SGD_HPP
+#define ENSMALLEN_PARAMETER_SERVER_PARAMETER_SERVER_SGD_HPP
+
+#include <ensmallen_bits/sgd/sgd.hpp>
+
+// Worker processes are only available on POSIX systems.
+#if defined(__unix__) || defined(__unix) || \
+    (defined(__APPLE__) && defined(__MACH__))
+  #define ENS_HAVE_PARAMETER_SERVER
+#endif
+
+namespace ens {
+
+/**
+ * ParameterServerSGD trains a separable function with a pool of worker
+ * processes on the same host.  When Optimize() is called, the calling process
+ * becomes the parameter server and forks `numWorkers` worker processes, each
+ * connected to the server with a Unix domain socket pair.  The server hands
+ * out mini-batches together with the current parameters; a worker computes
+ * the objective and gradient of its mini-batch with EvaluateWithGradient() and
+ * pushes them back.  The server applies the gradient with the given SGD update
+ * policy as soon as it arrives and replies with fresh parameters and the next
+ * mini-batch, so gradients are at most `numWorkers - 1` updates stale.
+ *
+ * Since the workers are separate processes, a worker that crashes does not
+ * take the optimization down with it: its mini-batch is handed to one of the
+ * remaining workers.  The server never blocks on a single worker: a worker
+ * that exits, or that hangs on a mini-batch for longer than `workerTimeout`
+ * seconds, is killed and its mini-batch is reassigned in the same way.  The
+ * optimization throws std::runtime_error once every worker is lost.
+ *
+ * No MPI or other dependency is needed, but worker processes are created with
+ * fork(), so this optimizer is only available on POSIX systems; on other
+ * platforms Optimize() throws std::runtime_error.  The function object is
+ * copied into each worker at fork() time, so the function must not rely on
+ * state shared with the server (shuffling, for instance, is not supported).
+ * Workers can only be started by the server; attaching external workers (for
+ * instance over TCP) is not supported.
+ *
+ * Note that fork() only duplicates the calling thread.  If other threads of
+ * the process (for instance an OpenMP thread pool, which is started by any
+ * earlier parallel region) hold a lock at fork() time, a worker that needs the
+ * same lock deadlocks.  Workers are therefore restricted to one OpenMP thread,
+ * and the function must not start parallel regions or threads of its own.
+ * When in doubt, call Optimize() before the process runs any OpenMP code; a
+ * worker that deadlocks anyway is caught by `workerTimeout`.
+ *
+ * @tparam UpdatePolicyType Update policy applied by the server. By default
+ *     vanilla update policy (see ens::VanillaUpdate) is used.
+ * @tparam DecayPolicyType Decay policy used by the server to adjust the step
+ *     size. By default the step size isn't going to be adjusted (i.e. NoDecay
+ *     is used).
+ */
+template<typename UpdatePolicyType = VanillaUpdate,
+         typename DecayPolicyType = NoDecay>
+class ParameterServerSGD
+{
+ public:
+  /**
+   * Construct the ParameterServerSGD optimizer with the given parameters.  The
+   * maximum number of iterations refers to the maximum number of points that
+   * are processed (i.e., one iteration equals one point; one iteration does
+   * not equal one pass over the dataset).
+   *
+   * @param stepSize Step size for each iteration.
+   * @param batchSize Batch size handed to a worker for each step.
+   * @param maxIterations Maximum number of iterations allowed (0 means no
+   *     limit).
+   * @param tolerance Maximum absolute tolerance to terminate algorithm.
+   * @param numWorkers Number of worker processes.
+   * @param updatePolicy Instantiated update policy used by the server.
+   * @param decayPolicy Instantiated decay policy used by the server.
+   * @param workerTimeout Maximum number of seconds a worker may spend on one
+   *     mini-batch before it is considered lost.
+   */
+  ParameterServerSGD(const double stepSize = 0.01,
+                     const size_t batchSize = 32,
+                     const size_t maxIterations = 100000,
+                     const double tolerance = 1e-5,
+                     const size_t numWorkers = 4,
+                     const UpdatePolicyType& updatePolicy = UpdatePolicyType(),
+                     const DecayPolicyType& decayPolicy = DecayPolicyType(),
+                     const double workerTimeout = 600.0);
+
+  /**
+   * Optimize the given function with the parameter server.  The given starting
+   * point will be modified to store the finishing point of the algorithm, and
+   * the final objective value is returned.
+   *
+   * @tparam SeparableFunctionType Type of the function to be optimized.
+   * @tparam MatType Type of matrix to optimize with.
+   * @tparam GradType Type of matrix to use to represent function gradients
+   *     (must be a dense matrix type).
+   * @tparam CallbackTypes Types of callback functions.
+   * @param function Function to optimize.
+   * @param iterate Starting point (will be modified).
+   * @param callbacks Callback functions.
+   * @return Objective value of the final point.
+   */
+  template<typename SeparableFunctionType,
+           typename MatType,
+           typename GradType,
+           typename... CallbackTypes>
+  typename std::enable_if<IsArmaType<GradType>::value,
+      typename MatType::elem_type>::type
+  Optimize(SeparableFunctionType& function,
+           MatType& iterate,
+           CallbackTypes&&... callbacks);
+
+  //! Forward the MatType as GradType.
+  template<typename SeparableFunctionType,
+           typename MatType,
+           typename... CallbackTypes>
+  typename MatType::elem_type Optimize(SeparableFunctionType& function,
+                                       MatType& iterate,
+                                       CallbackTypes&&... callbacks)
+  {
+    return Optimize<SeparableFunctionType, MatType, MatType,
+        CallbackTypes...>(function, iterate,
+        std::forward<CallbackTypes>(callbacks)...);
+  }
+
+  //! Get the step size.
+  double StepSize() const { return stepSize; }
+  //! Modify the step size.
+  double& StepSize() { return stepSize; }
+
+  //! Get the batch size.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the batch size.
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the maximum number of iterations (0 indicates no limit).
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations (0 indicates no limit).
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance for termination.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for termination.
+  double& Tolerance() { return tolerance; }
+
+  //! Get the number of worker processes.
+  size_t NumWorkers() const { return numWorkers; }
+  //! Modify the number of worker processes.
+  size_t& NumWorkers() { return numWorkers; }
+
+  //! Get the update policy.
+  const UpdatePolicyType& UpdatePolicy() const { return updatePolicy; }
+  //! Modify the update policy.
+  UpdatePolicyType& UpdatePolicy() { return updatePolicy; }
+
+  //! Get the step size decay policy.
+  const DecayPolicyType& DecayPolicy() const { return decayPolicy; }
+  //! Modify the step size decay policy.
+  DecayPolicyType& DecayPolicy() { return decayPolicy; }
+
+  //! Get the number of seconds after which a busy worker is considered lost.
+  double WorkerTimeout() const { return workerTimeout; }
+  //! Modify the number of seconds after which a busy worker is considered lost.
+  double& WorkerTimeout() { return workerTimeout; }
+
+ private:
+  //! The step size for each example.
+  double stepSize;
+
+  //! The batch size handed to a worker for each step.
+  size_t batchSize;
+
+  //! The maximum number of allowed iterations.
+  size_t maxIterations;
+
+  //! The tolerance for termination.
+  double tolerance;
+
+  //! The number of worker processes.
+  size_t numWorkers;
+
+  //! The update policy applied by the server.
+  UpdatePolicyType updatePolicy;
+
+  //! The decay policy used by the server.
+  DecayPolicyType decayPolicy;
+
+  //! The number of seconds after which a busy worker is considered lost.
+  double workerTimeout;
+};
+
+} // namespace ens
+
+// Include implementation.
+#include "parameter_server_sgd_impl.hpp"
+
+#endif
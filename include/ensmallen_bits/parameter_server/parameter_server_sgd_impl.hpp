@@ -0,0 +1,598 @@
+/**
+ * @file parameter_server_sgd_impl.hpp
+ *
+ * Implementation of the multi-process parameter server SGD.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_PARAMETER_SERVER_PARAMETER_SERVER_SGD_IMPL_HPP
+#define ENSMALLEN_PARAMETER_SERVER_PARAMETER_SERVER_SGD_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "parameter_server_sgd.hpp"
+
+#include <ensmallen_bits/function.hpp>
+
+#ifdef ENS_HAVE_PARAMETER_SERVER
+  #include <cerrno>
+  #include <chrono>
+  #include <deque>
+  #include <poll.h>
+  #include <signal.h>
+  #include <sys/socket.h>
+  #include <sys/types.h>
+  #include <sys/wait.h>
+  #include <unistd.h>
+#endif
+
+namespace ens {
+
+#ifdef ENS_HAVE_PARAMETER_SERVER
+namespace parameter_server {
+
+//! Message sent by the server to stop a worker.
+static const uint64_t stopCommand = 0;
+//! Message sent by the server to request a mini-batch gradient.
+static const uint64_t computeCommand = 1;
+
+/**
+ * Write exactly the given number of bytes to the socket.  Returns false if the
+ * peer has gone away.
+ */
+inline bool WriteAll(const int fd, const void* data, size_t bytes)
+{
+  const char* p = static_cast<const char*>(data);
+  while (bytes > 0)
+  {
+    #ifdef MSG_NOSIGNAL
+      const ssize_t n = ::send(fd, p, bytes, MSG_NOSIGNAL);
+    #else
+      const ssize_t n = ::send(fd, p, bytes, 0);
+    #endif
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return false;
+
+    p += n;
+    bytes -= (size_t) n;
+  }
+
+  return true;
+}
+
+/**
+ * Read exactly the given number of bytes from the socket.  Returns false if
+ * the peer has gone away.
+ */
+inline bool ReadAll(const int fd, void* data, size_t bytes)
+{
+  char* p = static_cast<char*>(data);
+  while (bytes > 0)
+  {
+    const ssize_t n = ::recv(fd, p, bytes, 0);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return false;
+
+    p += n;
+    bytes -= (size_t) n;
+  }
+
+  return true;
+}
+
+/**
+ * The set of worker processes owned by the server.  On destruction (including
+ * when an exception is thrown) every worker is told to stop and is reaped.
+ */
+class WorkerPool
+{
+ public:
+  ~WorkerPool()
+  {
+    for (size_t w = 0; w < fds.size(); ++w)
+    {
+      if (fds[w] >= 0)
+      {
+        WriteAll(fds[w], &stopCommand, sizeof(stopCommand));
+        ::close(fds[w]);
+      }
+    }
+
+    for (size_t w = 0; w < pids.size(); ++w)
+    {
+      int status;
+      while (!reaped[w] && ::waitpid(pids[w], &status, 0) < 0 &&
+          errno == EINTR) { }
+    }
+  }
+
+  //! Register a new worker.
+  void Add(const int fd, const pid_t pid)
+  {
+    fds.push_back(fd);
+    pids.push_back(pid);
+    reaped.push_back(false);
+  }
+
+  //! Check, without blocking, whether the given worker process has exited.
+  bool Exited(const size_t w)
+  {
+    int status;
+    if (!reaped[w] && ::waitpid(pids[w], &status, WNOHANG) == pids[w])
+      reaped[w] = true;
+
+    return reaped[w];
+  }
+
+  //! Disconnect from a worker that failed; it is still reaped on destruction.
+  void Drop(const size_t w)
+  {
+    // A reaped pid may already belong to an unrelated process.
+    if (!reaped[w])
+      ::kill(pids[w], SIGKILL);
+    ::close(fds[w]);
+    fds[w] = -1;
+  }
+
+  //! Get the number of workers.
+  size_t Size() const { return fds.size(); }
+  //! Check whether the given worker is still connected.
+  bool Alive(const size_t w) const { return fds[w] >= 0; }
+  //! Get the socket of the given worker.
+  int Socket(const size_t w) const { return fds[w]; }
+  //! Get the sockets of all workers.
+  const std::vector<int>& Sockets() const { return fds; }
+
+ private:
+  //! The server's end of each worker's socket (-1 if the worker failed).
+  std::vector<int> fds;
+  //! The process id of each worker.
+  std::vector<pid_t> pids;
+  //! Whether each worker process has already been reaped.
+  std::vector<bool> reaped;
+};
+
+/**
+ * The main loop of a worker process: receive parameters and a mini-batch,
+ * compute the objective and gradient, and send them back until the server
+ * asks us to stop or goes away.
+ */
+template<typename FunctionType, typename MatType, typename GradType>
+void RunWorker(FunctionType& function,
+               const int fd,
+               const size_t rows,
+               const size_t cols)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  MatType iterate(rows, cols);
+  GradType gradient(rows, cols);
+  uint64_t header[3];
+  while (ReadAll(fd, header, sizeof(header)) && header[0] == computeCommand)
+  {
+    if (!ReadAll(fd, iterate.memptr(), sizeof(ElemType) * iterate.n_elem))
+      return;
+
+    const ElemType objective = function.EvaluateWithGradient(iterate,
+        (size_t) header[1], gradient, (size_t) header[2]);
+    if (gradient.n_elem != iterate.n_elem)
+      return;
+
+    if (!WriteAll(fd, &objective, sizeof(ElemType)) ||
+        !WriteAll(fd, gradient.memptr(), sizeof(ElemType) * gradient.n_elem))
+      return;
+  }
+}
+
+} // namespace parameter_server
+#endif
+
+template<typename UpdatePolicyType, typename DecayPolicyType>
+ParameterServerSGD<UpdatePolicyType, DecayPolicyType>::ParameterServerSGD(
+    const double stepSize,
+    const size_t batchSize,
+    const size_t maxIterations,
+    const double tolerance,
+    const size_t numWorkers,
+    const UpdatePolicyType& updatePolicy,
+    const DecayPolicyType& decayPolicy,
+    const double workerTimeout) :
+    stepSize(stepSize),
+    batchSize(batchSize),
+    maxIterations(maxIterations),
+    tolerance(tolerance),
+    numWorkers(numWorkers),
+    updatePolicy(updatePolicy),
+    decayPolicy(decayPolicy),
+    workerTimeout(workerTimeout)
+{ /* Nothing to do. */ }
+
+//! Optimize the function (minimize).
+template<typename UpdatePolicyType, typename DecayPolicyType>
+template<typename SeparableFunctionType,
+         typename MatType,
+         typename GradType,
+         typename... CallbackTypes>
+typename std::enable_if<IsArmaType<GradType>::value,
+typename MatType::elem_type>::type
+ParameterServerSGD<UpdatePolicyType, DecayPolicyType>::Optimize(
+    SeparableFunctionType& function,
+    MatType& iterateIn,
+    CallbackTypes&&... callbacks)
+{
+  // Convenience typedefs.
+  typedef typename MatType::elem_type ElemType;
+  typedef typename MatTypeTraits<MatType>::BaseMatType BaseMatType;
+  typedef typename MatTypeTraits<GradType>::BaseMatType BaseGradType;
+
+  typedef Function<SeparableFunctionType, BaseMatType, BaseGradType>
+      FullFunctionType;
+  FullFunctionType& f(static_cast<FullFunctionType&>(function));
+
+  typedef typename UpdatePolicyType::template Policy<BaseMatType, BaseGradType>
+      InstUpdatePolicyType;
+  typedef typename DecayPolicyType::template Policy<BaseMatType, BaseGradType>
+      InstDecayPolicyType;
+
+  // Make sure we have all the methods that we need.  Parameters and gradients
+  // are sent over the sockets as raw memory, so they must be dense.
+  traits::CheckSeparableFunctionTypeAPI<FullFunctionType, BaseMatType,
+      BaseGradType>();
+  RequireDenseFloatingPointType<BaseMatType>();
+  RequireDenseFloatingPointType<BaseGradType>();
+  RequireSameInternalTypes<BaseMatType, BaseGradType>();
+
+  BaseMatType& iterate = (BaseMatType&) iterateIn;
+
+#ifndef ENS_HAVE_PARAMETER_SERVER
+  (void) f;
+  (void) iterate;
+  throw std::runtime_error("ParameterServerSGD::Optimize(): worker processes "
+      "are not supported on this platform!");
+#else
+  using namespace parameter_server;
+
+  if (batchSize == 0 || numWorkers == 0)
+  {
+    throw std::invalid_argument("ParameterServerSGD::Optimize(): batchSize "
+        "and numWorkers must be greater than 0!");
+  }
+
+  if (!(workerTimeout > 0.0))
+  {
+    throw std::invalid_argument("ParameterServerSGD::Optimize(): "
+        "workerTimeout must be positive!");
+  }
+
+  const size_t numFunctions = f.NumFunctions();
+
+  // Start the worker processes.  Each worker receives a copy of the function
+  // at fork() time.
+  WorkerPool pool;
+  for (size_t w = 0; w < numWorkers; ++w)
+  {
+    int sockets[2];
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0)
+    {
+      throw std::runtime_error("ParameterServerSGD::Optimize(): socketpair() "
+          "failed!");
+    }
+
+    #if !defined(MSG_NOSIGNAL) && defined(SO_NOSIGPIPE)
+      // Make sure a failed worker can't kill the server with SIGPIPE.
+      const int noSigPipe = 1;
+      ::setsockopt(sockets[0], SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe,
+          sizeof(noSigPipe));
+      ::setsockopt(sockets[1], SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe,
+          sizeof(noSigPipe));
+    #endif
+
+    const pid_t pid = ::fork();
+    if (pid < 0)
+    {
+      ::close(sockets[0]);
+      ::close(sockets[1]);
+      throw std::runtime_error("ParameterServerSGD::Optimize(): fork() "
+          "failed!");
+    }
+
+    if (pid == 0)
+    {
+      // This is the worker process; it doesn't need any of the server's
+      // sockets.
+      ::close(sockets[0]);
+      for (size_t i = 0; i < pool.Size(); ++i)
+        ::close(pool.Socket(i));
+
+      #ifdef ENS_USE_OPENMP
+        // Only the forking thread exists in the child, and the OpenMP runtime
+        // can't be relied on to start a new thread pool; see the class
+        // documentation.
+        omp_set_num_threads(1);
+      #endif
+
+      int status = 0;
+      try
+      {
+        RunWorker<FullFunctionType, BaseMatType, BaseGradType>(f, sockets[1],
+            iterate.n_rows, iterate.n_cols);
+      }
+      catch (...)
+      {
+        status = 1;
+      }
+
+      // Skip destructors and atexit() handlers that belong to the server.
+      ::_exit(status);
+    }
+
+    ::close(sockets[1]);
+    pool.Add(sockets[0], pid);
+  }
+
+  // Instantiate the update and decay policies on the server.
+  InstUpdatePolicyType instUpdatePolicy(updatePolicy, iterate.n_rows,
+      iterate.n_cols);
+  InstDecayPolicyType instDecayPolicy(decayPolicy);
+
+  // The mini-batch each worker is currently working on.
+  typedef std::chrono::steady_clock Clock;
+  std::vector<bool> busy(numWorkers, false);
+  std::vector<size_t> batchBegin(numWorkers), batchSizes(numWorkers);
+  std::vector<size_t> batchSequence(numWorkers);
+  std::vector<Clock::time_point> batchDeadline(numWorkers);
+  size_t sequence = 0;
+  const Clock::duration timeout = std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double>(workerTimeout));
+  // How long to block in poll() before checking on the busy workers.
+  const int pollInterval = 100;
+  // Mini-batches of failed workers that still have to be computed.
+  std::deque<std::pair<size_t, size_t>> pending;
+
+  // To keep track of where we are and how things are going.
+  size_t nextFunction = 0;
+  size_t issued = 0;
+  size_t completed = 0;
+  size_t epoch = 1;
+  ElemType overallObjective = 0;
+  ElemType lastObjective = DBL_MAX;
+
+  // Controls early termination of the optimization process.
+  bool terminate = false;
+
+  BaseGradType gradient(iterate.n_rows, iterate.n_cols);
+  std::vector<pollfd> pollFds;
+  std::vector<size_t> pollWorkers;
+  const size_t actualMaxIterations = (maxIterations == 0) ?
+      std::numeric_limits<size_t>::max() : maxIterations;
+  Callback::BeginOptimization(*this, f, iterate, callbacks...);
+  terminate |= Callback::BeginEpoch(*this, f, iterate, epoch,
+      overallObjective, callbacks...);
+  while (!terminate)
+  {
+    // Hand out the next mini-batches, along with the current parameters, to
+    // the idle workers.  Work of failed workers is handed out first.
+    for (size_t w = 0; w < numWorkers; ++w)
+    {
+      if (!pool.Alive(w) || busy[w])
+        continue;
+
+      size_t begin, size;
+      if (!pending.empty())
+      {
+        begin = pending.front().first;
+        size = pending.front().second;
+        pending.pop_front();
+      }
+      else if (nextFunction < numFunctions && issued < actualMaxIterations)
+      {
+        begin = nextFunction;
+        size = std::min(std::min(batchSize, numFunctions - nextFunction),
+            actualMaxIterations - issued);
+        nextFunction += size;
+        issued += size;
+      }
+      else
+      {
+        break;
+      }
+
+      const uint64_t header[3] = { computeCommand, begin, size };
+      if (WriteAll(pool.Socket(w), header, sizeof(header)) &&
+          WriteAll(pool.Socket(w), iterate.memptr(),
+              sizeof(ElemType) * iterate.n_elem))
+      {
+        busy[w] = true;
+        batchBegin[w] = begin;
+        batchSizes[w] = size;
+        batchSequence[w] = sequence++;
+        batchDeadline[w] = Clock::now() + timeout;
+      }
+      else
+      {
+        Warn << "ParameterServerSGD: lost worker " << w << "; reassigning its "
+            << "mini-batch." << std::endl;
+        pool.Drop(w);
+        pending.emplace_back(begin, size);
+      }
+    }
+
+    pollFds.clear();
+    pollWorkers.clear();
+    for (size_t w = 0; w < numWorkers; ++w)
+    {
+      if (pool.Alive(w) && busy[w])
+      {
+        pollfd p;
+        p.fd = pool.Socket(w);
+        p.events = POLLIN;
+        p.revents = 0;
+        pollFds.push_back(p);
+        pollWorkers.push_back(w);
+      }
+    }
+
+    #ifdef ENS_DETERMINISTIC
+      // Only wait for the oldest outstanding mini-batch, so that gradients are
+      // applied in the order they were handed out, no matter which worker
+      // finishes first.
+      for (size_t p = 1; p < pollWorkers.size(); ++p)
+      {
+        if (batchSequence[pollWorkers[p]] < batchSequence[pollWorkers[0]])
+        {
+          pollFds[0] = pollFds[p];
+          pollWorkers[0] = pollWorkers[p];
+        }
+      }
+      pollFds.resize(std::min(pollFds.size(), (size_t) 1));
+      pollWorkers.resize(pollFds.size());
+    #endif
+
+    if (pollFds.empty())
+    {
+      bool anyAlive = false;
+      for (size_t w = 0; w < numWorkers; ++w)
+        anyAlive |= pool.Alive(w);
+
+      if (!anyAlive)
+      {
+        throw std::runtime_error("ParameterServerSGD::Optimize(): all worker "
+            "processes failed!");
+      }
+
+      // Nothing is left to hand out: the maximum number of iterations has been
+      // reached.
+      break;
+    }
+
+    // Never block indefinitely: a worker may hang, or die without its socket
+    // being closed.
+    if (::poll(pollFds.data(), pollFds.size(), pollInterval) < 0)
+    {
+      if (errno != EINTR)
+      {
+        throw std::runtime_error("ParameterServerSGD::Optimize(): poll() "
+            "failed!");
+      }
+
+      for (size_t p = 0; p < pollFds.size(); ++p)
+        pollFds[p].revents = 0;
+    }
+
+    // Check on the workers we are waiting for that have nothing to report.  A
+    // worker that has exited, or that has exceeded its time limit, is lost.
+    const Clock::time_point now = Clock::now();
+    for (size_t p = 0; p < pollFds.size(); ++p)
+    {
+      const size_t w = pollWorkers[p];
+      if (pollFds[p].revents != 0)
+        continue;
+
+      const bool exited = pool.Exited(w);
+      if (!exited && now < batchDeadline[w])
+        continue;
+
+      Warn << "ParameterServerSGD: lost worker " << w << " ("
+          << (exited ? "process exited" : "timed out") << "); reassigning its "
+          << "mini-batch." << std::endl;
+      busy[w] = false;
+      pool.Drop(w);
+      pending.emplace_back(batchBegin[w], batchSizes[w]);
+    }
+
+    // Apply the gradients of every worker that has finished, in the order they
+    // are found.
+    for (size_t p = 0; p < pollFds.size() && !terminate; ++p)
+    {
+      if (pollFds[p].revents == 0)
+        continue;
+
+      const size_t w = pollWorkers[p];
+      busy[w] = false;
+
+      ElemType objective;
+      if (!ReadAll(pool.Socket(w), &objective, sizeof(ElemType)) ||
+          !ReadAll(pool.Socket(w), gradient.memptr(),
+              sizeof(ElemType) * gradient.n_elem))
+      {
+        Warn << "ParameterServerSGD: lost worker " << w << "; reassigning its "
+            << "mini-batch." << std::endl;
+        pool.Drop(w);
+        pending.emplace_back(batchBegin[w], batchSizes[w]);
+        continue;
+      }
+
+      overallObjective += objective;
+
+      terminate |= Callback::EvaluateWithGradient(*this, f, iterate, objective,
+          gradient, callbacks...);
+
+      // Use the update policy to take a step.
+      instUpdatePolicy.Update(iterate, stepSize, gradient);
+
+      terminate |= Callback::StepTaken(*this, f, iterate, callbacks...);
+
+      // Now update the learning rate if requested by the user.
+      instDecayPolicy.Update(iterate, stepSize, gradient);
+
+      completed += batchSizes[w];
+      if (completed == numFunctions)
+      {
+        terminate |= Callback::EndEpoch(*this, f, iterate, epoch++,
+            overallObjective / (ElemType) numFunctions, callbacks...);
+
+        // Output current objective function.
+        Info << "ParameterServerSGD: iteration " << issued << ", objective "
+            << overallObjective << "." << std::endl;
+
+        if (std::isnan(overallObjective) || std::isinf(overallObjective))
+        {
+          Warn << "ParameterServerSGD: converged to " << overallObjective
+              << "; terminating with failure.  Try a smaller step size?"
+              << std::endl;
+
+          Callback::EndOptimization(*this, f, iterate, callbacks...);
+          return overallObjective;
+        }
+
+        if (std::abs(lastObjective - overallObjective) < tolerance)
+        {
+          Info << "ParameterServerSGD: minimized within tolerance "
+              << tolerance << "; terminating optimization." << std::endl;
+
+          Callback::EndOptimization(*this, f, iterate, callbacks...);
+          return overallObjective;
+        }
+
+        terminate |= Callback::BeginEpoch(*this, f, iterate, epoch,
+            overallObjective, callbacks...);
+
+        // Reset the counter variables.
+        lastObjective = overallObjective;
+        overallObjective = 0;
+        completed = 0;
+        nextFunction = 0;
+      }
+    }
+  }
+
+  if (!terminate)
+  {
+    Info << "ParameterServerSGD: maximum iterations (" << maxIterations
+        << ") reached; terminating optimization." << std::endl;
+  }
+
+  Callback::EndOptimization(*this, f, iterate, callbacks...);
+  return overallObjective;
+#endif
+}
+
+} // namespace ens
+
+#endif
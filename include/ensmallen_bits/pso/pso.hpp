@@ -86,6 +86,8 @@ class PSOType
    * @param explorationFactor Influence of the neighbours of the particle.
    * @param velocityUpdatePolicy Velocity update policy.
    * @param initPolicy Particle initialization policy.
+   * @param numThreads Number of threads the swarm is spread over in each
+   *     iteration (0 means all available); see ens::EvaluateBatch().
    */
   PSOType(const size_t numParticles = 64,
           const arma::mat& lowerBound = arma::ones(1, 1),
@@ -97,7 +99,8 @@ class PSOType
           const double explorationFactor = 2.05,
           const VelocityUpdatePolicy& velocityUpdatePolicy =
               VelocityUpdatePolicy(),
-          const InitPolicy& initPolicy = InitPolicy()) :
+          const InitPolicy& initPolicy = InitPolicy(),
+          const size_t numThreads = 1) :
           numParticles(numParticles),
           lowerBound(lowerBound),
           upperBound(upperBound),
@@ -107,7 +110,8 @@ class PSOType
           exploitationFactor(exploitationFactor),
           explorationFactor(explorationFactor),
           velocityUpdatePolicy(velocityUpdatePolicy),
-          initPolicy(initPolicy)
+          initPolicy(initPolicy),
+          numThreads(numThreads)
   { /* Nothing to do. */ }
 
   /**
@@ -132,6 +136,10 @@ class PSOType
    * @param impTolerance Improvement threshold for termination.
    * @param exploitationFactor Influence of the personal best of the particle.
    * @param explorationFactor Influence of the neighbours of the particle.
+   * @param velocityUpdatePolicy Velocity update policy.
+   * @param initPolicy Particle initialization policy.
+   * @param numThreads Number of threads used to evaluate the particles (0
+   *     means all available).
    */
   PSOType(const size_t numParticles,
           const double lowerBound,
@@ -143,7 +151,8 @@ class PSOType
           const double explorationFactor = 2.05,
           const VelocityUpdatePolicy& velocityUpdatePolicy =
               VelocityUpdatePolicy(),
-          const InitPolicy& initPolicy = InitPolicy()) :
+          const InitPolicy& initPolicy = InitPolicy(),
+          const size_t numThreads = 1) :
           numParticles(numParticles),
           lowerBound(lowerBound * arma::ones(1, 1)),
           upperBound(upperBound * arma::ones(1, 1)),
@@ -153,7 +162,8 @@ class PSOType
           exploitationFactor(exploitationFactor),
           explorationFactor(explorationFactor),
           velocityUpdatePolicy(velocityUpdatePolicy),
-          initPolicy(initPolicy)
+          initPolicy(initPolicy),
+          numThreads(numThreads)
   { /* Nothing to do. */ }
 
   /**
@@ -217,6 +227,11 @@ class PSOType
   //! Modify value of explorationFactor.
   double& ExplorationFactor() { return explorationFactor; }
 
+  //! Get the number of threads used to evaluate the particles.
+  size_t NumThreads() const { return numThreads; }
+  //! Modify the number of threads used to evaluate the particles.
+  size_t& NumThreads() { return numThreads; }
+
   //! Get the update policy.
   const VelocityUpdatePolicy& UpdatePolicy() const
   {
@@ -262,6 +277,9 @@ class PSOType
   //! Particle initialization policy used.
   InitPolicy initPolicy;
 
+  //! Number of threads used to evaluate the particles.
+  size_t numThreads;
+
   //! The initialized update policy.
   Any instUpdatePolicy;
 };
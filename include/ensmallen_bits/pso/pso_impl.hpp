@@ -102,14 +102,26 @@ typename MatType::elem_type PSOType<VelocityUpdatePolicy, InitPolicy>::Optimize(
 
   Callback::BeginOptimization(*this, function, iterate, callbacks...);
 
+  // The slices of the swarm cubes are contiguous, so each cube can be used as
+  // a matrix that holds one particle per column.  This allows the whole swarm
+  // to be evaluated at once and the personal bests to be updated with
+  // whole-matrix operations.
+  const size_t numElem = particlePositions.n_rows * particlePositions.n_cols;
+  const arma::Mat<ElemType> positions(particlePositions.memptr(), numElem,
+      numParticles, false, true);
+  arma::Mat<ElemType> bestPositions(particleBestPositions.memptr(), numElem,
+      numParticles, false, true);
+  arma::Row<ElemType> fitnesses(numParticles);
+
   // Calculate initial fitness of population.
+  EvaluateBatch(function, positions, iterate.n_rows, iterate.n_cols, fitnesses,
+      numThreads);
+  particleFitnesses = fitnesses.t();
+  particleBestFitnesses = particleFitnesses;
   for (size_t i = 0; (i < numParticles) && !terminate; i++)
   {
-    // Calculate fitness value.
-    particleFitnesses(i) = function.Evaluate(particlePositions.slice(i));
     terminate |= Callback::Evaluate(*this, function,
         particlePositions.slice(i), particleFitnesses(i), callbacks...);
-    particleBestFitnesses(i) = particleFitnesses(i);
   }
 
   // Declare queue to keep track of improvements over a number of iterations.
@@ -125,73 +137,34 @@ typename MatType::elem_type PSOType<VelocityUpdatePolicy, InitPolicy>::Optimize(
   // in the PSO method.
   // The performanceHorizon will be updated with the best particle
   // in a FIFO manner.
-  for (size_t i = 0; (i < horizonSize) && !terminate; i++)
-  {
-    // Calculate fitness and evaluate personal best.
-    for (size_t j = 0; (j < numParticles) && !terminate; j++)
-    {
-      particleFitnesses(j) = function.Evaluate(particlePositions.slice(j));
-      terminate |= Callback::Evaluate(*this, function,
-          particlePositions.slice(j), particleFitnesses(j), callbacks...);
-      if (terminate)
-        break;
-
-      // Compare and copy fitness and position to particle best.
-      if (particleFitnesses(j) < particleBestFitnesses(j))
-      {
-        particleBestFitnesses(j) = particleFitnesses(j);
-        particleBestPositions.slice(j) = particlePositions.slice(j);
-      }
-    }
-
-    // Evaluate local best and update velocity.
-    instUpdatePolicy.As<InstUpdatePolicyType>().Update(
-        particlePositions, particleVelocities, particleBestPositions,
-        particleBestFitnesses);
-
-    // In-place update of particle positions.
-    particlePositions += particleVelocities;
-
-    // Find the best particle.
-    for (size_t j = 0; j < numParticles; j++)
-    {
-      if (particleBestFitnesses(j) < bestFitness)
-      {
-        bestParticle = j;
-        bestFitness = particleBestFitnesses(bestParticle);
-      }
-    }
-
-    terminate |= Callback::StepTaken(*this, function,
-        particleBestPositions.slice(bestParticle), callbacks...);
-
-    // Append bestFitness to performanceHorizon.
-    performanceHorizon.push(bestFitness);
-  }
-
-  // Run the remaining iterations of PSO.
-  for (size_t i = 0; (i < maxIterations - horizonSize) && !terminate; i++)
+  // After that, run the remaining iterations of PSO.
+  for (size_t i = 0; (i < maxIterations) && !terminate; i++)
   {
     // Check if there is any improvement over the horizon.
     // If there is no significant improvement, terminate.
-    if (performanceHorizon.front() - performanceHorizon.back() < impTolerance)
+    if (i >= horizonSize && !performanceHorizon.empty() &&
+        performanceHorizon.front() - performanceHorizon.back() < impTolerance)
       break;
 
-    // Calculate fitness and evaluate personal best.
-    for (size_t j = 0; (j < numParticles) && !terminate; j++)
+    // Calculate fitness of the whole swarm.
+    EvaluateBatch(function, positions, iterate.n_rows, iterate.n_cols,
+        fitnesses, numThreads);
+    particleFitnesses = fitnesses.t();
+    for (size_t j = 0; j < numParticles; j++)
     {
-      particleFitnesses(j) = function.Evaluate(particlePositions.slice(j));
       terminate |= Callback::Evaluate(*this, function,
           particlePositions.slice(j), particleFitnesses(j), callbacks...);
-
-      // Compare and copy fitness and position to particle best.
-      if (particleFitnesses(j) < particleBestFitnesses(j))
-      {
-        particleBestFitnesses(j) = particleFitnesses(j);
-        particleBestPositions.slice(j) = particlePositions.slice(j);
-      }
     }
 
+    if (terminate)
+      break;
+
+    // Compare and copy fitness and position to particle best.
+    const arma::uvec improved = arma::find(particleFitnesses <
+        particleBestFitnesses);
+    particleBestFitnesses.elem(improved) = particleFitnesses.elem(improved);
+    bestPositions.cols(improved) = positions.cols(improved);
+
     // Evaluate local best and update velocity.
     instUpdatePolicy.As<InstUpdatePolicyType>().Update(
         particlePositions, particleVelocities, particleBestPositions,
@@ -201,22 +174,21 @@ typename MatType::elem_type PSOType<VelocityUpdatePolicy, InitPolicy>::Optimize(
     particlePositions += particleVelocities;
 
     // Find the best particle.
-    for (size_t j = 0; j < numParticles; j++)
+    const size_t bestCandidate = particleBestFitnesses.index_min();
+    if (particleBestFitnesses(bestCandidate) < bestFitness)
     {
-      if (particleBestFitnesses(j) < bestFitness)
-      {
-        bestParticle = j;
-        bestFitness = particleBestFitnesses(bestParticle);
-      }
+      bestParticle = bestCandidate;
+      bestFitness = particleBestFitnesses(bestParticle);
     }
 
     terminate |= Callback::StepTaken(*this, function,
         particleBestPositions.slice(bestParticle), callbacks...);
 
-    // Pop the oldest value from performanceHorizon.
-    performanceHorizon.pop();
-    // Push most recent bestFitness to performanceHorizon.
+    // Push the most recent bestFitness to performanceHorizon, and pop the
+    // oldest value once the horizon is full.
     performanceHorizon.push(bestFitness);
+    if (performanceHorizon.size() > horizonSize)
+      performanceHorizon.pop();
   }
 
   // Copy results back.
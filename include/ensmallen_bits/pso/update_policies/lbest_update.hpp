@@ -105,19 +105,20 @@ class LBestUpdate
        chi = 2.0 / std::abs(2.0 - phi - std::sqrt((phi - 4.0) * phi));
 
        // Initialize local best indices to self indices of particles.
-       localBestIndices = arma::linspace<
-           arma::Col<typename MatType::elem_type> >(0, n-1, n);
+       localBestIndices = arma::linspace<arma::uvec>(0, n - 1, n);
 
-       // Set sizes r1 and r2.
-       r1.set_size(iterate.n_rows, iterate.n_cols);
-       r2.set_size(iterate.n_rows, iterate.n_cols);
+       // Set sizes r1 and r2; they hold the random numbers of the whole swarm,
+       // one particle per column.
+       r1.set_size(iterate.n_elem, n);
+       r2.set_size(iterate.n_elem, n);
      }
 
      /**
       * Update step for LBestPSO. Compares personal best of each particle with
       * that of its neighbours, and sets the best of the 3 as the lobal best.
       * This particle is then used for calculating the velocity for the update
-      * step.
+      * step.  The velocities of the whole swarm are updated at once, treating
+      * each cube as a matrix with one particle per column.
       *
       * @param particlePositions The current coordinates of particles.
       * @param particleVelocities The current velocities (will be modified).
@@ -142,17 +143,22 @@ class LBestUpdate
              right(i) : i;
        }
 
-       for (size_t i = 0; i < n; i++)
-       {
-         // Generate random numbers for current particle.
-         r1.randu();
-         r2.randu();
-         particleVelocities.slice(i) = chi * (particleVelocities.slice(i) +
-             c1 * r1 % (particleBestPositions.slice(i) -
-             particlePositions.slice(i)) + c2 * r2 %
-             (particleBestPositions.slice(localBestIndices(i)) -
-             particlePositions.slice(i)));
-       }
+       typedef typename MatType::elem_type ElemType;
+       const size_t numElem = particlePositions.n_rows *
+           particlePositions.n_cols;
+       const arma::Mat<ElemType> positions(particlePositions.memptr(), numElem,
+           n, false, true);
+       const arma::Mat<ElemType> bestPositions(
+           particleBestPositions.memptr(), numElem, n, false, true);
+       arma::Mat<ElemType> velocities(particleVelocities.memptr(), numElem, n,
+           false, true);
+
+       // Generate random numbers for all particles.
+       r1.randu();
+       r2.randu();
+       velocities = chi * (velocities +
+           c1 * r1 % (bestPositions - positions) +
+           c2 * r2 % (bestPositions.cols(localBestIndices) - positions));
      }
 
     private:
@@ -169,10 +175,10 @@ class LBestUpdate
      typename MatType::elem_type chi;
 
      //! Vectors of random numbers.
-     MatType r1, r2;
+     arma::Mat<typename MatType::elem_type> r1, r2;
 
      //! Indices of each particle's best neighbour.
-     arma::Col<typename MatType::elem_type> localBestIndices;
+     arma::uvec localBestIndices;
 
      // Helper functions for calculating neighbours.
     inline size_t left(size_t index) { return (index + n - 1) % n; }
@@ -124,27 +124,73 @@ class QHAdamUpdate
       // Increment the iteration counter variable.
       ++iteration;
 
-      // And update the iterate.
+      const double biasCorrection1 = 1.0 - std::pow(parent.beta1, iteration);
+      const double biasCorrection2 = 1.0 - std::pow(parent.beta2, iteration);
+
+      // QHAdam recovers Adam when v2 = v1 = 1.
+      Step(iterate, gradient, stepSize, biasCorrection1, biasCorrection2);
+    }
+
+   private:
+    //! Update the moments and take a step.
+    template<typename IterateType, typename GType>
+    void Step(IterateType& iterate,
+              const GType& gradient,
+              const double stepSize,
+              const double biasCorrection1,
+              const double biasCorrection2)
+    {
       m *= parent.beta1;
       m += (1 - parent.beta1) * gradient;
 
       v *= parent.beta2;
       v += (1 - parent.beta2) * (gradient % gradient);
 
-      const double biasCorrection1 = 1.0 - std::pow(parent.beta1, iteration);
-      const double biasCorrection2 = 1.0 - std::pow(parent.beta2, iteration);
-
       GradType mDash = m / biasCorrection1;
       GradType vDash = v / biasCorrection2;
 
-      // QHAdam recovers Adam when v2 = v1 = 1.
       iterate -= stepSize *
           ((((1 - parent.v1) * gradient) + parent.v1 * mDash) /
            (arma::sqrt(((1 - parent.v2) * (gradient % gradient)) +
             parent.v2 * vDash) + parent.epsilon));
     }
 
-   private:
+    //! Dense version of Step(): update the moments and the iterate in a single
+    //! pass over the memory.
+    template<typename eT>
+    void Step(arma::Mat<eT>& iterate,
+              const arma::Mat<eT>& gradient,
+              const double stepSize,
+              const double biasCorrection1,
+              const double biasCorrection2)
+    {
+      const eT beta1 = parent.beta1;
+      const eT beta2 = parent.beta2;
+      const eT v1 = parent.v1;
+      const eT v2 = parent.v2;
+      const eT epsilon = parent.epsilon;
+      const eT a = stepSize;
+      const eT bc1 = biasCorrection1;
+      const eT bc2 = biasCorrection2;
+
+      eT* x = iterate.memptr();
+      eT* mMem = m.memptr();
+      eT* vMem = v.memptr();
+      const eT* g = gradient.memptr();
+
+      const size_t n = iterate.n_elem;
+      ENS_PRAGMA_OMP_SIMD
+      for (size_t i = 0; i < n; ++i)
+      {
+        const eT gSquared = g[i] * g[i];
+        mMem[i] = beta1 * mMem[i] + (1 - beta1) * g[i];
+        vMem[i] = beta2 * vMem[i] + (1 - beta2) * gSquared;
+        x[i] -= a * (((1 - v1) * g[i] + v1 * (mMem[i] / bc1)) /
+            (std::sqrt((1 - v2) * gSquared + v2 * (vMem[i] / bc2)) +
+            epsilon));
+      }
+    }
+
     //! Instantiated parent object.
     QHAdamUpdate& parent;
 
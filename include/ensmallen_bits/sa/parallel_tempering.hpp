@@ -0,0 +1,193 @@
+/**
+ * @file parallel_tempering.hpp
+ *
+ * Parallel tempering (replica exchange) built on top of Simulated Annealing.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_SA_PARALLEL_TEMPERING_HPP
+#define ENSMALLEN_SA_PARALLEL_TEMPERING_HPP
+
+#include "sa.hpp"
+
+namespace ens {
+
+/**
+ * Parallel tempering (also known as replica exchange) runs several simulated
+ * annealing chains, the replicas, at a ladder of temperatures.  Every replica
+ * is a copy of the given SA optimizer: it uses the same cooling schedule and
+ * the same feedback move control, but the initial temperature of replica k is
+ *
+ *   T_k = T_0 * maxTemperatureRatio^(k / (numReplicas - 1)),
+ *
+ * where T_0 is the initial temperature of the given SA optimizer.  The
+ * replicas run exchangeInterval moves independently (on separate threads if
+ * numThreads is not 1), then neighbouring replicas i and i + 1 swap their
+ * states with probability
+ *
+ *   min{1, exp((E_i - E_{i + 1}) * (1 / T_i - 1 / T_{i + 1}))}.
+ *
+ * Good states found by the hot replicas, which cross energy barriers easily,
+ * thus migrate down to the cold replicas, which refine them.  This makes the
+ * search much less likely to get stuck in local minima of rugged functions.
+ *
+ * The optimization ends when the coldest replica is frozen (see SA), or when
+ * every replica made the maximum number of iterations of the SA optimizer.
+ * The best state seen at an exchange step is returned.
+ *
+ * For more information, see the following.
+ *
+ * @code
+ * @article{Earl2005,
+ *   author  = {David J. Earl and Michael W. Deem},
+ *   title   = {Parallel tempering: Theory, applications, and new
+ *              perspectives},
+ *   journal = {Physical Chemistry Chemical Physics},
+ *   volume  = {7},
+ *   number  = {23},
+ *   pages   = {3910--3916},
+ *   year    = {2005}
+ * }
+ * @endcode
+ *
+ * ParallelTempering can optimize arbitrary functions.  For more details, see
+ * the documentation on function types included with this distribution or on
+ * the ensmallen website.
+ *
+ * @tparam CoolingScheduleType Type of the cooling schedule of the replicas.
+ */
+template<typename CoolingScheduleType = ExponentialSchedule>
+class ParallelTempering
+{
+ public:
+  /**
+   * Construct the ParallelTempering optimizer with the given parameters.
+   *
+   * @param replica SA optimizer that every replica is a copy of.
+   * @param numReplicas Number of replicas.
+   * @param maxTemperatureRatio Ratio between the initial temperatures of the
+   *     hottest and the coldest replica.
+   * @param exchangeInterval Number of moves of every replica between two
+   *     exchange steps.
+   * @param numThreads Number of threads used to run the replicas (0 means all
+   *     available).  Values other than 1 require the function's Evaluate() to
+   *     be thread-safe.
+   */
+  ParallelTempering(
+      const SA<CoolingScheduleType>& replica = SA<CoolingScheduleType>(),
+      const size_t numReplicas = 8,
+      const double maxTemperatureRatio = 100.0,
+      const size_t exchangeInterval = 1000,
+      const size_t numThreads = 1);
+
+  /**
+   * Optimize the given function using parallel tempering.  The given starting
+   * point will be modified to store the finishing point of the algorithm, and
+   * the final objective value is returned.
+   *
+   * @tparam FunctionType Type of function to optimize.
+   * @tparam MatType Type of objective matrix.
+   * @tparam CallbackTypes Types of callback functions.
+   * @param function Function to optimize.
+   * @param iterate Starting point (will be modified).
+   * @param callbacks Callback functions.
+   * @return Objective value of the final point.
+   */
+  template<typename FunctionType, typename MatType, typename... CallbackTypes>
+  typename MatType::elem_type Optimize(FunctionType& function,
+                                       MatType& iterate,
+                                       CallbackTypes&&... callbacks);
+
+  //! Get the SA optimizer that every replica is a copy of.
+  const SA<CoolingScheduleType>& Replica() const { return replica; }
+  //! Modify the SA optimizer that every replica is a copy of.
+  SA<CoolingScheduleType>& Replica() { return replica; }
+
+  //! Get the number of replicas.
+  size_t NumReplicas() const { return numReplicas; }
+  //! Modify the number of replicas.
+  size_t& NumReplicas() { return numReplicas; }
+
+  //! Get the ratio between the hottest and the coldest initial temperature.
+  double MaxTemperatureRatio() const { return maxTemperatureRatio; }
+  //! Modify the ratio between the hottest and the coldest initial temperature.
+  double& MaxTemperatureRatio() { return maxTemperatureRatio; }
+
+  //! Get the number of moves between two exchange steps.
+  size_t ExchangeInterval() const { return exchangeInterval; }
+  //! Modify the number of moves between two exchange steps.
+  size_t& ExchangeInterval() { return exchangeInterval; }
+
+  //! Get the number of threads used to run the replicas.
+  size_t NumThreads() const { return numThreads; }
+  //! Modify the number of threads used to run the replicas.
+  size_t& NumThreads() { return numThreads; }
+
+  //! Get the number of accepted exchanges of the last optimization.
+  size_t AcceptedExchanges() const { return acceptedExchanges; }
+
+  //! Get the random number engine.
+  const RandomEngine& Engine() const { return engine; }
+  //! Modify the random number engine.
+  RandomEngine& Engine() { return engine; }
+
+ private:
+  //! The state of the Markov chain of a replica.
+  template<typename MatType>
+  struct ReplicaState
+  {
+    //! The current state.
+    MatType iterate;
+    //! The energy of the current state.
+    typename MatType::elem_type energy;
+    //! Accepted moves of every parameter since the last move control.
+    MatType accept;
+    //! The move size of every parameter.
+    MatType moveSize;
+    //! The next parameter to move.
+    size_t idx;
+    //! The number of sweeps since the last move control.
+    size_t sweepCounter;
+    //! The number of consecutive moves that changed the energy less than the
+    //! tolerance.
+    size_t frozenCount;
+    //! The number of moves made so far.
+    size_t moves;
+  };
+
+  /**
+   * Run the given number of moves of a replica.  The first InitMoves() moves
+   * are made at the initial temperature; the replica is cooled after every
+   * following move.
+   */
+  template<typename FunctionType, typename MatType>
+  void Run(FunctionType& function,
+           SA<CoolingScheduleType>& sa,
+           ReplicaState<MatType>& state,
+           const size_t numMoves);
+
+  //! The source of random numbers.
+  RandomEngine engine;
+
+  //! The SA optimizer that every replica is a copy of.
+  SA<CoolingScheduleType> replica;
+  //! The number of replicas.
+  size_t numReplicas;
+  //! The ratio between the hottest and the coldest initial temperature.
+  double maxTemperatureRatio;
+  //! The number of moves between two exchange steps.
+  size_t exchangeInterval;
+  //! The number of threads used to run the replicas.
+  size_t numThreads;
+  //! The number of accepted exchanges of the last optimization.
+  size_t acceptedExchanges;
+};
+
+} // namespace ens
+
+#include "parallel_tempering_impl.hpp"
+
+#endif
@@ -0,0 +1,216 @@
+/**
+ * @file parallel_tempering_impl.hpp
+ *
+ * The implementation of the parallel tempering optimizer.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_SA_PARALLEL_TEMPERING_IMPL_HPP
+#define ENSMALLEN_SA_PARALLEL_TEMPERING_IMPL_HPP
+
+#include <ensmallen_bits/function.hpp>
+
+namespace ens {
+
+template<typename CoolingScheduleType>
+ParallelTempering<CoolingScheduleType>::ParallelTempering(
+    const SA<CoolingScheduleType>& replica,
+    const size_t numReplicas,
+    const double maxTemperatureRatio,
+    const size_t exchangeInterval,
+    const size_t numThreads) :
+    replica(replica),
+    numReplicas(numReplicas),
+    maxTemperatureRatio(maxTemperatureRatio),
+    exchangeInterval(exchangeInterval),
+    numThreads(numThreads),
+    acceptedExchanges(0)
+{
+  // Nothing to do.
+}
+
+//! Optimize the function (minimize).
+template<typename CoolingScheduleType>
+template<typename FunctionType, typename MatType, typename... CallbackTypes>
+typename MatType::elem_type ParallelTempering<CoolingScheduleType>::Optimize(
+    FunctionType& function,
+    MatType& iterateIn,
+    CallbackTypes&&... callbacks)
+{
+  // Convenience typedefs.
+  typedef typename MatType::elem_type ElemType;
+  typedef typename MatTypeTraits<MatType>::BaseMatType BaseMatType;
+
+  // Make sure we have the methods that we need.
+  traits::CheckArbitraryFunctionTypeAPI<FunctionType, BaseMatType>();
+  RequireFloatingPointType<BaseMatType>();
+
+  if (numReplicas == 0)
+  {
+    throw std::invalid_argument("ParallelTempering::Optimize(): the number of "
+        "replicas must be positive");
+  }
+
+  if (exchangeInterval == 0)
+  {
+    throw std::invalid_argument("ParallelTempering::Optimize(): the exchange "
+        "interval must be positive");
+  }
+
+  BaseMatType& iterate = (BaseMatType&) iterateIn;
+
+  // Controls early termination of the optimization process.
+  bool terminate = false;
+
+  ElemType bestEnergy = function.Evaluate(iterate);
+  terminate |= Callback::Evaluate(*this, function, iterate, bestEnergy,
+      callbacks...);
+
+  // Every replica gets its own random stream, so the result does not depend on
+  // the number of threads.
+  const uint64_t seed = engine.NewSeed();
+  std::vector<SA<CoolingScheduleType>> replicas(numReplicas, replica);
+  std::vector<ReplicaState<BaseMatType>> states(numReplicas);
+  for (size_t k = 0; k < numReplicas; ++k)
+  {
+    const double ratio = (numReplicas == 1) ? 1.0 :
+        std::pow(maxTemperatureRatio, (double) k / (numReplicas - 1));
+    replicas[k].Engine() = RandomEngine::TaskEngine(seed, k);
+    replicas[k].Temperature() = replica.Temperature() * ratio;
+
+    ReplicaState<BaseMatType>& state = states[k];
+    state.iterate = iterate;
+    state.energy = bestEnergy;
+    state.accept.zeros(iterate.n_rows, iterate.n_cols);
+    state.moveSize.set_size(iterate.n_rows, iterate.n_cols);
+    state.moveSize.fill(replica.initMoveCoef);
+    state.idx = 0;
+    state.sweepCounter = 0;
+    state.frozenCount = 0;
+    state.moves = 0;
+  }
+
+  const size_t frozenLimit = replica.MaxToleranceSweep() *
+      replica.MoveCtrlSweep() * iterate.n_elem;
+  acceptedExchanges = 0;
+
+  Callback::BeginOptimization(*this, function, iterate, callbacks...);
+  for (size_t round = 0; !terminate; ++round)
+  {
+    // Run the replicas independently.
+    ParallelFor(numReplicas, numThreads, [&](const size_t k)
+    {
+      Run(function, replicas[k], states[k], exchangeInterval);
+    });
+
+    // Attempt to exchange the states of neighbouring replicas; the pairs
+    // (0, 1), (2, 3), ... and (1, 2), (3, 4), ... alternate.
+    for (size_t k = round % 2; k + 1 < numReplicas; k += 2)
+    {
+      const double delta = (states[k].energy - states[k + 1].energy) *
+          (1.0 / replicas[k].Temperature() -
+           1.0 / replicas[k + 1].Temperature());
+      if (delta >= 0.0 || engine.Uniform() < std::exp(delta))
+      {
+        states[k].iterate.swap(states[k + 1].iterate);
+        std::swap(states[k].energy, states[k + 1].energy);
+        states[k].frozenCount = 0;
+        states[k + 1].frozenCount = 0;
+        ++acceptedExchanges;
+      }
+    }
+
+    // Keep the best state seen so far.
+    bool improved = false;
+    for (size_t k = 0; k < numReplicas; ++k)
+    {
+      if (states[k].energy < bestEnergy)
+      {
+        bestEnergy = states[k].energy;
+        iterate = states[k].iterate;
+        improved = true;
+      }
+    }
+
+    terminate |= Callback::StepTaken(*this, function, iterate, callbacks...);
+    if (improved)
+    {
+      terminate |= Callback::Evaluate(*this, function, iterate, bestEnergy,
+          callbacks...);
+    }
+
+    if (states[0].frozenCount >= frozenLimit)
+    {
+      Info << "ParallelTempering: coldest replica minimized within tolerance "
+          << replica.Tolerance() << " for " << replica.MaxToleranceSweep()
+          << " sweeps after " << (round + 1) << " exchange steps; "
+          << "terminating optimization." << std::endl;
+      break;
+    }
+
+    if (replica.MaxIterations() != 0 &&
+        states[0].moves >= replica.InitMoves() + replica.MaxIterations())
+    {
+      Warn << "ParallelTempering: maximum iterations ("
+          << replica.MaxIterations() << ") reached; terminating optimization."
+          << std::endl;
+      break;
+    }
+  }
+
+  // With EvaluateDelta(), the energies were only updated with the changes of
+  // the moves; evaluate the best state again to remove the rounding error.
+  if (traits::HasEvaluateDeltaSignature<FunctionType, BaseMatType>::value)
+    bestEnergy = function.Evaluate(iterate);
+
+  Callback::EndOptimization(*this, function, iterate, callbacks...);
+  return bestEnergy;
+}
+
+template<typename CoolingScheduleType>
+template<typename FunctionType, typename MatType>
+void ParallelTempering<CoolingScheduleType>::Run(
+    FunctionType& function,
+    SA<CoolingScheduleType>& sa,
+    ReplicaState<MatType>& state,
+    const size_t numMoves)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  for (size_t i = 0; i < numMoves; ++i)
+  {
+    const bool cooling = (state.moves >= sa.InitMoves());
+    if (cooling && sa.MaxIterations() != 0 &&
+        state.moves - sa.InitMoves() >= sa.MaxIterations())
+    {
+      return;
+    }
+
+    // Callbacks are only called from the exchange steps, so that they never
+    // run concurrently.
+    const ElemType oldEnergy = state.energy;
+    (void) sa.GenerateMove(function, state.iterate, state.accept,
+        state.moveSize, state.energy, state.idx, state.sweepCounter);
+    ++state.moves;
+
+    if (!cooling)
+      continue;
+
+    sa.Temperature() = sa.CoolingSchedule().NextTemperature(sa.Temperature(),
+        state.energy);
+
+    // Determine if the replica has entered (or continues to be in) a frozen
+    // state.
+    if (std::abs(state.energy - oldEnergy) < sa.Tolerance())
+      ++state.frozenCount;
+    else
+      state.frozenCount = 0;
+  }
+}
+
+} // namespace ens
+
+#endif
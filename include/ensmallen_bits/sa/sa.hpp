@@ -42,6 +42,19 @@ namespace ens {
  * on function types included with this distribution or on the ensmallen
  * website.
  *
+ * Since every move changes a single parameter, the function may also provide
+ *
+ *   double EvaluateDelta(const arma::mat& coordinates,
+ *                        const size_t i,
+ *                        const double newValue);
+ *
+ * which returns f(x') - f(x), where x = coordinates and x' is x with x(i)
+ * replaced by newValue.  If it exists, it is used instead of Evaluate() for
+ * every move, so that a move can cost much less than a full evaluation for
+ * functions where each parameter only interacts with a few others.  The final
+ * objective is then computed again with Evaluate(), to remove the rounding
+ * error accumulated by the energy updates.
+ *
  * The CoolingScheduleType template parameter must implement the following
  * method:
  *
@@ -142,7 +155,18 @@ class SA
   //! Modify the maximum number of iterations.
   size_t& MaxIterations() { return maxIterations; }
 
+  //! Get the random number engine.
+  const RandomEngine& Engine() const { return engine; }
+  //! Modify the random number engine.
+  RandomEngine& Engine() { return engine; }
+
  private:
+  // ParallelTempering runs copies of the optimizer as replicas.
+  template<typename> friend class ParallelTempering;
+
+  //! The source of random numbers.
+  RandomEngine engine;
+
   //! The cooling schedule being used.
   CoolingScheduleType coolingSchedule;
   //! The maximum number of iterations.
@@ -191,6 +215,53 @@ class SA
                     size_t& sweepCounter,
                     CallbackTypes&... callbacks);
 
+  /**
+   * Finish the optimization: call the EndOptimization() callbacks and return
+   * the energy of the final state.  If the energy was tracked with
+   * EvaluateDelta(), it is computed again with Evaluate().
+   */
+  template<typename FunctionType, typename MatType, typename... CallbackTypes>
+  typename MatType::elem_type FinalEnergy(FunctionType& function,
+                                          MatType& iterate,
+                                          typename MatType::elem_type energy,
+                                          CallbackTypes&... callbacks);
+
+  /**
+   * Set iterate(idx) to newValue and return the energy of the new state, using
+   * the EvaluateDelta() method of the function.
+   */
+  template<typename FunctionType, typename MatType>
+  static typename std::enable_if<traits::HasEvaluateDeltaSignature<
+      FunctionType, MatType>::value, typename MatType::elem_type>::type
+  MoveEnergy(FunctionType& function,
+             MatType& iterate,
+             const size_t idx,
+             const typename MatType::elem_type newValue,
+             const typename MatType::elem_type energy)
+  {
+    const typename MatType::elem_type delta =
+        function.EvaluateDelta(iterate, idx, newValue);
+    iterate(idx) = newValue;
+    return energy + delta;
+  }
+
+  /**
+   * Set iterate(idx) to newValue and return the energy of the new state, using
+   * the Evaluate() method of the function.
+   */
+  template<typename FunctionType, typename MatType>
+  static typename std::enable_if<!traits::HasEvaluateDeltaSignature<
+      FunctionType, MatType>::value, typename MatType::elem_type>::type
+  MoveEnergy(FunctionType& function,
+             MatType& iterate,
+             const size_t idx,
+             const typename MatType::elem_type newValue,
+             const typename MatType::elem_type /* energy */)
+  {
+    iterate(idx) = newValue;
+    return function.Evaluate(iterate);
+  }
+
   /**
    * MoveControl() uses a proportional feedback control to determine the size
    * parameter to pass to the move generation distribution. The target of such
@@ -116,14 +116,29 @@ typename MatType::elem_type SA<CoolingScheduleType>::Optimize(
           << maxToleranceSweep << " sweeps after " << i << " iterations; "
           << "terminating optimization." << std::endl;
 
-      Callback::EndOptimization(*this, function, iterate, callbacks...);
-      return energy;
+      return FinalEnergy(function, iterate, energy, callbacks...);
     }
   }
 
   Warn << "SA: maximum iterations (" << maxIterations << ") reached; "
       << "terminating optimization." << std::endl;
 
+  return FinalEnergy(function, iterate, energy, callbacks...);
+}
+
+template<typename CoolingScheduleType>
+template<typename FunctionType, typename MatType, typename... CallbackTypes>
+typename MatType::elem_type SA<CoolingScheduleType>::FinalEnergy(
+    FunctionType& function,
+    MatType& iterate,
+    typename MatType::elem_type energy,
+    CallbackTypes&... callbacks)
+{
+  // The energy was only updated with the changes of the moves; evaluate it
+  // again to remove the accumulated rounding error.
+  if (traits::HasEvaluateDeltaSignature<FunctionType, MatType>::value)
+    energy = function.Evaluate(iterate);
+
   Callback::EndOptimization(*this, function, iterate, callbacks...);
   return energy;
 }
@@ -158,19 +173,18 @@ bool SA<CoolingScheduleType>::GenerateMove(
   // MoveControl() is derived for the Laplace distribution.
 
   // Sample from a Laplace distribution with scale parameter moveSize(idx).
-  const double unif = 2.0 * arma::randu() - 1.0;
+  const double unif = 2.0 * engine.Uniform() - 1.0;
   const ElemType move = (unif < 0) ? (moveSize(idx) * std::log(1 + unif)) :
       (-moveSize(idx) * std::log(1 - unif));
 
-  iterate(idx) += move;
-  energy = function.Evaluate(iterate);
+  energy = MoveEnergy(function, iterate, idx, prevValue + move, prevEnergy);
 
   const bool terminate = Callback::Evaluate(*this, function, iterate, energy,
       callbacks...);
 
   // According to the Metropolis criterion, accept the move with probability
   // min{1, exp(-(E_new - E_old) / T)}.
-  const double xi = arma::randu();
+  const double xi = engine.Uniform();
   const double delta = energy - prevEnergy;
   const double criterion = std::exp(-delta / temperature);
   if (delta <= 0. || criterion > xi)
@@ -20,6 +20,9 @@
 #include "update_policies/nesterov_momentum_update.hpp"
 #include "decay_policies/no_decay.hpp"
 #include "update_policies/quasi_hyperbolic_update.hpp"
+#include "update_policies/parallel_update.hpp"
+#include "update_policies/lars_update.hpp"
+#include "update_policies/lamb_update.hpp"
 
 namespace ens {
 
@@ -90,6 +93,10 @@ class SGD
    *                    are reset before every Optimize call.
    * @param exactObjective Calculate the exact objective (Default: estimate the
    *        final objective obtained on the last pass over the data).
+   * @param numThreads Number of threads each mini-batch is split across when
+   *        computing the gradient (0 means all available threads).  When
+   *        larger than 1, the function's EvaluateWithGradient() must be safe to
+   *        call concurrently.
    */
   SGD(const double stepSize = 0.01,
       const size_t batchSize = 32,
@@ -99,7 +106,8 @@ class SGD
       const UpdatePolicyType& updatePolicy = UpdatePolicyType(),
       const DecayPolicyType& decayPolicy = DecayPolicyType(),
       const bool resetPolicy = true,
-      const bool exactObjective = false);
+      const bool exactObjective = false,
+      const size_t numThreads = 1);
 
   /**
    * Clean any memory associated with the SGD object.
@@ -173,6 +181,13 @@ class SGD
   //! Modify whether or not the actual objective is calculated.
   bool& ExactObjective() { return exactObjective; }
 
+  //! Get the number of threads used to compute each mini-batch gradient (0
+  //! means all available threads).
+  size_t NumThreads() const { return numThreads; }
+  //! Modify the number of threads used to compute each mini-batch gradient (0
+  //! means all available threads).
+  size_t& NumThreads() { return numThreads; }
+
   //! Get whether or not the update policy parameters
   //! are reset before Optimize call.
   bool ResetPolicy() const { return resetPolicy; }
@@ -224,6 +239,9 @@ class SGD
   //! Controls whether or not the actual Objective value is calculated.
   bool exactObjective;
 
+  //! The number of threads each mini-batch is split across.
+  size_t numThreads;
+
   //! The update policy used to update the parameters in each iteration.
   UpdatePolicyType updatePolicy;
 
@@ -251,6 +269,10 @@ using MomentumSGD = SGD<MomentumUpdate>;
 using NesterovMomentumSGD = SGD<NesterovMomentumUpdate>;
 
 using QHSGD = SGD<QHUpdate>;
+
+using LARS = SGD<LARSUpdate>;
+
+using LAMB = SGD<LAMBUpdate>;
 } // namespace ens
 
 // Include implementation.
@@ -18,6 +18,7 @@
 #include "sgd.hpp"
 
 #include <ensmallen_bits/function.hpp>
+#include <ensmallen_bits/utility/parallel.hpp>
 
 namespace ens {
 
@@ -31,13 +32,15 @@ SGD<UpdatePolicyType, DecayPolicyType>::SGD(
     const UpdatePolicyType& updatePolicy,
     const DecayPolicyType& decayPolicy,
     const bool resetPolicy,
-    const bool exactObjective) :
+    const bool exactObjective,
+    const size_t numThreads) :
     stepSize(stepSize),
     batchSize(batchSize),
     maxIterations(maxIterations),
     tolerance(tolerance),
     shuffle(shuffle),
     exactObjective(exactObjective),
+    numThreads(numThreads),
     updatePolicy(updatePolicy),
     decayPolicy(decayPolicy),
     resetPolicy(resetPolicy),
@@ -122,6 +125,17 @@ SGD<UpdatePolicyType, DecayPolicyType>::Optimize(
 
   // Now iterate!
   BaseGradType gradient(iterate.n_rows, iterate.n_cols);
+
+  // When the mini-batch is split across threads, each shard writes its
+  // objective and gradient into its own buffer; the buffers are then summed
+  // with a pairwise reduction.  The number of shards depends on the number of
+  // available threads (or, in deterministic mode, on nothing at all).
+  const size_t threads = NumThreads(numThreads);
+  const bool shardBatches = (threads > 1);
+  std::vector<BaseGradType> shardGradients(shardBatches ?
+      ReductionShards(threads, batchSize) : 0);
+  std::vector<ElemType> shardObjectives(shardGradients.size());
+
   const size_t actualMaxIterations = (maxIterations == 0) ?
       std::numeric_limits<size_t>::max() : maxIterations;
   Callback::BeginOptimization(*this, f, iterate, callbacks...);
@@ -142,8 +156,30 @@ SGD<UpdatePolicyType, DecayPolicyType>::Optimize(
 
     // Technically we are computing the objective before we take the step, but
     // for many FunctionTypes it may be much quicker to do it like this.
-    const ElemType objective = f.EvaluateWithGradient(iterate, currentFunction,
-        gradient, effectiveBatchSize);
+    ElemType objective;
+    if (shardBatches && effectiveBatchSize > 1)
+    {
+      const size_t shards = ReductionShards(threads, effectiveBatchSize);
+      ParallelFor(shards, threads, [&](const size_t s)
+      {
+        const size_t begin = currentFunction +
+            (s * effectiveBatchSize) / shards;
+        const size_t end = currentFunction +
+            ((s + 1) * effectiveBatchSize) / shards;
+        shardObjectives[s] = f.EvaluateWithGradient(iterate, begin,
+            shardGradients[s], end - begin);
+      });
+
+      TreeReduce(shardGradients, shards);
+      TreeReduce(shardObjectives, shards);
+      gradient = shardGradients[0];
+      objective = shardObjectives[0];
+    }
+    else
+    {
+      objective = f.EvaluateWithGradient(iterate, currentFunction, gradient,
+          effectiveBatchSize);
+    }
     overallObjective += objective;
 
     terminate |= Callback::EvaluateWithGradient(*this, f, iterate, objective,
@@ -0,0 +1,244 @@
+/**
+ * @file lamb_update.hpp
+ *
+ * Layer-wise adaptive moments (LAMB) update for Stochastic Gradient Descent.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_SGD_LAMB_UPDATE_HPP
+#define ENSMALLEN_SGD_LAMB_UPDATE_HPP
+
+#include "parameter_blocks.hpp"
+
+namespace ens {
+
+/**
+ * LAMB combines the Adam update with the layer-wise trust ratios of LARS: the
+ * Adam step (plus weight decay) of every block of parameters (see
+ * ParameterBlocks; e.g. the weights of one layer) is rescaled so that its norm
+ * is the norm of the weights of the block.  For every block b, the following
+ * update is used:
+ *
+ * \f[
+ * m = \beta_1 m + (1 - \beta_1) g
+ * v = \beta_2 v + (1 - \beta_2) g^2
+ * r_b = \frac{\hat{m}_b}{\sqrt{\hat{v}_b} + \epsilon} + \lambda w_b
+ * w_b = w_b - \alpha \frac{\| w_b \|}{\| r_b \|} r_b
+ * \f]
+ *
+ * where \f$ \hat{m} \f$ and \f$ \hat{v} \f$ are the bias-corrected moment
+ * estimates, \f$ \alpha \f$ is the step size and \f$ \lambda \f$ the weight
+ * decay.  If the weights or the step of a block are 0, its trust ratio is 1.
+ * The coordinates and the gradient must be dense matrices.
+ *
+ * For more information, see the following.
+ *
+ * @code
+ * @inproceedings{You2020,
+ *   author    = {Yang You and Jing Li and Sashank Reddi and Jonathan Hseu and
+ *                Sanjiv Kumar and Srinadh Bhojanapalli and Xiaodan Song and
+ *                James Demmel and Kurt Keutzer and Cho-Jui Hsieh},
+ *   title     = {Large Batch Optimization for Deep Learning: Training {BERT}
+ *                in 76 minutes},
+ *   booktitle = {International Conference on Learning Representations},
+ *   year      = {2020}
+ * }
+ * @endcode
+ */
+class LAMBUpdate
+{
+ public:
+  /**
+   * Construct the LAMB update policy with the given parameters.
+   *
+   * @param beta1 Exponential decay rate for the first moment estimates.
+   * @param beta2 Exponential decay rate for the second moment estimates.
+   * @param epsilon Value added to the square root of the second moment
+   *     estimates.
+   * @param weightDecay The weight decay coefficient.
+   * @param blocks The assignment of the parameters to blocks.
+   */
+  LAMBUpdate(const double beta1 = 0.9,
+             const double beta2 = 0.999,
+             const double epsilon = 1e-6,
+             const double weightDecay = 0.0,
+             const ParameterBlocks& blocks = ParameterBlocks()) :
+      beta1(beta1),
+      beta2(beta2),
+      epsilon(epsilon),
+      weightDecay(weightDecay),
+      blocks(blocks)
+  {
+    // Nothing to do.
+  }
+
+  //! Get the smoothing parameter.
+  double Beta1() const { return beta1; }
+  //! Modify the smoothing parameter.
+  double& Beta1() { return beta1; }
+
+  //! Get the second moment coefficient.
+  double Beta2() const { return beta2; }
+  //! Modify the second moment coefficient.
+  double& Beta2() { return beta2; }
+
+  //! Get the value added to the square root of the second moment estimates.
+  double Epsilon() const { return epsilon; }
+  //! Modify the value added to the square root of the second moment
+  //! estimates.
+  double& Epsilon() { return epsilon; }
+
+  //! Get the weight decay.
+  double WeightDecay() const { return weightDecay; }
+  //! Modify the weight decay.
+  double& WeightDecay() { return weightDecay; }
+
+  //! Get the assignment of the parameters to blocks.
+  const ParameterBlocks& Blocks() const { return blocks; }
+  //! Modify the assignment of the parameters to blocks.
+  ParameterBlocks& Blocks() { return blocks; }
+
+  /**
+   * The UpdatePolicyType policy classes must contain an internal 'Policy'
+   * template class with two template arguments: MatType and GradType.  This is
+   * instantiated at the start of the optimization, and holds parameters
+   * specific to an individual optimization.
+   */
+  template<typename MatType, typename GradType>
+  class Policy
+  {
+   public:
+    typedef typename MatType::elem_type ElemType;
+
+    static_assert(
+        std::is_base_of<arma::Mat<ElemType>, MatType>::value &&
+        std::is_base_of<arma::Mat<ElemType>, GradType>::value,
+        "LAMBUpdate requires dense coordinates and gradients");
+
+    /**
+     * This is called by the optimizer method before the start of the iteration
+     * update process.
+     *
+     * @param parent Instantiated parent class.
+     * @param rows Number of rows in the gradient matrix.
+     * @param cols Number of columns in the gradient matrix.
+     */
+    Policy(const LAMBUpdate& parent, const size_t rows, const size_t cols) :
+        parent(parent),
+        m(arma::zeros<MatType>(rows, cols)),
+        v(arma::zeros<MatType>(rows, cols)),
+        weightNorms(parent.blocks.NumBlocks(rows, cols)),
+        stepNorms(weightNorms.n_elem),
+        blockStepSizes(weightNorms.n_elem),
+        iteration(0)
+    {
+      // Nothing to do.
+    }
+
+    /**
+     * Update step for LAMB.
+     *
+     * @param iterate Parameters that minimize the function.
+     * @param stepSize Step size to be used for the given iteration.
+     * @param gradient The gradient matrix.
+     */
+    void Update(MatType& iterate,
+                const double stepSize,
+                const GradType& gradient)
+    {
+      // Increment the iteration counter variable.
+      ++iteration;
+
+      const ElemType beta1 = parent.beta1;
+      const ElemType beta2 = parent.beta2;
+      const ElemType epsilon = parent.epsilon;
+      const ElemType weightDecay = parent.weightDecay;
+      const ElemType biasCorrection1 = 1.0 - std::pow(parent.beta1, iteration);
+      const ElemType biasCorrection2 = 1.0 - std::pow(parent.beta2, iteration);
+
+      ElemType* x = iterate.memptr();
+      const ElemType* g = gradient.memptr();
+      ElemType* mMem = m.memptr();
+      ElemType* vMem = v.memptr();
+      ElemType* wNorms = weightNorms.memptr();
+      ElemType* rNorms = stepNorms.memptr();
+      ElemType* steps = blockStepSizes.memptr();
+
+      // The Adam step of an element, with weight decay.
+      auto step = [&](const size_t i)
+      {
+        return (mMem[i] / biasCorrection1) /
+            (std::sqrt(vMem[i] / biasCorrection2) + epsilon) +
+            weightDecay * x[i];
+      };
+
+      // Update the moments, and find the norms of the weights and of the step
+      // of every block.
+      weightNorms.zeros();
+      stepNorms.zeros();
+      parent.blocks.ForEach(iterate.n_rows, iterate.n_cols,
+          [&](const size_t i, const size_t b)
+          {
+            mMem[i] = beta1 * mMem[i] + (1 - beta1) * g[i];
+            vMem[i] = beta2 * vMem[i] + (1 - beta2) * (g[i] * g[i]);
+            const ElemType r = step(i);
+            wNorms[b] += x[i] * x[i];
+            rNorms[b] += r * r;
+          });
+
+      // Scale the step size of every block by its trust ratio.
+      for (size_t b = 0; b < weightNorms.n_elem; ++b)
+      {
+        const ElemType wNorm = std::sqrt(wNorms[b]);
+        const ElemType rNorm = std::sqrt(rNorms[b]);
+        const ElemType trustRatio = (wNorm > 0 && rNorm > 0) ?
+            wNorm / rNorm : 1;
+        steps[b] = stepSize * trustRatio;
+      }
+
+      parent.blocks.ForEach(iterate.n_rows, iterate.n_cols,
+          [&](const size_t i, const size_t b)
+          {
+            x[i] -= steps[b] * step(i);
+          });
+    }
+
+    //! Get the step size of every block in the last update.
+    const arma::Col<ElemType>& BlockStepSizes() const { return blockStepSizes; }
+
+   private:
+    //! The instantiated parent class.
+    const LAMBUpdate& parent;
+    //! The exponential moving average of gradient values.
+    MatType m;
+    //! The exponential moving average of squared gradient values.
+    MatType v;
+    //! The squared norm of the weights of every block.
+    arma::Col<ElemType> weightNorms;
+    //! The squared norm of the step of every block.
+    arma::Col<ElemType> stepNorms;
+    //! The step size of every block.
+    arma::Col<ElemType> blockStepSizes;
+    //! The number of iterations.
+    size_t iteration;
+  };
+
+ private:
+  //! The smoothing parameter.
+  double beta1;
+  //! The second moment coefficient.
+  double beta2;
+  //! The value added to the square root of the second moment estimates.
+  double epsilon;
+  //! The weight decay coefficient.
+  double weightDecay;
+  //! The assignment of the parameters to blocks.
+  ParameterBlocks blocks;
+};
+
+} // namespace ens
+
+#endif
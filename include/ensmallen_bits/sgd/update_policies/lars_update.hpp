@@ -0,0 +1,215 @@
+/**
+ * @file lars_update.hpp
+ *
+ * Layer-wise adaptive rate scaling (LARS) update for Stochastic Gradient
+ * Descent.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_SGD_LARS_UPDATE_HPP
+#define ENSMALLEN_SGD_LARS_UPDATE_HPP
+
+#include "parameter_blocks.hpp"
+
+namespace ens {
+
+/**
+ * Layer-wise adaptive rate scaling (LARS) is a momentum update for large-batch
+ * training, that scales the step of every block of parameters (see
+ * ParameterBlocks; e.g. the weights of one layer) by a trust ratio, so that
+ * the step of a block is proportional to the norm of its weights instead of
+ * the norm of its gradient.  For every block b, the following update is used:
+ *
+ * \f[
+ * \lambda_b = \eta \frac{\| w_b \|}{\| g_b \| + \beta \| w_b \| + \epsilon}
+ * v_b = \mu v_b + \alpha \lambda_b (g_b + \beta w_b)
+ * w_b = w_b - v_b
+ * \f]
+ *
+ * where \f$ \alpha \f$ is the step size, \f$ \eta \f$ the trust coefficient,
+ * \f$ \beta \f$ the weight decay and \f$ \mu \f$ the momentum.  If the weights
+ * or the gradient of a block are 0, its trust ratio is 1.  The coordinates and
+ * the gradient must be dense matrices.
+ *
+ * For more information, see the following.
+ *
+ * @code
+ * @article{You2017,
+ *   author  = {Yang You and Igor Gitman and Boris Ginsburg},
+ *   title   = {Large Batch Training of Convolutional Networks},
+ *   journal = {arXiv preprint arXiv:1708.03888},
+ *   year    = {2017}
+ * }
+ * @endcode
+ */
+class LARSUpdate
+{
+ public:
+  /**
+   * Construct the LARS update policy with the given parameters.
+   *
+   * @param momentum The momentum decay hyperparameter.
+   * @param trustCoefficient The trust coefficient that scales the trust
+   *     ratios.
+   * @param weightDecay The weight decay (L2 regularization) coefficient.
+   * @param epsilon Value added to the denominator of the trust ratios.
+   * @param blocks The assignment of the parameters to blocks.
+   */
+  LARSUpdate(const double momentum = 0.9,
+             const double trustCoefficient = 0.001,
+             const double weightDecay = 0.0,
+             const double epsilon = 1e-8,
+             const ParameterBlocks& blocks = ParameterBlocks()) :
+      momentum(momentum),
+      trustCoefficient(trustCoefficient),
+      weightDecay(weightDecay),
+      epsilon(epsilon),
+      blocks(blocks)
+  {
+    // Nothing to do.
+  }
+
+  //! Get the momentum.
+  double Momentum() const { return momentum; }
+  //! Modify the momentum.
+  double& Momentum() { return momentum; }
+
+  //! Get the trust coefficient.
+  double TrustCoefficient() const { return trustCoefficient; }
+  //! Modify the trust coefficient.
+  double& TrustCoefficient() { return trustCoefficient; }
+
+  //! Get the weight decay.
+  double WeightDecay() const { return weightDecay; }
+  //! Modify the weight decay.
+  double& WeightDecay() { return weightDecay; }
+
+  //! Get the value added to the denominator of the trust ratios.
+  double Epsilon() const { return epsilon; }
+  //! Modify the value added to the denominator of the trust ratios.
+  double& Epsilon() { return epsilon; }
+
+  //! Get the assignment of the parameters to blocks.
+  const ParameterBlocks& Blocks() const { return blocks; }
+  //! Modify the assignment of the parameters to blocks.
+  ParameterBlocks& Blocks() { return blocks; }
+
+  /**
+   * The UpdatePolicyType policy classes must contain an internal 'Policy'
+   * template class with two template arguments: MatType and GradType.  This is
+   * instantiated at the start of the optimization, and holds parameters
+   * specific to an individual optimization.
+   */
+  template<typename MatType, typename GradType>
+  class Policy
+  {
+   public:
+    typedef typename MatType::elem_type ElemType;
+
+    static_assert(
+        std::is_base_of<arma::Mat<ElemType>, MatType>::value &&
+        std::is_base_of<arma::Mat<ElemType>, GradType>::value,
+        "LARSUpdate requires dense coordinates and gradients");
+
+    /**
+     * This is called by the optimizer method before the start of the iteration
+     * update process.
+     *
+     * @param parent Instantiated parent class.
+     * @param rows Number of rows in the gradient matrix.
+     * @param cols Number of columns in the gradient matrix.
+     */
+    Policy(const LARSUpdate& parent, const size_t rows, const size_t cols) :
+        parent(parent),
+        velocity(arma::zeros<MatType>(rows, cols)),
+        weightNorms(parent.blocks.NumBlocks(rows, cols)),
+        gradientNorms(weightNorms.n_elem),
+        blockStepSizes(weightNorms.n_elem)
+    {
+      // Nothing to do.
+    }
+
+    /**
+     * Update step for LARS.
+     *
+     * @param iterate Parameters that minimize the function.
+     * @param stepSize Step size to be used for the given iteration.
+     * @param gradient The gradient matrix.
+     */
+    void Update(MatType& iterate,
+                const double stepSize,
+                const GradType& gradient)
+    {
+      ElemType* x = iterate.memptr();
+      const ElemType* g = gradient.memptr();
+      ElemType* v = velocity.memptr();
+      ElemType* wNorms = weightNorms.memptr();
+      ElemType* gNorms = gradientNorms.memptr();
+      ElemType* steps = blockStepSizes.memptr();
+
+      // Find the norms of the weights and the gradient of every block.
+      weightNorms.zeros();
+      gradientNorms.zeros();
+      parent.blocks.ForEach(iterate.n_rows, iterate.n_cols,
+          [&](const size_t i, const size_t b)
+          {
+            wNorms[b] += x[i] * x[i];
+            gNorms[b] += g[i] * g[i];
+          });
+
+      // Scale the step size of every block by its trust ratio.
+      const ElemType weightDecay = parent.weightDecay;
+      for (size_t b = 0; b < weightNorms.n_elem; ++b)
+      {
+        const ElemType wNorm = std::sqrt(wNorms[b]);
+        const ElemType gNorm = std::sqrt(gNorms[b]);
+        const ElemType trustRatio = (wNorm > 0 && gNorm > 0) ?
+            parent.trustCoefficient * wNorm /
+            (gNorm + weightDecay * wNorm + parent.epsilon) : 1;
+        steps[b] = stepSize * trustRatio;
+      }
+
+      const ElemType mu = parent.momentum;
+      parent.blocks.ForEach(iterate.n_rows, iterate.n_cols,
+          [&](const size_t i, const size_t b)
+          {
+            v[i] = mu * v[i] + steps[b] * (g[i] + weightDecay * x[i]);
+            x[i] -= v[i];
+          });
+    }
+
+    //! Get the step size of every block in the last update.
+    const arma::Col<ElemType>& BlockStepSizes() const { return blockStepSizes; }
+
+   private:
+    //! The instantiated parent class.
+    const LARSUpdate& parent;
+    //! The velocity matrix.
+    MatType velocity;
+    //! The squared norm of the weights of every block.
+    arma::Col<ElemType> weightNorms;
+    //! The squared norm of the gradient of every block.
+    arma::Col<ElemType> gradientNorms;
+    //! The step size of every block.
+    arma::Col<ElemType> blockStepSizes;
+  };
+
+ private:
+  //! The momentum hyperparameter.
+  double momentum;
+  //! The trust coefficient.
+  double trustCoefficient;
+  //! The weight decay coefficient.
+  double weightDecay;
+  //! The value added to the denominator of the trust ratios.
+  double epsilon;
+  //! The assignment of the parameters to blocks.
+  ParameterBlocks blocks;
+};
+
+} // namespace ens
+
+#endif
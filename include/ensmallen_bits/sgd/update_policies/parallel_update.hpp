@@ -0,0 +1,232 @@
+/**
+ * @file parallel_update.hpp
+ *
+ * Update wrapper that applies an element-wise update policy to chunks of the
+ * parameters in parallel.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_SGD_PARALLEL_UPDATE_HPP
+#define ENSMALLEN_SGD_PARALLEL_UPDATE_HPP
+
+namespace ens {
+
+/**
+ * Interface for wrapping around element-wise update policies (e.g.,
+ * MomentumUpdate or AdamUpdate) and splitting each step across threads.  The
+ * parameters are cut into one contiguous chunk per thread, and every chunk has
+ * its own instance of the wrapped policy, which holds the state (velocity,
+ * moments, ...) of the elements in that chunk.  The boundaries between chunks
+ * fall on 64-byte cache lines of the parameters (the split is fixed at the
+ * first step, when their address is known), so that threads do not write to
+ * the same cache line.
+ *
+ * Only policies that update every element independently of the others can be
+ * wrapped; policies that use norms or other statistics of the whole gradient
+ * would see the statistics of a chunk instead.  The coordinates and the
+ * gradient must be dense Armadillo matrices.  Without OpenMP, or if the
+ * parameters are too small to give every thread minChunkSize elements, fewer
+ * chunks are used, down to a single one.
+ *
+ * @code
+ * ParallelUpdate<AdamUpdate> update(AdamUpdate(), 0);
+ * SGD<ParallelUpdate<AdamUpdate>> optimizer(0.001, 32, 100000, 1e-5, true,
+ *     update);
+ * @endcode
+ *
+ * @tparam UpdatePolicyType Element-wise update policy to wrap.
+ */
+template<typename UpdatePolicyType>
+class ParallelUpdate
+{
+ public:
+  /**
+   * Construct the ParallelUpdate wrapper.
+   *
+   * @param updatePolicy An instance of the wrapped update policy.
+   * @param numThreads Number of threads to use (0 means all available).
+   * @param minChunkSize Minimum number of elements per chunk; smaller
+   *     parameter matrices use fewer threads.
+   */
+  ParallelUpdate(const UpdatePolicyType& updatePolicy = UpdatePolicyType(),
+                 const size_t numThreads = 0,
+                 const size_t minChunkSize = 65536) :
+      updatePolicy(updatePolicy),
+      numThreads(numThreads),
+      minChunkSize(minChunkSize)
+  {
+    // Nothing to do here.
+  }
+
+  //! Get the update policy.
+  const UpdatePolicyType& UpdatePolicy() const { return updatePolicy; }
+  //! Modify the update policy.
+  UpdatePolicyType& UpdatePolicy() { return updatePolicy; }
+
+  //! Get the number of threads (0 means all available).
+  size_t NumThreads() const { return numThreads; }
+  //! Modify the number of threads (0 means all available).
+  size_t& NumThreads() { return numThreads; }
+
+  //! Get the minimum number of elements per chunk.
+  size_t MinChunkSize() const { return minChunkSize; }
+  //! Modify the minimum number of elements per chunk.
+  size_t& MinChunkSize() { return minChunkSize; }
+
+  /**
+   * The UpdatePolicyType policy classes must contain an internal 'Policy'
+   * template class with two template arguments: MatType and GradType.  This is
+   * instantiated at the start of the optimization, and holds parameters
+   * specific to an individual optimization.
+   */
+  template<typename MatType, typename GradType>
+  class Policy
+  {
+   public:
+    typedef typename MatType::elem_type ElemType;
+    //! Every chunk is a column vector that aliases the parameters.
+    typedef arma::Mat<ElemType> ChunkType;
+    typedef typename UpdatePolicyType::template Policy<ChunkType, ChunkType>
+        InstPolicyType;
+
+    static_assert(std::is_base_of<ChunkType, MatType>::value &&
+        std::is_base_of<ChunkType, GradType>::value,
+        "ParallelUpdate requires dense Armadillo coordinates and gradients");
+
+    /**
+     * This is called by the optimizer method before the start of the iteration
+     * update process; it splits the parameters into chunks.
+     *
+     * @param parent Instantiated parent class.
+     * @param rows Number of rows in the gradient matrix.
+     * @param cols Number of columns in the gradient matrix.
+     */
+    Policy(ParallelUpdate<UpdatePolicyType>& parent,
+           const size_t rows,
+           const size_t cols) :
+        parent(parent),
+        n(rows * cols),
+        split(false)
+    {
+      // Until the address of the parameters is known, assume that they start
+      // on a cache line.
+      Split(0);
+    }
+
+    /**
+     * Update step.  Every chunk of the parameters is updated by its own
+     * instance of the wrapped policy, in parallel.
+     *
+     * @param iterate Parameters that minimize the function.
+     * @param stepSize Step size to be used for the given iteration.
+     * @param gradient The gradient matrix.
+     */
+    void Update(MatType& iterate,
+                const double stepSize,
+                const GradType& gradient)
+    {
+      // No step has been taken yet, so the chunks can still be moved to the
+      // cache lines of the parameters.  Later steps keep the same split (even
+      // if the parameters move), since the chunks hold the policy state.
+      if (!split)
+      {
+        const size_t offset = LineOffset(iterate.memptr());
+        if (offset != 0)
+          Split(offset);
+        split = true;
+      }
+
+      ParallelFor(policies.size(), parent.NumThreads(), [&](const size_t c)
+      {
+        // Matrices that alias the chunk; this does not allocate.
+        const size_t begin = bounds[c];
+        const size_t length = bounds[c + 1] - begin;
+        ChunkType iterateChunk(iterate.memptr() + begin, length, 1, false,
+            true);
+        const ChunkType gradientChunk(
+            const_cast<ElemType*>(gradient.memptr()) + begin, length, 1, false,
+            true);
+
+        policies[c].Update(iterateChunk, stepSize, gradientChunk);
+      });
+    }
+
+    //! Get the number of chunks.
+    size_t Chunks() const { return policies.size(); }
+
+   private:
+    //! The number of elements in a 64-byte cache line.
+    static size_t LineSize()
+    {
+      return std::max((size_t) 64 / sizeof(ElemType), (size_t) 1);
+    }
+
+    //! Return the number of elements before the first cache line boundary at
+    //! or after the given address (0 if elements can't start on one).
+    static size_t LineOffset(const ElemType* memptr)
+    {
+      const size_t misalignment = (size_t) ((uintptr_t) memptr % 64);
+      if (misalignment == 0 || misalignment % sizeof(ElemType) != 0)
+        return 0;
+
+      return (64 - misalignment) / sizeof(ElemType);
+    }
+
+    /**
+     * Split the parameters into chunks: one chunk per thread, but no chunk
+     * smaller than minChunkSize, with every boundary a whole number of cache
+     * lines after the first cache line boundary.
+     *
+     * @param offset Number of elements before the first cache line boundary.
+     */
+    void Split(const size_t offset)
+    {
+      const size_t lineSize = LineSize();
+      const size_t chunks = std::max(std::min(
+          ens::NumThreads(parent.NumThreads()),
+          n / std::max(parent.MinChunkSize(), (size_t) 1)), (size_t) 1);
+      size_t chunkSize = (n + chunks - 1) / chunks;
+      chunkSize = std::max((chunkSize + lineSize - 1) / lineSize * lineSize,
+          lineSize);
+
+      bounds.clear();
+      policies.clear();
+      bounds.push_back(0);
+      size_t end = offset;
+      do
+      {
+        const size_t begin = bounds.back();
+        end = std::min(end + chunkSize, n);
+        policies.push_back(InstPolicyType(parent.UpdatePolicy(), end - begin,
+            1));
+        bounds.push_back(end);
+      } while (end < n);
+    }
+
+    //! The instantiated parent class.
+    ParallelUpdate<UpdatePolicyType>& parent;
+    //! The number of parameters.
+    size_t n;
+    //! Whether the chunks have been fixed by the first step.
+    bool split;
+    //! The first element of every chunk, followed by the number of elements.
+    std::vector<size_t> bounds;
+    //! The instantiated update policy of every chunk.
+    std::vector<InstPolicyType> policies;
+  };
+
+ private:
+  //! An instance of the wrapped update policy.
+  UpdatePolicyType updatePolicy;
+  //! The number of threads (0 means all available).
+  size_t numThreads;
+  //! The minimum number of elements per chunk.
+  size_t minChunkSize;
+};
+
+} // namespace ens
+
+#endif
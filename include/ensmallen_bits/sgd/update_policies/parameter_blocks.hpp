@@ -0,0 +1,114 @@
+/**
+ * @file parameter_blocks.hpp
+ *
+ * Assignment of the parameters to blocks (e.g. layers), for update policies
+ * that adapt the step size of every block separately.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_SGD_PARAMETER_BLOCKS_HPP
+#define ENSMALLEN_SGD_PARAMETER_BLOCKS_HPP
+
+namespace ens {
+
+/**
+ * ParameterBlocks assigns every element of the parameters to a block, such as
+ * the weights of one layer of a network.  The blocks are given as a vector of
+ * block indices (0, 1, ..., numBlocks - 1), which either has one entry per
+ * element of the parameters (in column-major order), or one entry per row, so
+ * that, e.g., ranges of rows form the blocks.  An empty vector puts all the
+ * parameters into a single block.
+ *
+ * @code
+ * // The first 100 rows are the first block, the next 20 rows the second one.
+ * arma::uvec blocks(120);
+ * blocks.subvec(0, 99).fill(0);
+ * blocks.subvec(100, 119).fill(1);
+ * LARSUpdate update(0.9, 0.001, 0.0, 1e-8, ParameterBlocks(blocks));
+ * @endcode
+ */
+class ParameterBlocks
+{
+ public:
+  /**
+   * Create the block assignment.
+   *
+   * @param blocks The block of every element or of every row of the
+   *     parameters; if empty, all the parameters are one block.
+   */
+  ParameterBlocks(const arma::uvec& blocks = arma::uvec()) : blocks(blocks)
+  {
+    // Nothing to do.
+  }
+
+  //! Get the block indices.
+  const arma::uvec& Blocks() const { return blocks; }
+  //! Modify the block indices.
+  arma::uvec& Blocks() { return blocks; }
+
+  /**
+   * Return the number of blocks, and make sure the block indices fit
+   * parameters of the given size; std::invalid_argument is thrown if not.
+   *
+   * @param rows Number of rows of the parameters.
+   * @param cols Number of columns of the parameters.
+   */
+  size_t NumBlocks(const size_t rows, const size_t cols) const
+  {
+    if (blocks.n_elem == 0)
+      return 1;
+
+    if (blocks.n_elem != rows * cols && blocks.n_elem != rows)
+    {
+      std::ostringstream oss;
+      oss << "ParameterBlocks: " << blocks.n_elem << " block indices given for "
+          << "parameters with " << rows << " rows and " << cols << " columns; "
+          << "there must be one per element or one per row";
+      throw std::invalid_argument(oss.str());
+    }
+
+    return blocks.max() + 1;
+  }
+
+  /**
+   * Call func(i, block) for every element i of parameters with the given size,
+   * in column-major order.
+   *
+   * @param rows Number of rows of the parameters.
+   * @param cols Number of columns of the parameters.
+   * @param func Function to call.
+   */
+  template<typename FuncType>
+  void ForEach(const size_t rows, const size_t cols, FuncType func) const
+  {
+    const size_t n = rows * cols;
+    const arma::uword* b = blocks.memptr();
+    if (blocks.n_elem == 0)
+    {
+      for (size_t i = 0; i < n; ++i)
+        func(i, (size_t) 0);
+    }
+    else if (blocks.n_elem == n)
+    {
+      for (size_t i = 0; i < n; ++i)
+        func(i, (size_t) b[i]);
+    }
+    else
+    {
+      for (size_t j = 0; j < cols; ++j)
+        for (size_t i = 0; i < rows; ++i)
+          func(j * rows + i, (size_t) b[i]);
+    }
+  }
+
+ private:
+  //! The block of every element or of every row.
+  arma::uvec blocks;
+};
+
+} // namespace ens
+
+#endif
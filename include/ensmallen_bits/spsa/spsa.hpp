@@ -19,6 +19,14 @@ namespace ens {
  * Implementation of the SPSA method. The SPSA algorithm approximates the
  * gradient of the function by finite differences along stochastic directions.
  *
+ * The gradient estimate can be averaged over several independent perturbations
+ * per iteration, which reduces its variance; the 2 * numPerturbations
+ * evaluations of an iteration are independent of each other and run
+ * concurrently if numThreads is not 1.  Optionally, the second-order variant
+ * (2SPSA) also estimates the Hessian from two additional evaluations per
+ * perturbation, and preconditions the gradient with the running average of
+ * the Hessian estimates.
+ *
  * For more information, see the following.
  *
  * @code
@@ -32,6 +40,17 @@ namespace ens {
  *   pages   = {482--492},
  *   year    = {1998}
  * }
+ *
+ * @article{Spall2000,
+ *   author  = {Spall, J. C.},
+ *   title   = {Adaptive Stochastic Approximation by the Simultaneous
+ *              Perturbation Method},
+ *   journal = {IEEE Transactions on Automatic Control},
+ *   volume  = {45},
+ *   number  = {10},
+ *   pages   = {1839--1853},
+ *   year    = {2000}
+ * }
  * @endcode
  *
  * SPSA can optimize arbitrary functions.  For more details,
@@ -54,13 +73,28 @@ class SPSA
    * @param maxIterations Maximum number of iterations allowed (0 means no
    *     limit).
    * @param tolerance Maximum absolute tolerance to terminate algorithm.
+   * @param numPerturbations Number of independent perturbations whose gradient
+   *     estimates are averaged in every iteration.
+   * @param secondOrder If true, use second-order SPSA (2SPSA), which also
+   *     estimates the Hessian.  This needs O(n^2) memory and O(n^3) time per
+   *     iteration for n parameters.
+   * @param numThreads Number of threads used to evaluate the perturbations (0
+   *     means all available).  Values other than 1 require the function's
+   *     Evaluate() to be thread-safe.
+   * @param hessianDelta Initial value of the regularization delta_k of the
+   *     2SPSA preconditioner sqrt(H^2 + delta_k I); delta_k decays as
+   *     hessianDelta / (k + 1).
    */
   SPSA(const double alpha = 0.602,
        const double gamma = 0.101,
        const double stepSize = 0.16,
        const double evaluationStepSize = 0.3,
        const size_t maxIterations = 100000,
-       const double tolerance = 1e-5);
+       const double tolerance = 1e-5,
+       const size_t numPerturbations = 1,
+       const bool secondOrder = false,
+       const size_t numThreads = 1,
+       const double hessianDelta = 0.1);
 
   /**
    * Optimize the given function, starting from the coordinates given in the
@@ -108,7 +142,35 @@ class SPSA
   //! Modify the maximum number of iterations (0 indicates no limit).
   size_t& MaxIterations() { return maxIterations; }
 
+  //! Get the number of perturbations per iteration.
+  size_t NumPerturbations() const { return numPerturbations; }
+  //! Modify the number of perturbations per iteration.
+  size_t& NumPerturbations() { return numPerturbations; }
+
+  //! Get whether second-order SPSA (2SPSA) is used.
+  bool SecondOrder() const { return secondOrder; }
+  //! Modify whether second-order SPSA (2SPSA) is used.
+  bool& SecondOrder() { return secondOrder; }
+
+  //! Get the number of threads used to evaluate the perturbations.
+  size_t NumThreads() const { return numThreads; }
+  //! Modify the number of threads used to evaluate the perturbations.
+  size_t& NumThreads() { return numThreads; }
+
+  //! Get the initial regularization of the 2SPSA preconditioner.
+  double HessianDelta() const { return hessianDelta; }
+  //! Modify the initial regularization of the 2SPSA preconditioner.
+  double& HessianDelta() { return hessianDelta; }
+
+  //! Get the random number engine.
+  const RandomEngine& Engine() const { return engine; }
+  //! Modify the random number engine.
+  RandomEngine& Engine() { return engine; }
+
  private:
+  //! The source of random numbers.
+  RandomEngine engine;
+
   //! Scaling exponent for the step size.
   double alpha;
 
@@ -129,6 +191,18 @@ class SPSA
 
   //! The tolerance for termination.
   double tolerance;
+
+  //! The number of perturbations per iteration.
+  size_t numPerturbations;
+
+  //! Whether second-order SPSA (2SPSA) is used.
+  bool secondOrder;
+
+  //! The number of threads used to evaluate the perturbations.
+  size_t numThreads;
+
+  //! The initial regularization of the 2SPSA preconditioner.
+  double hessianDelta;
 };
 
 } // namespace ens
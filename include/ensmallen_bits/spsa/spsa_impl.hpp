@@ -26,14 +26,22 @@ inline SPSA::SPSA(const double alpha,
                   const double stepSize,
                   const double evaluationStepSize,
                   const size_t maxIterations,
-                  const double tolerance) :
+                  const double tolerance,
+                  const size_t numPerturbations,
+                  const bool secondOrder,
+                  const size_t numThreads,
+                  const double hessianDelta) :
     alpha(alpha),
     gamma(gamma),
     stepSize(stepSize),
     evaluationStepSize(evaluationStepSize),
     ak(0.001 * maxIterations),
     maxIterations(maxIterations),
-    tolerance(tolerance)
+    tolerance(tolerance),
+    numPerturbations(numPerturbations),
+    secondOrder(secondOrder),
+    numThreads(numThreads),
+    hessianDelta(hessianDelta)
 { /* Nothing to do. */ }
 
 template<typename ArbitraryFunctionType,
@@ -52,8 +60,33 @@ typename MatType::elem_type SPSA::Optimize(ArbitraryFunctionType& function,
       MatType>();
   RequireFloatingPointType<MatType>();
 
-  BaseMatType gradient(iterate.n_rows, iterate.n_cols);
-  arma::Mat<ElemType> spVector(iterate.n_rows, iterate.n_cols);
+  if (numPerturbations == 0)
+  {
+    throw std::invalid_argument("SPSA::Optimize(): the number of perturbations "
+        "must be positive!");
+  }
+
+  const size_t rows = iterate.n_rows;
+  const size_t cols = iterate.n_cols;
+  const size_t q = numPerturbations;
+
+  // Every column holds the stochastic direction of one perturbation.
+  BaseMatType gradient(rows, cols);
+  arma::Mat<ElemType> spVectors(iterate.n_elem, q);
+  arma::Col<ElemType> direction;
+
+  // Perturbations 2 * j and 2 * j + 1 are iterate +- ck * spVectors.col(j).
+  // For 2SPSA, perturbations 2 * (q + j) and 2 * (q + j) + 1 are the same
+  // points shifted by ck * hessianVectors.col(j).
+  std::vector<BaseMatType> perturbed(secondOrder ? 4 * q : 2 * q);
+  arma::Col<ElemType> perturbedValues(perturbed.size());
+  arma::Mat<ElemType> hessianVectors;
+  arma::Mat<ElemType> hessian;
+  if (secondOrder)
+  {
+    hessianVectors.set_size(iterate.n_elem, q);
+    hessian.zeros(iterate.n_elem, iterate.n_elem);
+  }
 
   // To keep track of where we are and how things are going.
   ElemType overallObjective = 0;
@@ -94,25 +127,92 @@ typename MatType::elem_type SPSA::Optimize(ArbitraryFunctionType& function,
     const double ck = evaluationStepSize / std::pow(k + 1, gamma);
 
     // Choose stochastic directions.
-    spVector = arma::conv_to<arma::Mat<ElemType>>::from(
-        arma::randi(iterate.n_rows, iterate.n_cols,
-        arma::distr_param(0, 1))) * 2 - 1;
+    engine.FillUniform(spVectors);
+    spVectors.transform([](const ElemType u)
+        { return (u < ElemType(0.5)) ? ElemType(-1) : ElemType(1); });
+    if (secondOrder)
+    {
+      engine.FillUniform(hessianVectors);
+      hessianVectors.transform([](const ElemType u)
+          { return (u < ElemType(0.5)) ? ElemType(-1) : ElemType(1); });
+    }
 
-    iterate += ck * spVector;
-    const double fPlus = function.Evaluate(iterate);
-    terminate |= Callback::Evaluate(*this, function, iterate, fPlus,
-        callbacks...);
+    for (size_t j = 0; j < q; ++j)
+    {
+      const arma::Mat<ElemType> spVector(spVectors.colptr(j), rows, cols,
+          false, true);
+      perturbed[2 * j] = iterate + ck * spVector;
+      perturbed[2 * j + 1] = iterate - ck * spVector;
+
+      if (secondOrder)
+      {
+        const arma::Mat<ElemType> hessianVector(hessianVectors.colptr(j), rows,
+            cols, false, true);
+        perturbed[2 * (q + j)] = perturbed[2 * j] + ck * hessianVector;
+        perturbed[2 * (q + j) + 1] = perturbed[2 * j + 1] + ck * hessianVector;
+      }
+    }
 
-    iterate -= 2 * ck * spVector;
-    const double fMinus = function.Evaluate(iterate);
-    terminate |= Callback::Evaluate(*this, function, iterate, fMinus,
-        callbacks...);
+    // Evaluate all perturbations together.
+    EvaluatePopulation(function, perturbed, perturbedValues, numThreads);
+    for (size_t i = 0; i < perturbed.size(); ++i)
+    {
+      terminate |= Callback::Evaluate(*this, function, perturbed[i],
+          perturbedValues[i], callbacks...);
+    }
 
-    iterate += ck * spVector;
     if (terminate)
       break;
 
-    gradient = (fPlus - fMinus) * (1 / (2 * ck * spVector));
+    // Average the gradient estimates of all perturbations.  The entries of the
+    // directions are +-1, so dividing by them is the same as multiplying.
+    arma::Col<ElemType> differences(q);
+    for (size_t j = 0; j < q; ++j)
+    {
+      differences[j] = (perturbedValues[2 * j] - perturbedValues[2 * j + 1]) /
+          (2 * ck * q);
+    }
+    direction = spVectors * differences;
+
+    if (secondOrder)
+    {
+      // Estimate the Hessian from the differences of the one-sided gradient
+      // estimates at iterate +- ck * spVector, and average it over iterations.
+      arma::Col<ElemType> curvatures(q);
+      for (size_t j = 0; j < q; ++j)
+      {
+        curvatures[j] = ((perturbedValues[2 * (q + j)] -
+            perturbedValues[2 * j]) - (perturbedValues[2 * (q + j) + 1] -
+            perturbedValues[2 * j + 1])) / (2 * ck * ck * q);
+      }
+
+      const arma::Mat<ElemType> estimate = hessianVectors *
+          arma::diagmat(curvatures) * spVectors.t();
+      hessian = (ElemType(k) * hessian + ElemType(0.5) * (estimate +
+          estimate.t())) / ElemType(k + 1);
+
+      // Every estimate has rank at most 2q, so the average of the first k + 1
+      // estimates is singular while 2q(k + 1) < n; until then, take the plain
+      // first-order step.
+      if (2 * q * (k + 1) >= iterate.n_elem)
+      {
+        // Precondition the gradient with sqrt(H^2 + delta_k I), which has the
+        // eigenvectors of the Hessian estimate H and eigenvalues
+        // sqrt(lambda^2 + delta_k).  If it is still badly conditioned, its
+        // small eigenvalues belong to directions that have barely been sampled
+        // yet, so keep the first-order step.
+        arma::Col<ElemType> eigval;
+        arma::Mat<ElemType> eigvec;
+        arma::eig_sym(eigval, eigvec, hessian);
+
+        const ElemType deltaK = hessianDelta / (k + 1);
+        eigval = arma::sqrt(arma::square(eigval) + deltaK);
+        if (eigval.min() >= ElemType(1e-2) * eigval.max())
+          direction = eigvec * ((eigvec.t() * direction) / eigval);
+      }
+    }
+
+    gradient = arma::reshape(direction, rows, cols);
     iterate -= akLocal * gradient;
 
     terminate |= Callback::StepTaken(*this, function, iterate, callbacks...);
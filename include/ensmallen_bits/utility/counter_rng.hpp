@@ -0,0 +1,170 @@
+/**
+ * @file counter_rng.hpp
+ *
+ * A small counter-based random number generator, used to give every parallel
+ * task its own independent, reproducible stream of random numbers.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_UTILITY_COUNTER_RNG_HPP
+#define ENSMALLEN_UTILITY_COUNTER_RNG_HPP
+
+#include <cstring>
+
+namespace ens {
+
+/**
+ * CounterRNG is a counter-based generator: the i-th number of a stream is a
+ * pure function of (seed, stream, i), computed by hashing with the SplitMix64
+ * finalizer.  Creating a stream is therefore free, and streams with different
+ * ids never need to share state; parallel tasks can each use
+ * `CounterRNG(seed, taskIndex)` and obtain the same numbers no matter which
+ * thread runs them or in which order.
+ *
+ * CounterRNG satisfies the UniformRandomBitGenerator requirements, so it can
+ * also be used with the distributions in <random>.
+ *
+ * For more information, see the following.
+ *
+ * @code
+ * @inproceedings{Salmon2011,
+ *   author    = {John K. Salmon and Mark A. Moraes and Ron O. Dror and
+ *                David E. Shaw},
+ *   title     = {Parallel Random Numbers: As Easy as 1, 2, 3},
+ *   booktitle = {Proceedings of the International Conference for High
+ *                Performance Computing, Networking, Storage and Analysis},
+ *   year      = {2011}
+ * }
+ * @endcode
+ */
+class CounterRNG
+{
+ public:
+  //! The type of the generated numbers.
+  typedef uint64_t result_type;
+
+  /**
+   * Create the stream with the given id of the given seed.
+   *
+   * @param seed Seed shared by all streams of a computation.
+   * @param stream Id of the stream (e.g. the index of a parallel task).
+   */
+  CounterRNG(const uint64_t seed = 0, const uint64_t stream = 0) :
+      key(Mix(seed ^ Mix(stream + 0x9E3779B97F4A7C15ULL))),
+      counter(0),
+      hasSpare(false),
+      spare(0.0)
+  {
+    // Nothing to do.
+  }
+
+  //! Get the smallest value that can be generated.
+  static constexpr result_type min() { return 0; }
+  //! Get the largest value that can be generated.
+  static constexpr result_type max() { return ~((result_type) 0); }
+
+  //! Generate the next 64-bit value of the stream.
+  result_type operator()()
+  {
+    return At(++counter);
+  }
+
+  //! Get the value at the given position of the stream without advancing it.
+  //! Positions start at 1.
+  result_type At(const uint64_t position) const
+  {
+    return Mix(key + 0x9E3779B97F4A7C15ULL * position);
+  }
+
+  //! Generate a uniformly distributed value in [0, 1).
+  double Uniform()
+  {
+    return ToUniform((*this)());
+  }
+
+  //! Map a 64-bit value to a uniformly distributed value in [0, 1).  The top
+  //! 52 bits become the mantissa of a double in [1, 2), so the conversion only
+  //! needs integer operations and vectorizes.
+  static double ToUniform(const uint64_t x)
+  {
+    const uint64_t bits = (x >> 12) | 0x3FF0000000000000ULL;
+    double d;
+    std::memcpy(&d, &bits, sizeof(d));
+    return d - 1.0;
+  }
+
+  //! Map a 64-bit value to a uniformly distributed float in [0, 1), in the
+  //! same way as ToUniform() but with the top 23 bits as the mantissa; rounding
+  //! the double result to float could give 1.
+  static float ToUniformFloat(const uint64_t x)
+  {
+    const uint32_t bits = (uint32_t) (x >> 41) | 0x3F800000U;
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f - 1.0f;
+  }
+
+  //! Generate a standard normally distributed value (Box-Muller).
+  double Normal()
+  {
+    if (hasSpare)
+    {
+      hasSpare = false;
+      return spare;
+    }
+
+    const double u1 = 1.0 - Uniform(); // In (0, 1], so the log is finite.
+    const double u2 = Uniform();
+    const double r = std::sqrt(-2.0 * std::log(u1));
+    const double theta = 2.0 * arma::datum::pi * u2;
+    spare = r * std::sin(theta);
+    hasSpare = true;
+    return r * std::cos(theta);
+  }
+
+  //! Get the number of values drawn from the stream so far.
+  uint64_t Counter() const { return counter; }
+  //! Jump to the given position in the stream.
+  void Seek(const uint64_t position) { counter = position; hasSpare = false; }
+
+  /**
+   * The SplitMix64 finalizer, a bijective 64-bit hash with good avalanche
+   * behavior.
+   */
+  static uint64_t Mix(uint64_t z)
+  {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  }
+
+  /**
+   * Draw a seed for a set of streams from Armadillo's random number generator,
+   * so that arma::arma_rng::set_seed() controls the whole computation.
+   */
+  static uint64_t DrawSeed()
+  {
+    const uint64_t high = (uint64_t) arma::randi<arma::uword>(
+        arma::distr_param(0, INT_MAX));
+    const uint64_t low = (uint64_t) arma::randi<arma::uword>(
+        arma::distr_param(0, INT_MAX));
+    return (high << 32) ^ low;
+  }
+
+ private:
+  //! The key that identifies the stream.
+  uint64_t key;
+  //! The position in the stream.
+  uint64_t counter;
+  //! Whether a second normal value from the last Box-Muller step is stored.
+  bool hasSpare;
+  //! The second normal value from the last Box-Muller step.
+  double spare;
+};
+
+} // namespace ens
+
+#endif
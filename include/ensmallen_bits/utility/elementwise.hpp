@@ -0,0 +1,66 @@
+/**
+ * @file elementwise.hpp
+ *
+ * In-place element-wise operations that Armadillo can only express through a
+ * temporary, used by update policies that run once per step.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_UTILITY_ELEMENTWISE_HPP
+#define ENSMALLEN_UTILITY_ELEMENTWISE_HPP
+
+namespace ens {
+
+/**
+ * Set a to the element-wise maximum of a and b.  `a = arma::max(a, b)` aliases
+ * its output and so allocates a temporary; dense matrices are updated in place.
+ *
+ * @param a Matrix to update.
+ * @param b Matrix to compare with; it must have the size of a.
+ */
+template<typename MatType, typename OtherMatType>
+inline void MaxInPlace(MatType& a, const OtherMatType& b)
+{
+  a = arma::max(a, b);
+}
+
+//! Dense overload of MaxInPlace(); does not allocate.
+template<typename eT>
+inline void MaxInPlace(arma::Mat<eT>& a, const arma::Mat<eT>& b)
+{
+  eT* aMem = a.memptr();
+  const eT* bMem = b.memptr();
+  for (size_t i = 0; i < a.n_elem; ++i)
+    aMem[i] = std::max(aMem[i], bMem[i]);
+}
+
+/**
+ * Set a to the element-wise maximum of a and the absolute value of b.
+ * `a = arma::max(a, arma::abs(b))` aliases its output and so allocates a
+ * temporary; dense matrices are updated in place.
+ *
+ * @param a Matrix to update.
+ * @param b Matrix to compare with; it must have the size of a.
+ */
+template<typename MatType, typename OtherMatType>
+inline void MaxAbsInPlace(MatType& a, const OtherMatType& b)
+{
+  a = arma::max(a, arma::abs(b));
+}
+
+//! Dense overload of MaxAbsInPlace(); does not allocate.
+template<typename eT>
+inline void MaxAbsInPlace(arma::Mat<eT>& a, const arma::Mat<eT>& b)
+{
+  eT* aMem = a.memptr();
+  const eT* bMem = b.memptr();
+  for (size_t i = 0; i < a.n_elem; ++i)
+    aMem[i] = std::max(aMem[i], (eT) std::abs(bMem[i]));
+}
+
+} // namespace ens
+
+#endif
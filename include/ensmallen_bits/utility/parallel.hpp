@@ -0,0 +1,115 @@
+/**
+ * @file parallel.hpp
+ *
+ * Small utilities shared by the optimizers that split work across threads
+ * with OpenMP.  When OpenMP is not available (ENS_USE_OPENMP is not defined)
+ * everything here degrades to serial execution.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_UTILITY_PARALLEL_HPP
+#define ENSMALLEN_UTILITY_PARALLEL_HPP
+
+namespace ens {
+
+// Visual Studio only supports OpenMP 2.0, which requires signed loop indices.
+#if defined(_MSC_VER)
+  typedef long long omp_size_t;
+#else
+  typedef size_t omp_size_t;
+#endif
+
+/**
+ * Return the number of threads that should be used given a user request.  A
+ * request of 0 means "use all available threads".  Without OpenMP, this is
+ * always 1.
+ *
+ * @param requested Number of threads requested by the user.
+ */
+inline size_t NumThreads(const size_t requested)
+{
+  #ifdef ENS_USE_OPENMP
+    return (requested == 0) ? (size_t) omp_get_max_threads() : requested;
+  #else
+    (void) requested;
+    return 1;
+  #endif
+}
+
+/**
+ * Return the number of shards that a reduction over n items should be split
+ * into when the given number of threads is available.  Normally this is one
+ * shard per thread; in deterministic mode (ENS_DETERMINISTIC) it is a fixed
+ * number that does not depend on the number of threads, so that the shape of
+ * the reduction tree (and therefore the result) is the same for any number of
+ * threads.
+ *
+ * @param threads Number of threads that will be used.
+ * @param n Number of items to reduce over.
+ */
+inline size_t ReductionShards(const size_t threads, const size_t n)
+{
+  #ifdef ENS_DETERMINISTIC
+    (void) threads;
+    return std::min((size_t) ENS_DETERMINISTIC_SHARDS, n);
+  #else
+    return std::min(threads, n);
+  #endif
+}
+
+/**
+ * Call func(i) for every i in [0, n), distributing the calls over the given
+ * number of threads.  The calls must be independent of each other; func() is
+ * responsible for only writing to memory that belongs to index i.
+ *
+ * @param n Number of iterations.
+ * @param numThreads Number of threads to use (0 means all available).
+ * @param func Callable taking a single size_t argument.
+ */
+template<typename FuncType>
+inline void ParallelFor(const size_t n,
+                        const size_t numThreads,
+                        FuncType&& func)
+{
+  const size_t threads = std::min(NumThreads(numThreads), n);
+  if (threads <= 1)
+  {
+    for (size_t i = 0; i < n; ++i)
+      func(i);
+    return;
+  }
+
+  #ifdef ENS_USE_OPENMP
+    const omp_size_t end = (omp_size_t) n;
+    #pragma omp parallel for schedule(dynamic) num_threads((int) threads)
+    for (omp_size_t i = 0; i < end; ++i)
+      func((size_t) i);
+  #endif
+}
+
+/**
+ * Sum the first n partial results in place with a pairwise (binary tree)
+ * reduction; the result is stored in parts[0].  The shape of the tree only
+ * depends on n, so for a fixed number of parts the summation order (and
+ * therefore the floating-point result) is always the same.
+ *
+ * @param parts Partial results to reduce; parts[1] to parts[n - 1] are left in
+ *     an unspecified state.
+ * @param n Number of partial results to reduce.
+ */
+template<typename T>
+inline void TreeReduce(std::vector<T>& parts, const size_t n)
+{
+  for (size_t stride = 1; stride < n; stride *= 2)
+  {
+    for (size_t i = 0; i + stride < n; i += 2 * stride)
+      parts[i] += parts[i + stride];
+  }
+}
+
+} // namespace ens
+
+#endif
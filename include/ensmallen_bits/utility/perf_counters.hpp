@@ -0,0 +1,218 @@
+/**
+ * @file perf_counters.hpp
+ *
+ * Hardware performance counters around a region of code, read with
+ * perf_event_open() on Linux.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_UTILITY_PERF_COUNTERS_HPP
+#define ENSMALLEN_UTILITY_PERF_COUNTERS_HPP
+
+#include <chrono>
+
+#if defined(ENS_USE_PERF_EVENTS)
+  #include <cstring>
+  #include <linux/perf_event.h>
+  #include <sys/ioctl.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+#endif
+
+namespace ens {
+
+/**
+ * PerfCounters counts CPU cycles, retired instructions, last-level cache
+ * misses and branch misses of the calling thread (and of the threads it
+ * creates while counting) between Start() and Stop(), together with the wall
+ * clock time.  Comparing instructions per cycle and cache misses per
+ * instruction shows whether a piece of code is compute-bound or memory-bound.
+ *
+ * @code
+ * PerfCounters counters;
+ * counters.Start();
+ * optimizer.Optimize(f, coordinates);
+ * counters.Stop();
+ *
+ * if (counters.Available(PerfCounters::INSTRUCTIONS))
+ *   std::cout << counters.Count(PerfCounters::INSTRUCTIONS) << std::endl;
+ * @endcode
+ *
+ * The counters are only read if ENS_USE_PERF_EVENTS is defined before
+ * ensmallen.hpp is included, so that the system headers they need are not
+ * pulled into every program.  Counters that cannot be opened (if
+ * ENS_USE_PERF_EVENTS is not defined, on systems other than Linux, in
+ * containers without access to perf events, or if
+ * /proc/sys/kernel/perf_event_paranoid forbids it) are reported
+ * as unavailable and read as 0; the time is always measured.  If the kernel
+ * multiplexes the counters, the counts are scaled by the fraction of the time
+ * they were running.
+ */
+class PerfCounters
+{
+ public:
+  //! The counted events.
+  enum Event
+  {
+    CYCLES,
+    INSTRUCTIONS,
+    CACHE_MISSES,
+    BRANCH_MISSES,
+    NUM_EVENTS
+  };
+
+  //! Open the counters; they are not counting until Start() is called.
+  PerfCounters() : seconds(0.0)
+  {
+    for (size_t e = 0; e < NUM_EVENTS; ++e)
+    {
+      fds[e] = Open((Event) e);
+      counts[e] = 0;
+    }
+  }
+
+  //! Close the counters.
+  ~PerfCounters()
+  {
+    #if defined(ENS_USE_PERF_EVENTS)
+    for (size_t e = 0; e < NUM_EVENTS; ++e)
+    {
+      if (fds[e] >= 0)
+        close(fds[e]);
+    }
+    #endif
+  }
+
+  // The counters own file descriptors.
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+
+  //! Reset the counters and start counting.
+  void Start()
+  {
+    #if defined(ENS_USE_PERF_EVENTS)
+    for (size_t e = 0; e < NUM_EVENTS; ++e)
+    {
+      if (fds[e] >= 0)
+      {
+        ioctl(fds[e], PERF_EVENT_IOC_RESET, 0);
+        ioctl(fds[e], PERF_EVENT_IOC_ENABLE, 0);
+      }
+    }
+    #endif
+
+    start = std::chrono::steady_clock::now();
+  }
+
+  //! Stop counting and read the counters.
+  void Stop()
+  {
+    seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+
+    for (size_t e = 0; e < NUM_EVENTS; ++e)
+      counts[e] = 0;
+
+    #if defined(ENS_USE_PERF_EVENTS)
+    for (size_t e = 0; e < NUM_EVENTS; ++e)
+    {
+      if (fds[e] < 0)
+        continue;
+
+      ioctl(fds[e], PERF_EVENT_IOC_DISABLE, 0);
+
+      // The value, the time the counter was enabled and the time it was
+      // actually counting.
+      uint64_t values[3];
+      if (read(fds[e], values, sizeof(values)) != (ssize_t) sizeof(values))
+        continue;
+
+      if (values[2] > 0 && values[2] < values[1])
+        counts[e] = (uint64_t) ((double) values[0] * values[1] / values[2]);
+      else
+        counts[e] = values[0];
+    }
+    #endif
+  }
+
+  //! Return whether any counter is available.
+  bool Available() const
+  {
+    for (size_t e = 0; e < NUM_EVENTS; ++e)
+    {
+      if (fds[e] >= 0)
+        return true;
+    }
+    return false;
+  }
+
+  //! Return whether the given counter is available.
+  bool Available(const Event event) const { return fds[event] >= 0; }
+
+  //! Get the count of the given event between the last Start() and Stop().
+  uint64_t Count(const Event event) const { return counts[event]; }
+
+  //! Get the wall clock time between the last Start() and Stop(), in seconds.
+  double Seconds() const { return seconds; }
+
+  //! Get the name of the given event.
+  static const char* Name(const Event event)
+  {
+    switch (event)
+    {
+      case CYCLES: return "cycles";
+      case INSTRUCTIONS: return "instructions";
+      case CACHE_MISSES: return "cache-misses";
+      case BRANCH_MISSES: return "branch-misses";
+      default: return "unknown";
+    }
+  }
+
+ private:
+  //! Open the counter of the given event; return -1 if it is not available.
+  static int Open(const Event event)
+  {
+    #if defined(ENS_USE_PERF_EVENTS)
+    static const uint64_t configs[NUM_EVENTS] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES };
+
+    struct perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = configs[event];
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+        PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    // Count the calling thread on any CPU.
+    const long fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+    return (fd < 0) ? -1 : (int) fd;
+    #else
+    (void) event;
+    return -1;
+    #endif
+  }
+
+  //! The file descriptors of the counters (-1 if unavailable).
+  int fds[NUM_EVENTS];
+  //! The counts of the last measurement.
+  uint64_t counts[NUM_EVENTS];
+  //! The start of the current measurement.
+  std::chrono::steady_clock::time_point start;
+  //! The duration of the last measurement.
+  double seconds;
+};
+
+} // namespace ens
+
+#endif
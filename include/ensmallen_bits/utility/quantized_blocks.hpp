@@ -0,0 +1,170 @@
+/**
+ * @file quantized_blocks.hpp
+ *
+ * Blockwise 8-bit quantized storage for optimizer state.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_UTILITY_QUANTIZED_BLOCKS_HPP
+#define ENSMALLEN_UTILITY_QUANTIZED_BLOCKS_HPP
+
+namespace ens {
+
+/**
+ * QuantizedBlocks stores a vector of n values with one byte per value.  The
+ * values are split into blocks of blockSize elements; every block keeps the
+ * largest absolute value of its elements as a (float) scale, and every element
+ * is stored as an 8-bit code relative to that scale.  The codes are
+ * square-root companded (the value is scale * q * |q| for a code q in [-1, 1]),
+ * which gives small values a finer resolution than a linear code would; the
+ * error of every element is at most scale / 127 (scale / 255 for unsigned
+ * storage).
+ *
+ * Unsigned storage is meant for values that are never negative, such as second
+ * moment estimates; it doubles the resolution, and a positive value is never
+ * stored as 0.
+ *
+ * The blocks are decoded into and encoded from a caller-provided buffer, so an
+ * optimizer can update one block at a time in full precision.
+ */
+class QuantizedBlocks
+{
+ public:
+  //! Create empty storage.
+  QuantizedBlocks() : n(0), blockSize(1), isSigned(true) { }
+
+  /**
+   * Create storage for n values, all 0.
+   *
+   * @param n Number of values.
+   * @param blockSize Number of values that share a scale.
+   * @param isSigned If false, the values must not be negative.
+   */
+  QuantizedBlocks(const size_t n,
+                  const size_t blockSize,
+                  const bool isSigned) :
+      n(n),
+      blockSize(std::max(blockSize, (size_t) 1)),
+      isSigned(isSigned),
+      codes(n, isSigned ? 127 : 0),
+      scales((n + this->blockSize - 1) / this->blockSize, 0.0f)
+  { }
+
+  //! Get the number of values.
+  size_t Size() const { return n; }
+  //! Get the number of values that share a scale.
+  size_t BlockSize() const { return blockSize; }
+  //! Get the number of blocks.
+  size_t Blocks() const { return scales.size(); }
+  //! Get the number of values in the given block.
+  size_t BlockLength(const size_t block) const
+  {
+    return std::min(blockSize, n - block * blockSize);
+  }
+  //! Get whether the values may be negative.
+  bool Signed() const { return isSigned; }
+  //! Get the memory used by the codes and the scales, in bytes.
+  size_t MemoryBytes() const
+  {
+    return codes.size() + scales.size() * sizeof(float);
+  }
+
+  /**
+   * Decode the given block into out, which must hold BlockLength(block)
+   * elements.
+   *
+   * @param block Index of the block.
+   * @param out Buffer to decode into.
+   */
+  template<typename eT>
+  void Decode(const size_t block, eT* out) const
+  {
+    const size_t length = BlockLength(block);
+    const unsigned char* c = codes.data() + block * blockSize;
+    const eT scale = scales[block];
+
+    if (isSigned)
+    {
+      for (size_t i = 0; i < length; ++i)
+      {
+        const eT q = ((eT) c[i] - 127) / 127;
+        out[i] = scale * q * std::abs(q);
+      }
+    }
+    else
+    {
+      for (size_t i = 0; i < length; ++i)
+      {
+        const eT q = (eT) c[i] / 255;
+        out[i] = scale * q * q;
+      }
+    }
+  }
+
+  /**
+   * Encode the given block from in, which must hold BlockLength(block)
+   * elements; the scale of the block is recomputed.
+   *
+   * @param block Index of the block.
+   * @param in Buffer to encode.
+   */
+  template<typename eT>
+  void Encode(const size_t block, const eT* in)
+  {
+    const size_t length = BlockLength(block);
+    unsigned char* c = codes.data() + block * blockSize;
+
+    eT maxAbs = 0;
+    for (size_t i = 0; i < length; ++i)
+      maxAbs = std::max(maxAbs, (eT) std::abs(in[i]));
+
+    // Encode relative to the stored scale, so that decoding is consistent.
+    scales[block] = (float) maxAbs;
+    const eT scale = scales[block];
+    if (scale == 0 || !std::isfinite(scale))
+    {
+      std::fill(c, c + length, isSigned ? 127 : 0);
+      return;
+    }
+
+    if (isSigned)
+    {
+      for (size_t i = 0; i < length; ++i)
+      {
+        const eT q = std::min(std::sqrt(std::abs(in[i]) / scale), (eT) 1);
+        const int code = (int) std::lround(127 * q);
+        c[i] = (unsigned char) (127 + ((in[i] < 0) ? -code : code));
+      }
+    }
+    else
+    {
+      for (size_t i = 0; i < length; ++i)
+      {
+        const eT value = std::max(in[i], (eT) 0);
+        const eT q = std::min(std::sqrt(value / scale), (eT) 1);
+        const long code = std::lround(255 * q);
+        // Never store a positive value as 0.
+        c[i] = (unsigned char) ((code == 0 && value > 0) ? 1 : code);
+      }
+    }
+  }
+
+ private:
+  //! The number of values.
+  size_t n;
+  //! The number of values that share a scale.
+  size_t blockSize;
+  //! Whether the values may be negative.
+  bool isSigned;
+  //! The code of every value.
+  std::vector<unsigned char> codes;
+  //! The scale of every block.
+  std::vector<float> scales;
+};
+
+} // namespace ens
+
+#endif
@@ -0,0 +1,287 @@
+/**
+ * @file random_engine.hpp
+ *
+ * The random number source used by the optimizers that need randomness.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_UTILITY_RANDOM_ENGINE_HPP
+#define ENSMALLEN_UTILITY_RANDOM_ENGINE_HPP
+
+#include "counter_rng.hpp"
+
+namespace ens {
+
+/**
+ * RandomEngine is the source of random numbers of an optimizer.  A
+ * default-constructed engine draws from Armadillo's global generator, so
+ * arma::arma_rng::set_seed() keeps controlling the optimizers exactly as
+ * before.  A seeded engine owns a private counter-based stream (see
+ * ens::CounterRNG) instead: it shares no state with Armadillo or with any other
+ * optimizer, so several optimizers can run concurrently in one process without
+ * contention and without influencing each other's results.
+ *
+ * For example, to make an optimizer independent of the global generator:
+ *
+ * @code
+ * CNE optimizer;
+ * optimizer.Engine() = RandomEngine(42);
+ * @endcode
+ *
+ * Whole matrices are filled with FillUniform() and FillNormal().  For a seeded
+ * engine every element only depends on its position in the stream, so the
+ * fill loops carry no dependency from one element to the next and are
+ * vectorized.
+ *
+ * A RandomEngine must not be used by several threads at once; parallel tasks
+ * should each create their own engine with TaskEngine().
+ */
+class RandomEngine
+{
+ public:
+  /**
+   * Create an engine that draws from Armadillo's global generator.
+   */
+  RandomEngine() : seeded(false) { }
+
+  /**
+   * Create an engine with its own stream.
+   *
+   * @param seed Seed of the engine.
+   * @param stream Id of the stream; engines with the same seed and different
+   *     stream ids are independent.
+   */
+  explicit RandomEngine(const uint64_t seed, const uint64_t stream = 0) :
+      seeded(true),
+      rng(seed, stream)
+  {
+    // Nothing to do.
+  }
+
+  //! Return whether the engine owns a stream (true) or uses Armadillo's
+  //! global generator (false).
+  bool Seeded() const { return seeded; }
+
+  //! Draw a fresh 64-bit seed, e.g. to create task engines from.
+  uint64_t NewSeed() { return seeded ? rng() : CounterRNG::DrawSeed(); }
+
+  /**
+   * Create the engine of a parallel task.  The seed should be drawn once with
+   * NewSeed() before the tasks start; the engine of task i is then the same
+   * no matter which thread runs the task.
+   *
+   * @param seed Seed drawn with NewSeed().
+   * @param task Index of the task.
+   */
+  static RandomEngine TaskEngine(const uint64_t seed, const size_t task)
+  {
+    return RandomEngine(seed, task);
+  }
+
+  //! Draw a uniformly distributed value in [0, 1).
+  double Uniform() { return seeded ? rng.Uniform() : arma::randu(); }
+
+  //! Draw a standard normally distributed value.
+  double Normal() { return seeded ? rng.Normal() : arma::randn(); }
+
+  //! Draw a uniformly distributed integer in [low, high].
+  size_t Integer(const size_t low, const size_t high)
+  {
+    const uint64_t range = (uint64_t) (high - low);
+    if (!seeded && range <= (uint64_t) INT_MAX)
+    {
+      return low + (size_t) arma::randi<arma::uword>(
+          arma::distr_param(0, (int) range));
+    }
+
+    if (range == CounterRNG::max())
+      return low + (size_t) Bits();
+
+    // Reject the smallest 2^64 mod (range + 1) values, so that the remaining
+    // ones are a multiple of range + 1 and every result is equally likely.
+    const uint64_t n = range + 1;
+    const uint64_t threshold = (0 - n) % n;
+    uint64_t x = Bits();
+    while (x < threshold)
+      x = Bits();
+
+    return low + (size_t) (x % n);
+  }
+
+  /**
+   * Fill the given matrix with values uniformly distributed in [0, 1).
+   *
+   * @param m Matrix to fill; its size is not changed.
+   */
+  template<typename MatType>
+  void FillUniform(MatType& m)
+  {
+    if (!seeded)
+    {
+      m.randu();
+      return;
+    }
+
+    typedef typename MatType::elem_type ElemType;
+    ElemType* mem = m.memptr();
+    const CounterRNG& stream = rng;
+    const uint64_t base = rng.Counter();
+    const size_t n = m.n_elem;
+    ENS_PRAGMA_OMP_SIMD
+    for (size_t i = 0; i < n; ++i)
+      mem[i] = UniformValue<ElemType>(stream.At(base + i + 1));
+    rng.Seek(base + n);
+  }
+
+  /**
+   * Fill the given matrix with standard normally distributed values.
+   *
+   * @param m Matrix to fill; its size is not changed.
+   */
+  template<typename MatType>
+  void FillNormal(MatType& m)
+  {
+    if (!seeded)
+    {
+      m.randn();
+      return;
+    }
+
+    // Box-Muller: every pair of uniform values gives two normal values.  The
+    // full pairs are computed without branches, so that the loop vectorizes
+    // (the calls to log(), sin() and cos() only do if the math library has
+    // vector variants, e.g. glibc with -ffast-math).
+    typedef typename MatType::elem_type ElemType;
+    ElemType* mem = m.memptr();
+    const CounterRNG& stream = rng;
+    const uint64_t base = rng.Counter();
+    const size_t n = m.n_elem;
+    const size_t pairs = n / 2;
+    ENS_PRAGMA_OMP_SIMD
+    for (size_t i = 0; i < pairs; ++i)
+    {
+      double r, theta;
+      BoxMuller(stream, base + 2 * i, r, theta);
+      mem[2 * i] = (ElemType) (r * std::cos(theta));
+      mem[2 * i + 1] = (ElemType) (r * std::sin(theta));
+    }
+
+    if (n % 2 == 1)
+    {
+      double r, theta;
+      BoxMuller(stream, base + 2 * pairs, r, theta);
+      mem[n - 1] = (ElemType) (r * std::cos(theta));
+    }
+
+    rng.Seek(base + 2 * ((n + 1) / 2));
+  }
+
+  /**
+   * Return a random permutation of the given vector.
+   *
+   * @param v Vector to shuffle.
+   */
+  template<typename VecType>
+  VecType Shuffle(const VecType& v)
+  {
+    if (!seeded)
+      return arma::shuffle(v);
+
+    // Fisher-Yates.
+    VecType result(v);
+    for (size_t i = result.n_elem; i > 1; --i)
+    {
+      const size_t j = Integer(0, i - 1);
+      std::swap(result[i - 1], result[j]);
+    }
+
+    return result;
+  }
+
+  /**
+   * Shuffle the given vector in place.  Unlike Shuffle(), this does not
+   * allocate, also if the engine is not seeded (the permutation is then drawn
+   * from Armadillo's generator).
+   *
+   * @param v Vector to shuffle.
+   */
+  template<typename VecType>
+  void ShuffleInPlace(VecType& v)
+  {
+    // Fisher-Yates.
+    for (size_t i = v.n_elem; i > 1; --i)
+    {
+      const size_t j = Integer(0, i - 1);
+      std::swap(v[i - 1], v[j]);
+    }
+  }
+
+  /**
+   * Return a random permutation of the indices [0, n).
+   *
+   * @param n Number of indices.
+   */
+  arma::uvec Permutation(const size_t n)
+  {
+    if (n == 0)
+      return arma::uvec();
+
+    if (!seeded)
+      return arma::randperm<arma::uvec>(n);
+
+    return Shuffle(arma::uvec(arma::regspace<arma::uvec>(0, 1, n - 1)));
+  }
+
+ private:
+  //! Map a 64-bit value to a uniformly distributed value in [0, 1).
+  template<typename ElemType>
+  static typename std::enable_if<!std::is_same<ElemType, float>::value,
+      ElemType>::type
+  UniformValue(const uint64_t x)
+  {
+    return (ElemType) CounterRNG::ToUniform(x);
+  }
+
+  //! Map a 64-bit value to a uniformly distributed float in [0, 1).
+  template<typename ElemType>
+  static typename std::enable_if<std::is_same<ElemType, float>::value,
+      float>::type
+  UniformValue(const uint64_t x)
+  {
+    return CounterRNG::ToUniformFloat(x);
+  }
+
+  //! Compute the radius and angle of the Box-Muller transform from the two
+  //! values of the stream after the given position.
+  static void BoxMuller(const CounterRNG& stream,
+                        const uint64_t position,
+                        double& r,
+                        double& theta)
+  {
+    // 1 - u is in (0, 1], so the log is finite.
+    const double u1 = 1.0 - CounterRNG::ToUniform(stream.At(position + 1));
+    const double u2 = CounterRNG::ToUniform(stream.At(position + 2));
+    r = std::sqrt(-2.0 * std::log(u1));
+    theta = 2.0 * arma::datum::pi * u2;
+  }
+
+  //! Draw a uniformly distributed 64-bit value.
+  uint64_t Bits()
+  {
+    // Armadillo's generator gives at most 31 random bits per draw, so hash a
+    // seed drawn from it into 64 bits.
+    return seeded ? rng() : CounterRNG::Mix(CounterRNG::DrawSeed());
+  }
+
+  //! Whether the engine owns a stream.
+  bool seeded;
+  //! The stream of the engine (unused if the engine is not seeded).
+  CounterRNG rng;
+};
+
+} // namespace ens
+
+#endif
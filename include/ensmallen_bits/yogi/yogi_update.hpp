@@ -108,6 +108,16 @@ class YogiUpdate
     void Update(MatType& iterate,
                 const double stepSize,
                 const GradType& gradient)
+    {
+      Step(iterate, gradient, stepSize);
+    }
+
+   private:
+    //! Update the moments and take a step of the given size.
+    template<typename IterateType, typename GType>
+    void Step(IterateType& iterate,
+              const GType& gradient,
+              const double stepSize)
     {
       m *= parent.beta1;
       m += (1 - parent.beta1) * gradient;
@@ -119,7 +129,36 @@ class YogiUpdate
       iterate -= stepSize * m / (arma::sqrt(v) + parent.epsilon);
     }
 
-   private:
+    //! Dense version of Step(): update the moments and the iterate in a single
+    //! pass over the memory.
+    template<typename eT>
+    void Step(arma::Mat<eT>& iterate,
+              const arma::Mat<eT>& gradient,
+              const double stepSize)
+    {
+      const eT beta1 = parent.beta1;
+      const eT beta2 = parent.beta2;
+      const eT epsilon = parent.epsilon;
+      const eT a = stepSize;
+
+      eT* x = iterate.memptr();
+      eT* mMem = m.memptr();
+      eT* vMem = v.memptr();
+      const eT* g = gradient.memptr();
+
+      const size_t n = iterate.n_elem;
+      ENS_PRAGMA_OMP_SIMD
+      for (size_t i = 0; i < n; ++i)
+      {
+        const eT gSquared = g[i] * g[i];
+        const eT d = vMem[i] - gSquared;
+        const eT sign = (eT) ((d > 0) - (d < 0));
+        mMem[i] = beta1 * mMem[i] + (1 - beta1) * g[i];
+        vMem[i] -= (1 - beta2) * sign * gSquared;
+        x[i] -= a * mMem[i] / (std::sqrt(vMem[i]) + epsilon);
+      }
+    }
+
     //! Instantiated parent object.
     YogiUpdate& parent;
 
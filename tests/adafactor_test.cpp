@@ -0,0 +1,189 @@
+/**
+ * @file adafactor_test.cpp
+ *
+ * Tests for the Adafactor optimizer.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+
+#include <ensmallen.hpp>
+#include "catch.hpp"
+#include "test_function_tools.hpp"
+
+using namespace ens;
+using namespace ens::test;
+
+/**
+ * The squared distance of a matrix to a fixed random matrix; the coordinates
+ * are a matrix, so Adafactor factors its second moment estimate.
+ */
+class MatrixDistanceTestFunction
+{
+ public:
+  MatrixDistanceTestFunction(const size_t rows, const size_t cols) :
+      target(rows, cols, arma::fill::randn)
+  { }
+
+  size_t NumFunctions() const { return 1; }
+
+  void Shuffle() { }
+
+  arma::mat GetInitialPoint() const
+  {
+    return arma::zeros(target.n_rows, target.n_cols);
+  }
+
+  const arma::mat& Target() const { return target; }
+
+  double Evaluate(const arma::mat& coordinates,
+                  const size_t /* begin */,
+                  const size_t /* batchSize */) const
+  {
+    return arma::accu(arma::square(coordinates - target));
+  }
+
+  void Gradient(const arma::mat& coordinates,
+                const size_t /* begin */,
+                arma::mat& gradient,
+                const size_t /* batchSize */) const
+  {
+    gradient = 2 * (coordinates - target);
+  }
+
+ private:
+  arma::mat target;
+};
+
+/**
+ * Test the Adafactor optimizer on the Sphere function.
+ */
+TEST_CASE("AdafactorSphereFunctionTest", "[AdafactorTest]")
+{
+  SphereFunction f(2);
+  Adafactor optimizer(0.01, 2, 1e-30, 1.0, 0.8, 0.0, 500000, 1e-3, false);
+
+  arma::mat coordinates = f.GetInitialPoint();
+  optimizer.Optimize(f, coordinates);
+
+  REQUIRE(coordinates(0) == Approx(0.0).margin(0.1));
+  REQUIRE(coordinates(1) == Approx(0.0).margin(0.1));
+}
+
+/**
+ * Test the Adafactor optimizer on the Sphere function with arma::fmat.
+ */
+TEST_CASE("AdafactorSphereFunctionTestFMat", "[AdafactorTest]")
+{
+  SphereFunction f(2);
+  Adafactor optimizer(0.01, 2, 1e-30, 1.0, 0.8, 0.0, 500000, 1e-3, false);
+
+  arma::fmat coordinates = f.GetInitialPoint<arma::fmat>();
+  optimizer.Optimize(f, coordinates);
+
+  REQUIRE(coordinates(0) == Approx(0.0).margin(0.1));
+  REQUIRE(coordinates(1) == Approx(0.0).margin(0.1));
+}
+
+/**
+ * Test the Adafactor optimizer with a first moment estimate on the Sphere
+ * function.
+ */
+TEST_CASE("AdafactorMomentumSphereFunctionTest", "[AdafactorTest]")
+{
+  SphereFunction f(2);
+  Adafactor optimizer(0.01, 2, 1e-30, 1.0, 0.8, 0.9, 500000, 1e-3, false);
+
+  arma::mat coordinates = f.GetInitialPoint();
+  optimizer.Optimize(f, coordinates);
+
+  REQUIRE(coordinates(0) == Approx(0.0).margin(0.1));
+  REQUIRE(coordinates(1) == Approx(0.0).margin(0.1));
+}
+
+/**
+ * Test the Adafactor optimizer on a function of a matrix, where the second
+ * moment estimate is factored.
+ */
+TEST_CASE("AdafactorMatrixFunctionTest", "[AdafactorTest]")
+{
+  MatrixDistanceTestFunction f(10, 8);
+  Adafactor optimizer(0.01, 1, 1e-30, 1.0, 0.8, 0.0, 3000, -1.0, false);
+
+  arma::mat coordinates = f.GetInitialPoint();
+  optimizer.Optimize(f, coordinates);
+
+  CheckMatrices(coordinates, f.Target(), 1e-3);
+}
+
+/**
+ * Make sure that the state of Adafactor for a matrix only has one value per
+ * row and per column, and that for a rank-one squared gradient the factored
+ * estimate takes the same steps as the full one.
+ */
+TEST_CASE("AdafactorFactoredUpdateTest", "[AdafactorTest]")
+{
+  AdafactorUpdate update;
+  AdafactorUpdate::Policy<arma::mat, arma::mat> factored(update, 30, 20);
+  AdafactorUpdate::Policy<arma::mat, arma::mat> full(update, 600, 1);
+
+  REQUIRE(factored.R().n_elem == 30);
+  REQUIRE(factored.C().n_elem == 20);
+  REQUIRE(factored.V().n_elem == 0);
+  REQUIRE(full.R().n_elem == 0);
+  REQUIRE(full.V().n_elem == 600);
+
+  const arma::mat gradient = arma::randn(30, 1) * arma::randn(1, 20);
+  const arma::mat fullGradient = arma::vectorise(gradient);
+  arma::mat factoredIterate(30, 20, arma::fill::randn);
+  arma::mat fullIterate = arma::vectorise(factoredIterate);
+  for (size_t i = 0; i < 5; ++i)
+  {
+    factored.Update(factoredIterate, 0.01, gradient);
+    full.Update(fullIterate, 0.01, fullGradient);
+  }
+
+  CheckMatrices(arma::mat(arma::vectorise(factoredIterate)), fullIterate, 1e-8);
+}
+
+/**
+ * Make sure that momentum can be enabled after the policy is constructed, and
+ * that it then takes the same steps as a policy that had it from the start.
+ */
+TEST_CASE("AdafactorLateMomentumTest", "[AdafactorTest]")
+{
+  AdafactorUpdate late(1e-30, 1.0, 0.8, 0.0);
+  AdafactorUpdate early(1e-30, 1.0, 0.8, 0.9);
+  AdafactorUpdate::Policy<arma::mat, arma::mat> lateDense(late, 30, 20);
+  AdafactorUpdate::Policy<arma::mat, arma::mat> earlyDense(early, 30, 20);
+  AdafactorUpdate::Policy<arma::mat, arma::sp_mat> lateGeneric(late, 30, 20);
+  late.Beta1() = 0.9;
+
+  const arma::mat gradient(30, 20, arma::fill::randn);
+  // A sparse gradient goes through the generic step.
+  const arma::sp_mat sparseGradient(gradient);
+  arma::mat lateIterate(30, 20, arma::fill::randn);
+  arma::mat earlyIterate = lateIterate;
+  arma::mat genericIterate = lateIterate;
+  for (size_t i = 0; i < 5; ++i)
+  {
+    lateDense.Update(lateIterate, 0.01, gradient);
+    earlyDense.Update(earlyIterate, 0.01, gradient);
+    lateGeneric.Update(genericIterate, 0.01, sparseGradient);
+  }
+
+  CheckMatrices(lateIterate, earlyIterate, 1e-10);
+  CheckMatrices(genericIterate, earlyIterate, 1e-8);
+}
+
+/**
+ * Run Adafactor on logistic regression and make sure the results are
+ * acceptable.
+ */
+TEST_CASE("AdafactorLogisticRegressionTest", "[AdafactorTest]")
+{
+  Adafactor optimizer;
+  LogisticRegressionFunctionTest(optimizer, 0.003, 0.006);
+}
@@ -329,3 +329,95 @@ TEST_CASE("AdamResetPolicyTest", "[AdamTest]")
 
   CheckMatrices(coordinatesA, coordinatesB);
 }
+
+/**
+ * Test that the fused kernels used by the Adam family for dense matrices take
+ * the same steps as the generic Armadillo expressions, which are used for
+ * arma::vec.
+ */
+TEMPLATE_TEST_CASE("AdamFamilyFusedUpdateTest", "[AdamTest]", AdamUpdate,
+    AdaMaxUpdate, AMSGradUpdate, NadamUpdate, NadaMaxUpdate,
+    OptimisticAdamUpdate, PadamUpdate, QHAdamUpdate, YogiUpdate,
+    AdaBeliefUpdate, AdaBoundUpdate, AMSBoundUpdate)
+{
+  TestType update;
+  typename TestType::template Policy<arma::mat, arma::mat> fused(update, 50, 1);
+  typename TestType::template Policy<arma::vec, arma::vec> generic(update, 50,
+      1);
+
+  arma::mat fusedIterate(50, 1, arma::fill::randn);
+  arma::vec genericIterate = fusedIterate;
+  for (size_t i = 0; i < 20; ++i)
+  {
+    const arma::mat gradient(50, 1, arma::fill::randn);
+    fused.Update(fusedIterate, 0.01, gradient);
+    generic.Update(genericIterate, 0.01, arma::vec(gradient));
+  }
+
+  CheckMatrices(fusedIterate, arma::mat(genericIterate), 1e-10);
+}
+
+/**
+ * Test the QuantizedAdam optimizer on the Sphere function.
+ */
+TEST_CASE("QuantizedAdamSphereFunctionTest", "[AdamTest]")
+{
+  QuantizedAdam optimizer(0.5, 2, 0.7, 0.999, 1e-8, 500000, 1e-3, false);
+  FunctionTest<SphereFunction>(optimizer, 0.5, 0.2);
+}
+
+/**
+ * Test the QuantizedAdam optimizer on the Sphere function with arma::fmat.
+ */
+TEST_CASE("QuantizedAdamSphereFunctionTestFMat", "[AdamTest]")
+{
+  QuantizedAdam optimizer(0.5, 2, 0.7, 0.999, 1e-8, 500000, 1e-3, false);
+  FunctionTest<SphereFunction, arma::fmat>(optimizer, 0.5, 0.2);
+}
+
+/**
+ * Test the QuantizedAdam optimizer on logistic regression.
+ */
+TEST_CASE("QuantizedAdamLogisticRegressionTest", "[AdamTest]")
+{
+  QuantizedAdam adam;
+  LogisticRegressionFunctionTest(adam, 0.003, 0.006);
+}
+
+/**
+ * Make sure that QuantizedBlocks stores every value to within the resolution
+ * of its block, and uses one byte per value plus one float per block.
+ */
+TEST_CASE("QuantizedBlocksTest", "[AdamTest]")
+{
+  const arma::vec values(5000, arma::fill::randn);
+  const arma::vec squares = arma::square(values);
+
+  QuantizedBlocks signedBlocks(values.n_elem, 256, true);
+  QuantizedBlocks unsignedBlocks(values.n_elem, 256, false);
+  REQUIRE(signedBlocks.Blocks() == 20);
+  REQUIRE(signedBlocks.BlockLength(19) == 5000 - 19 * 256);
+  REQUIRE(signedBlocks.MemoryBytes() == 5000 + 20 * sizeof(float));
+
+  arma::vec decoded(values.n_elem);
+  arma::vec decodedSquares(values.n_elem);
+  for (size_t b = 0; b < signedBlocks.Blocks(); ++b)
+  {
+    const size_t offset = b * 256;
+    signedBlocks.Encode(b, values.memptr() + offset);
+    signedBlocks.Decode(b, decoded.memptr() + offset);
+    unsignedBlocks.Encode(b, squares.memptr() + offset);
+    unsignedBlocks.Decode(b, decodedSquares.memptr() + offset);
+
+    const arma::span block(offset,
+        offset + signedBlocks.BlockLength(b) - 1);
+    const double maxAbs = arma::abs(values(block)).max();
+    REQUIRE(arma::abs(decoded(block) - values(block)).max() <=
+        maxAbs / 127 * 1.001);
+    REQUIRE(arma::abs(decodedSquares(block) - squares(block)).max() <=
+        maxAbs * maxAbs / 255 * 1.001);
+  }
+
+  // A positive value must never be decoded as 0.
+  REQUIRE(arma::all(decodedSquares(arma::find(squares > 0)) > 0));
+}
@@ -0,0 +1,366 @@
+/**
+ * @file allocation_test.cpp
+ *
+ * Check that the steady-state loops of the optimizers do not allocate memory.
+ * Every heap allocation made through the global operator new or through
+ * Armadillo's memory manager is counted, and a callback checks that the count
+ * does not change once the optimizer has warmed up.
+ *
+ * This file is compiled into its own test program (ensmallen_allocation_tests),
+ * because the allocator hooks must be defined before Armadillo is included and
+ * the replacement operator new applies to the whole program.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace ens {
+namespace test {
+
+//! The number of heap allocations made so far.
+std::atomic<size_t> allocations(0);
+
+//! Whether allocations of the calling thread are currently not counted.
+thread_local bool allocationsPaused = false;
+
+//! Count an allocation, unless counting is paused.
+inline void CountAllocation()
+{
+  if (!allocationsPaused)
+    ++allocations;
+}
+
+//! The memory allocation function given to Armadillo.
+inline void* CountingMalloc(const size_t n)
+{
+  CountAllocation();
+  return std::malloc(n);
+}
+
+//! The memory release function given to Armadillo.
+inline void CountingFree(void* mem)
+{
+  std::free(mem);
+}
+
+} // namespace test
+} // namespace ens
+
+#define ARMA_ALIEN_MEM_ALLOC_FUNCTION ens::test::CountingMalloc
+#define ARMA_ALIEN_MEM_FREE_FUNCTION ens::test::CountingFree
+
+#include <ensmallen.hpp>
+
+#define CATCH_CONFIG_RUNNER
+#include "catch.hpp"
+
+void* operator new(std::size_t n)
+{
+  ens::test::CountAllocation();
+  if (void* mem = std::malloc(n > 0 ? n : 1))
+    return mem;
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t n)
+{
+  return operator new(n);
+}
+
+void operator delete(void* mem) noexcept { std::free(mem); }
+void operator delete[](void* mem) noexcept { std::free(mem); }
+void operator delete(void* mem, std::size_t) noexcept { std::free(mem); }
+void operator delete[](void* mem, std::size_t) noexcept { std::free(mem); }
+
+using namespace ens;
+using namespace ens::test;
+
+/**
+ * Stop counting the allocations of the calling thread while in scope.
+ */
+class PauseAllocationCounting
+{
+ public:
+  PauseAllocationCounting() : paused(allocationsPaused)
+  {
+    allocationsPaused = true;
+  }
+
+  ~PauseAllocationCounting() { allocationsPaused = paused; }
+
+ private:
+  //! Whether counting was paused before.
+  bool paused;
+};
+
+/**
+ * Callback that counts the allocations made after the first few steps of an
+ * optimization.  If the optimizer calls StepTaken() from several threads (as
+ * ParallelSGD does), count the calls to Evaluate() instead.
+ */
+class AllocationGuard
+{
+ public:
+  /**
+   * @param warmup Number of steps after which allocations are counted.
+   * @param countEvaluations If true, count calls to Evaluate() as steps.
+   */
+  AllocationGuard(const size_t warmup, const bool countEvaluations = false) :
+      warmup(warmup),
+      countEvaluations(countEvaluations),
+      steps(0),
+      start(0),
+      end(0)
+  { /* Nothing to do. */ }
+
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void StepTaken(OptimizerType& /* optimizer */,
+                 FunctionType& /* function */,
+                 MatType& /* coordinates */)
+  {
+    if (!countEvaluations)
+      Step();
+  }
+
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void Evaluate(OptimizerType& /* optimizer */,
+                FunctionType& /* function */,
+                const MatType& /* coordinates */,
+                const double /* objective */)
+  {
+    if (countEvaluations)
+      Step();
+  }
+
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void EndOptimization(OptimizerType& /* optimizer */,
+                       FunctionType& /* function */,
+                       MatType& /* coordinates */)
+  {
+    end = allocations;
+  }
+
+  //! Get the number of steps taken.
+  size_t Steps() const { return steps; }
+
+  //! Get the number of allocations made after the warmup.
+  size_t Allocations() const { return (steps > warmup) ? end - start : 0; }
+
+ private:
+  //! Count a step; start counting allocations at the end of the warmup.
+  void Step()
+  {
+    if (++steps == warmup)
+      start = allocations;
+  }
+
+  //! The number of steps after which allocations are counted.
+  size_t warmup;
+  //! Whether calls to Evaluate() are counted as steps.
+  bool countEvaluations;
+  //! The number of steps taken.
+  size_t steps;
+  //! The allocation count at the end of the warmup.
+  size_t start;
+  //! The allocation count at the end of the optimization.
+  size_t end;
+};
+
+/**
+ * A separable quadratic whose i-th function is (x_i - i / n)^2; nothing in it
+ * allocates.
+ */
+class QuadraticTestFunction
+{
+ public:
+  QuadraticTestFunction(const size_t dimensions) : dimensions(dimensions) { }
+
+  size_t NumFunctions() const { return dimensions; }
+
+  void Shuffle() { }
+
+  arma::mat GetInitialPoint() const { return arma::ones(dimensions, 1); }
+
+  double Evaluate(const arma::mat& coordinates) const
+  {
+    return Evaluate(coordinates, 0, dimensions);
+  }
+
+  double Evaluate(const arma::mat& coordinates,
+                  const size_t begin,
+                  const size_t batchSize) const
+  {
+    double objective = 0.0;
+    for (size_t i = begin; i < begin + batchSize; ++i)
+    {
+      const double d = coordinates[i] - Center(i);
+      objective += d * d;
+    }
+
+    return objective;
+  }
+
+  void Gradient(const arma::mat& coordinates,
+                const size_t begin,
+                arma::mat& gradient,
+                const size_t batchSize) const
+  {
+    gradient.zeros(coordinates.n_rows, coordinates.n_cols);
+    for (size_t i = begin; i < begin + batchSize; ++i)
+      gradient[i] = 2.0 * (coordinates[i] - Center(i));
+  }
+
+  //! The sparse gradient used by ParallelSGD; Armadillo's sparse matrices
+  //! allocate on every change, so this is not counted.
+  void Gradient(const arma::mat& coordinates,
+                const size_t i,
+                arma::sp_mat& gradient,
+                const size_t /* batchSize */) const
+  {
+    PauseAllocationCounting pause;
+    gradient.zeros(coordinates.n_rows, coordinates.n_cols);
+    gradient[i] = 2.0 * (coordinates[i] - Center(i));
+  }
+
+  double EvaluateWithGradient(const arma::mat& coordinates,
+                              const size_t begin,
+                              arma::mat& gradient,
+                              const size_t batchSize) const
+  {
+    Gradient(coordinates, begin, gradient, batchSize);
+    return Evaluate(coordinates, begin, batchSize);
+  }
+
+ private:
+  double Center(const size_t i) const { return (double) i / dimensions; }
+
+  size_t dimensions;
+};
+
+/**
+ * The generalized Rosenbrock function, written with loops so that nothing in
+ * it allocates; L-BFGS needs many iterations to minimize it.
+ */
+class RosenbrockTestFunction
+{
+ public:
+  RosenbrockTestFunction(const size_t dimensions) : dimensions(dimensions) { }
+
+  arma::mat GetInitialPoint() const
+  {
+    arma::mat point(dimensions, 1);
+    for (size_t i = 0; i < dimensions; ++i)
+      point[i] = (i % 2 == 0) ? -1.2 : 1.0;
+    return point;
+  }
+
+  double Evaluate(const arma::mat& coordinates) const
+  {
+    double objective = 0.0;
+    for (size_t i = 0; i + 1 < dimensions; ++i)
+    {
+      const double a = coordinates[i + 1] - coordinates[i] * coordinates[i];
+      const double b = 1.0 - coordinates[i];
+      objective += 100.0 * a * a + b * b;
+    }
+
+    return objective;
+  }
+
+  void Gradient(const arma::mat& coordinates, arma::mat& gradient) const
+  {
+    gradient.zeros(coordinates.n_rows, coordinates.n_cols);
+    for (size_t i = 0; i + 1 < dimensions; ++i)
+    {
+      const double a = coordinates[i + 1] - coordinates[i] * coordinates[i];
+      gradient[i] += -400.0 * a * coordinates[i] - 2.0 * (1.0 - coordinates[i]);
+      gradient[i + 1] += 200.0 * a;
+    }
+  }
+
+  double EvaluateWithGradient(const arma::mat& coordinates,
+                              arma::mat& gradient) const
+  {
+    Gradient(coordinates, gradient);
+    return Evaluate(coordinates);
+  }
+
+ private:
+  size_t dimensions;
+};
+
+/**
+ * Make sure that the SGD loop does not allocate with any of the update
+ * policies that are implemented without temporaries (for the Adam family, with
+ * fused kernels).  The problem has more than 16 elements, so Armadillo does not
+ * use its local memory.
+ */
+TEMPLATE_TEST_CASE("SGDUpdatePolicyAllocationTest", "[AllocationTest]",
+    VanillaUpdate, MomentumUpdate, NesterovMomentumUpdate, QHUpdate,
+    AdaGradUpdate, RMSPropUpdate, AdamUpdate, AdaMaxUpdate, AMSGradUpdate,
+    NadamUpdate, NadaMaxUpdate, OptimisticAdamUpdate, PadamUpdate,
+    QHAdamUpdate, YogiUpdate, AdaBeliefUpdate, AdaBoundUpdate, AMSBoundUpdate,
+    QuantizedAdamUpdate, AdafactorUpdate, LARSUpdate, LAMBUpdate)
+{
+  QuadraticTestFunction f(64);
+  arma::mat coordinates = f.GetInitialPoint();
+
+  // 10 epochs of 8 steps each, without shuffling.
+  SGD<TestType> optimizer(0.01, 8, 640, -1.0, false);
+
+  AllocationGuard guard(16);
+  optimizer.Optimize(f, coordinates, guard);
+
+  REQUIRE(guard.Steps() == 80);
+  REQUIRE(guard.Allocations() == 0);
+}
+
+/**
+ * Make sure that the L-BFGS loop (including the line search) does not
+ * allocate.  The warmup is longer than the number of stored basis vectors,
+ * because the cubes holding them create their slices on first use.
+ */
+TEST_CASE("LBFGSAllocationTest", "[AllocationTest]")
+{
+  RosenbrockTestFunction f(64);
+  arma::mat coordinates = f.GetInitialPoint();
+
+  L_BFGS optimizer(5, 100);
+  optimizer.MinGradientNorm() = 0.0;
+  optimizer.Factr() = 0.0;
+
+  AllocationGuard guard(10);
+  optimizer.Optimize(f, coordinates, guard);
+
+  REQUIRE(guard.Steps() > 10);
+  REQUIRE(guard.Allocations() == 0);
+}
+
+/**
+ * Make sure that the ParallelSGD loop, including the shuffle of the visitation
+ * order, does not allocate outside of the (sparse) gradient computation.
+ */
+TEST_CASE("ParallelSGDAllocationTest", "[AllocationTest]")
+{
+  QuadraticTestFunction f(64);
+  arma::mat coordinates = f.GetInitialPoint();
+
+  ParallelSGD<> optimizer(50, 16, -1.0, true);
+
+  AllocationGuard guard(5, true);
+  optimizer.Optimize(f, coordinates, guard);
+
+  REQUIRE(guard.Steps() == 49);
+  REQUIRE(guard.Allocations() == 0);
+}
+
+int main(int argc, char** argv)
+{
+  return Catch::Session().run(argc, argv);
+}
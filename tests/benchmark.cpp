@@ -0,0 +1,148 @@
+/**
+ * @file benchmark.cpp
+ *
+ * Run a few optimizers on problems of increasing size and report the time and
+ * the hardware performance counters of every run, to find out whether an
+ * optimizer is compute-bound or memory-bound at a given parameter size.
+ *
+ *   ensmallen_benchmark [size...]
+ *
+ * The default sizes are 100, 10000 and 1000000 coordinates.  Hardware counters
+ * need Linux and access to perf events (see perf_event_paranoid); without them
+ * only the time is reported.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+
+// Read the hardware performance counters.
+#define ENS_USE_PERF_EVENTS
+#include <ensmallen.hpp>
+#include <iomanip>
+
+using namespace ens;
+using namespace ens::test;
+
+/**
+ * Print one row of the report.
+ */
+void PrintRow(const std::string& optimizer,
+              const std::string& problem,
+              const size_t size,
+              const PerfCounters& counters)
+{
+  std::cout << std::left << std::setw(10) << optimizer << std::setw(26)
+      << problem << std::right << std::setw(9) << size << std::setw(11)
+      << std::fixed << std::setprecision(4) << counters.Seconds();
+
+  if (!counters.Available())
+  {
+    std::cout << std::endl;
+    return;
+  }
+
+  const double cycles = counters.Count(PerfCounters::CYCLES);
+  const double instructions = counters.Count(PerfCounters::INSTRUCTIONS);
+  const double cacheMisses = counters.Count(PerfCounters::CACHE_MISSES);
+  const double branchMisses = counters.Count(PerfCounters::BRANCH_MISSES);
+
+  // Instructions per cycle, and cache and branch misses per thousand
+  // instructions.
+  std::cout << std::setw(16) << std::setprecision(0) << cycles
+      << std::setw(16) << instructions
+      << std::setw(7) << std::setprecision(2)
+      << (cycles > 0 ? instructions / cycles : 0.0)
+      << std::setw(10) << std::setprecision(3)
+      << (instructions > 0 ? 1000 * cacheMisses / instructions : 0.0)
+      << std::setw(10)
+      << (instructions > 0 ? 1000 * branchMisses / instructions : 0.0)
+      << std::endl;
+}
+
+/**
+ * Optimize the given function from its initial point and report the run.
+ */
+template<typename OptimizerType, typename FunctionType>
+void Run(const std::string& optimizerName,
+         OptimizerType& optimizer,
+         const std::string& problemName,
+         FunctionType& function,
+         const size_t size)
+{
+  arma::mat coordinates = function.GetInitialPoint();
+
+  PerfCounters counters;
+  counters.Start();
+  optimizer.Optimize(function, coordinates);
+  counters.Stop();
+
+  PrintRow(optimizerName, problemName, size, counters);
+}
+
+/**
+ * Run every optimizer on the given problem.
+ */
+template<typename FunctionType>
+void RunAll(const std::string& problemName,
+            FunctionType& function,
+            const size_t size)
+{
+  // A fixed number of steps per optimizer, independent of convergence; the
+  // maximum number of iterations of the SGD variants counts functions.
+  const size_t steps = 100;
+  const size_t batchSize = 32;
+  const size_t iterations = steps * batchSize;
+
+  StandardSGD sgd(0.0001, batchSize, iterations, -1.0);
+  Run("SGD", sgd, problemName, function, size);
+
+  Adam adam(0.0001, batchSize, 0.9, 0.999, 1e-8, iterations, -1.0);
+  Run("Adam", adam, problemName, function, size);
+
+  L_BFGS lbfgs(10, steps);
+  lbfgs.MinGradientNorm() = 0.0;
+  lbfgs.Factr() = 0.0;
+  Run("L_BFGS", lbfgs, problemName, function, size);
+}
+
+int main(int argc, char** argv)
+{
+  std::vector<size_t> sizes;
+  for (int i = 1; i < argc; ++i)
+    sizes.push_back(std::strtoul(argv[i], NULL, 10));
+  if (sizes.empty())
+    sizes = { 100, 10000, 1000000 };
+
+  PerfCounters probe;
+  if (!probe.Available())
+  {
+    std::cout << "Hardware performance counters are not available; only the "
+        << "time is reported." << std::endl;
+  }
+
+  std::cout << std::left << std::setw(10) << "optimizer" << std::setw(26)
+      << "problem" << std::right << std::setw(9) << "size" << std::setw(11)
+      << "time (s)";
+  if (probe.Available())
+  {
+    std::cout << std::setw(16) << "cycles" << std::setw(16) << "instructions"
+        << std::setw(7) << "IPC" << std::setw(10) << "LLC/kI" << std::setw(10)
+        << "br/kI";
+  }
+  std::cout << std::endl;
+
+  for (size_t i = 0; i < sizes.size(); ++i)
+  {
+    const size_t size = std::max(sizes[i], (size_t) 2);
+
+    SphereFunction sphere(size);
+    RunAll("SphereFunction", sphere, size);
+
+    GeneralizedRosenbrockFunction rosenbrock(size);
+    RunAll("GeneralizedRosenbrock", rosenbrock, size);
+  }
+
+  return 0;
+}
@@ -645,6 +645,106 @@ TEST_CASE("PrintLossCallbackTest", "[CallbacksTest]")
   REQUIRE(stream.str().length() > 0);
 }
 
+/**
+ * Count the occurrences of the given string.
+ */
+size_t CountOccurrences(const std::string& s, const std::string& sub)
+{
+  size_t count = 0;
+  for (size_t pos = s.find(sub); pos != std::string::npos;
+      pos = s.find(sub, pos + sub.size()))
+    ++count;
+
+  return count;
+}
+
+/**
+ * Make sure the ProfileTrace callback records every hook and writes one span
+ * per phase, iteration and epoch.
+ */
+TEST_CASE("ProfileTraceCallbackTest", "[CallbacksTest]")
+{
+  SGDTestFunction f;
+  arma::mat coordinates = f.GetInitialPoint();
+
+  // Two epochs of three iterations.
+  StandardSGD s(0.0003, 1, 6, -1.0, true);
+
+  ProfileTrace profiler("");
+  s.Optimize(f, coordinates, profiler);
+
+  // BeginOptimization(), three BeginEpoch(), two EndEpoch(), six Evaluate(),
+  // Gradient() and StepTaken(), and EndOptimization().
+  REQUIRE(profiler.Events() == 25);
+  REQUIRE(profiler.Dropped() == 0);
+
+  std::stringstream stream;
+  profiler.Write(stream);
+  const std::string trace = stream.str();
+  REQUIRE(CountOccurrences(trace, "\"Iteration ") == 6);
+  REQUIRE(CountOccurrences(trace, "\"Update\"") == 6);
+  REQUIRE(CountOccurrences(trace, "\"Epoch ") == 2);
+  REQUIRE(CountOccurrences(trace, "\"Callbacks\"") == 0);
+
+  // With the marker every hook but BeginOptimization() and EndOptimization()
+  // is followed by a mark.
+  profiler.Clear();
+  coordinates = f.GetInitialPoint();
+  s.Optimize(f, coordinates, profiler, PrintLoss(stream), profiler.Marker());
+  REQUIRE(profiler.Events() == 48);
+
+  std::stringstream markedStream;
+  profiler.Write(markedStream);
+  REQUIRE(CountOccurrences(markedStream.str(), "\"Callbacks\"") == 23);
+
+  // A small buffer keeps only the latest events.
+  ProfileTrace small("", 4);
+  coordinates = f.GetInitialPoint();
+  s.Optimize(f, coordinates, small);
+  REQUIRE(small.Events() == 4);
+  REQUIRE(small.Dropped() == 21);
+}
+
+/**
+ * Make sure the PrometheusMetrics callback writes the metrics file.
+ */
+TEST_CASE("PrometheusMetricsCallbackTest", "[CallbacksTest]")
+{
+  SGDTestFunction f;
+  arma::mat coordinates = f.GetInitialPoint();
+
+  // Two epochs of three iterations.
+  StandardSGD s(0.0003, 1, 6, -1.0, true);
+
+  // With an interval of 0 the file is written after every step and epoch.
+  const std::string filename = "prometheus_metrics_test.prom";
+  PrometheusMetrics metrics(filename, 0.0, "test");
+  s.Optimize(f, coordinates, metrics);
+
+  REQUIRE(metrics.Iterations() == 6);
+  REQUIRE(metrics.Epochs() == 2);
+  REQUIRE(metrics.Evaluations() == 6);
+  REQUIRE(metrics.GradientEvaluations() == 6);
+  REQUIRE(metrics.Writes() == 10);
+
+  std::ifstream stream(filename.c_str());
+  REQUIRE(stream.is_open());
+  std::stringstream contents;
+  contents << stream.rdbuf();
+  const std::string text = contents.str();
+
+  REQUIRE(text.find("# TYPE test_iterations_total counter") !=
+      std::string::npos);
+  REQUIRE(text.find("\ntest_iterations_total 6\n") != std::string::npos);
+  REQUIRE(text.find("\ntest_epochs_total 2\n") != std::string::npos);
+  REQUIRE(text.find("\ntest_step_size ") != std::string::npos);
+  REQUIRE(text.find("\ntest_gradient_norm ") != std::string::npos);
+  REQUIRE(text.find("\ntest_running 0\n") != std::string::npos);
+
+  stream.close();
+  std::remove(filename.c_str());
+}
+
 /**
  * Make sure the ProgressBar callback will show the progress on the specified
  * output stream.
@@ -163,3 +163,19 @@ TEST_CASE("CNESchafferFunctionN2Test", "[CNETest]")
   CNE optimizer(500, 1600, 0.3, 0.3, 0.3, -1);
   FunctionTest<SchafferFunctionN2>(optimizer, 0.5, 0.1, 7);
 }
+
+/**
+ * Make sure that evaluating the candidates on several threads gives the same
+ * result as evaluating them serially.
+ */
+TEST_CASE("CNEParallelMatchesSerialTest", "[CNETest]")
+{
+  RosenbrockFunction f;
+  CNE serialOpt(50, 100, 0.2, 0.2, 0.2, -1);
+  CNE parallelOpt(50, 100, 0.2, 0.2, 0.2, -1, 0);
+
+  const double objective = CheckParallelMatchesSerial(f, serialOpt,
+      parallelOpt, f.GetInitialPoint(),
+      [](CNE& opt) { opt.Engine() = RandomEngine(7); });
+  REQUIRE(objective < f.Evaluate(f.GetInitialPoint()));
+}
@@ -33,3 +33,19 @@ TEST_CASE("DELogisticRegressionFMatTest", "[DETest]")
   DE opt(200, 1000, 0.6, 0.8, 1e-5);
   LogisticRegressionFunctionTest<arma::fmat>(opt, 0.03, 0.06, 3);
 }
+
+/**
+ * Make sure that evaluating the trial vectors on several threads gives the same
+ * result as evaluating them serially.
+ */
+TEST_CASE("DEParallelMatchesSerialTest", "[DETest]")
+{
+  RosenbrockFunction f;
+  DE serialOpt(50, 100, 0.6, 0.8, -1);
+  DE parallelOpt(50, 100, 0.6, 0.8, -1, 0);
+
+  const double objective = CheckParallelMatchesSerial(f, serialOpt,
+      parallelOpt, f.GetInitialPoint(),
+      [](DE& opt) { opt.Engine() = RandomEngine(7); });
+  REQUIRE(objective < f.Evaluate(f.GetInitialPoint()));
+}
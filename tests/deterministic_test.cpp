@@ -0,0 +1,80 @@
+/**
+ * @file deterministic_test.cpp
+ *
+ * Check that the parallel code paths give bitwise identical results for any
+ * number of threads when ENS_DETERMINISTIC is defined.
+ *
+ * This file is compiled into its own test program
+ * (ensmallen_deterministic_tests), because ENS_DETERMINISTIC changes inline
+ * code and must be the same in every translation unit of a program.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+
+#define ENS_DETERMINISTIC
+#include <ensmallen.hpp>
+
+#define CATCH_CONFIG_RUNNER
+#include "catch.hpp"
+
+using namespace ens;
+using namespace ens::test;
+
+/**
+ * Make sure that sharded mini-batches give the same result with any number of
+ * threads.
+ */
+TEST_CASE("SGDDeterministicThreadsTest", "[DeterministicTest]")
+{
+  GeneralizedRosenbrockFunction f(20);
+
+  arma::mat reference;
+  for (size_t threads = 2; threads <= 8; threads *= 2)
+  {
+    arma::mat coordinates = f.GetInitialPoint();
+    StandardSGD s(0.001, f.NumFunctions(), 10000, -1.0, false, VanillaUpdate(),
+        NoDecay(), true, false, threads);
+    s.Optimize(f, coordinates);
+
+    REQUIRE(coordinates.is_finite());
+    if (threads == 2)
+      reference = coordinates;
+    else
+      REQUIRE(arma::approx_equal(coordinates, reference, "absdiff", 0.0));
+  }
+}
+
+/**
+ * Make sure that ParallelSGD gives the same result with any number of threads.
+ */
+TEST_CASE("ParallelSGDDeterministicThreadsTest", "[DeterministicTest]")
+{
+  SparseTestFunction f;
+
+  arma::mat reference;
+  for (size_t threads = 1; threads <= 8; threads *= 2)
+  {
+    #ifdef ENS_USE_OPENMP
+      omp_set_num_threads(threads);
+    #endif
+
+    arma::mat coordinates = f.GetInitialPoint();
+    ParallelSGD<ConstantStep> s(1000, 1, -1.0, true, ConstantStep(0.4));
+    s.Engine() = RandomEngine(11);
+    s.Optimize(f, coordinates);
+
+    REQUIRE(coordinates.is_finite());
+    if (threads == 1)
+      reference = coordinates;
+    else
+      REQUIRE(arma::approx_equal(coordinates, reference, "absdiff", 0.0));
+  }
+}
+
+int main(int argc, char** argv)
+{
+  return Catch::Session().run(argc, argv);
+}
@@ -721,3 +721,385 @@ TEST_CASE("ResolvableFunctionTypeCheckTest", "[FunctionTest]")
   static_assert(!CheckPartialGradient<D, arma::mat, arma::sp_mat>::value,
       "CheckPartialGradient static check failed.");
 }
+
+/**
+ * Utility class with Evaluate() and EvaluateBatch(); the squared norm of the
+ * coordinates is the objective.
+ */
+class BatchTestFunction
+{
+ public:
+  BatchTestFunction() : evaluateCalls(0), batchCalls(0) { }
+
+  double Evaluate(const arma::mat& coordinates)
+  {
+    ++evaluateCalls;
+    return arma::accu(arma::square(coordinates));
+  }
+
+  void EvaluateBatch(const arma::mat& candidates, arma::rowvec& values)
+  {
+    ++batchCalls;
+    values = arma::sum(arma::square(candidates), 0);
+  }
+
+  size_t evaluateCalls;
+  size_t batchCalls;
+};
+
+/**
+ * Utility class with a const EvaluateBatch().
+ */
+class ConstBatchTestFunction
+{
+ public:
+  double Evaluate(const arma::mat& coordinates) const
+  {
+    return arma::accu(coordinates);
+  }
+
+  void EvaluateBatch(const arma::mat& candidates, arma::rowvec& values) const
+  {
+    values = arma::sum(candidates, 0);
+  }
+};
+
+/**
+ * Make sure EvaluateBatch() is detected in all its forms.
+ */
+TEST_CASE("HasEvaluateBatchSignatureTest", "[FunctionTest]")
+{
+  static_assert(HasEvaluateBatchSignature<BatchTestFunction,
+      arma::mat>::value, "HasEvaluateBatchSignature check failed.");
+  static_assert(HasEvaluateBatchSignature<ConstBatchTestFunction,
+      arma::mat>::value, "HasEvaluateBatchSignature check failed.");
+  static_assert(!HasEvaluateBatchSignature<BatchTestFunction,
+      arma::fmat>::value, "HasEvaluateBatchSignature check failed.");
+  static_assert(!HasEvaluateBatchSignature<EvaluateTestFunction,
+      arma::mat>::value, "HasEvaluateBatchSignature check failed.");
+}
+
+/**
+ * Make sure that a population is handed to EvaluateBatch() in one call if
+ * possible, and that the fallback gives the same values.
+ */
+TEST_CASE("EvaluatePopulationTest", "[FunctionTest]")
+{
+  std::vector<arma::mat> population(10);
+  for (size_t i = 0; i < population.size(); ++i)
+    population[i] = arma::randn(3, 2);
+
+  BatchTestFunction f;
+  arma::vec batchValues;
+  EvaluatePopulation(f, population, batchValues);
+  REQUIRE(f.batchCalls == 1);
+  REQUIRE(f.evaluateCalls == 0);
+
+  // The fallback for a function without EvaluateBatch().
+  SphereFunction sphere(6);
+  arma::vec values;
+  EvaluatePopulation(sphere, population, values);
+  REQUIRE(values.n_elem == population.size());
+
+  arma::mat candidates(6, population.size());
+  for (size_t i = 0; i < population.size(); ++i)
+  {
+    candidates.col(i) = arma::vectorise(population[i]);
+    REQUIRE(batchValues(i) == Approx(arma::accu(arma::square(population[i]))));
+  }
+
+  arma::rowvec columnValues;
+  EvaluateBatch(sphere, candidates, 3, 2, columnValues);
+  REQUIRE(arma::approx_equal(columnValues.t(), values, "absdiff", 1e-10));
+}
+
+/**
+ * Make sure a population-based optimizer uses EvaluateBatch().
+ */
+TEST_CASE("EvaluateBatchOptimizerTest", "[FunctionTest]")
+{
+  BatchTestFunction f;
+  arma::mat coordinates("1.0; -1.0; 0.5");
+
+  CNE optimizer(50, 200, 0.2, 0.2, 0.2, -1);
+  optimizer.Optimize(f, coordinates);
+
+  REQUIRE(f.batchCalls == 200);
+  REQUIRE(arma::norm(coordinates) < 0.2);
+}
+
+/**
+ * Utility class for a separable function with EvaluateBatch(); the squared norm
+ * of the coordinates is the objective.
+ */
+class SeparableBatchTestFunction
+{
+ public:
+  SeparableBatchTestFunction() : evaluateCalls(0), batchCalls(0) { }
+
+  size_t NumFunctions() const { return 1; }
+
+  void Shuffle() { }
+
+  double Evaluate(const arma::mat& coordinates,
+                  const size_t /* begin */,
+                  const size_t /* batchSize */)
+  {
+    ++evaluateCalls;
+    return arma::accu(arma::square(coordinates));
+  }
+
+  void EvaluateBatch(const arma::mat& candidates, arma::rowvec& values)
+  {
+    ++batchCalls;
+    values = arma::sum(arma::square(candidates), 0);
+  }
+
+  size_t evaluateCalls;
+  size_t batchCalls;
+};
+
+/**
+ * Make sure CMA-ES scores every generation with a single EvaluateBatch() call
+ * when the full dataset is selected.
+ */
+TEST_CASE("EvaluateBatchCMAESTest", "[FunctionTest]")
+{
+  SeparableBatchTestFunction f;
+  arma::mat coordinates("1.0; -1.0; 0.5");
+
+  CMAES<FullSelection, EmptyTransformation<>> optimizer(20,
+      EmptyTransformation<>(), 1, 50, -1);
+  optimizer.Optimize(f, coordinates);
+
+  // One batch per generation; the separable Evaluate() is only called for
+  // the starting point and the mean of every generation.
+  REQUIRE(f.batchCalls > 0);
+  REQUIRE(f.evaluateCalls == f.batchCalls + 1);
+  REQUIRE(arma::norm(coordinates) < 0.2);
+}
+
+/**
+ * Utility class with Evaluate() and Gradient() that counts its calls.
+ */
+class CountingTestFunction
+{
+ public:
+  CountingTestFunction() : evaluateCalls(0), gradientCalls(0) { }
+
+  double Evaluate(const arma::mat& coordinates)
+  {
+    ++evaluateCalls;
+    return arma::accu(arma::square(coordinates));
+  }
+
+  void Gradient(const arma::mat& coordinates, arma::mat& gradient)
+  {
+    ++gradientCalls;
+    gradient = 2 * coordinates;
+  }
+
+  size_t evaluateCalls;
+  size_t gradientCalls;
+};
+
+/**
+ * Make sure MemoizedFunction answers repeated calls from its cache.
+ */
+TEST_CASE("MemoizedFunctionTest", "[FunctionTest]")
+{
+  CountingTestFunction f;
+  MemoizedFunction<CountingTestFunction> memoized(f, 2);
+
+  arma::mat a("1.0; 2.0");
+  arma::mat b("-1.0; 3.0");
+  arma::mat c("0.5; 0.5");
+  arma::mat gradient;
+
+  REQUIRE(memoized.Evaluate(a) == Approx(5.0));
+  REQUIRE(memoized.Evaluate(a) == Approx(5.0));
+  REQUIRE(f.evaluateCalls == 1);
+
+  memoized.Gradient(a, gradient);
+  memoized.Gradient(a, gradient);
+  REQUIRE(f.gradientCalls == 1);
+  REQUIRE(arma::approx_equal(gradient, 2 * a, "absdiff", 1e-10));
+
+  // The objective and the gradient of a are known now.
+  REQUIRE(memoized.EvaluateWithGradient(a, gradient) == Approx(5.0));
+  REQUIRE(f.evaluateCalls == 1);
+  REQUIRE(f.gradientCalls == 1);
+
+  // EvaluateWithGradient() is derived from Evaluate() and Gradient().
+  REQUIRE(memoized.EvaluateWithGradient(b, gradient) == Approx(10.0));
+  REQUIRE(f.evaluateCalls == 2);
+  REQUIRE(f.gradientCalls == 2);
+  REQUIRE(memoized.Size() == 2);
+
+  // Inserting c evicts a, the least recently used entry.
+  memoized.Evaluate(c);
+  memoized.Evaluate(b);
+  memoized.Evaluate(a);
+  REQUIRE(memoized.Size() == 2);
+  REQUIRE(f.evaluateCalls == 4);
+  REQUIRE(memoized.Hits() == 4);
+  REQUIRE(memoized.Misses() == 5);
+
+  memoized.Clear();
+  REQUIRE(memoized.Size() == 0);
+}
+
+/**
+ * Make sure an optimizer can use a MemoizedFunction.
+ */
+TEST_CASE("MemoizedFunctionOptimizerTest", "[FunctionTest]")
+{
+  RosenbrockFunction f;
+  MemoizedFunction<RosenbrockFunction> memoized(f);
+
+  arma::mat coordinates = f.GetInitialPoint();
+  L_BFGS optimizer;
+  optimizer.Optimize(memoized, coordinates);
+
+  REQUIRE(coordinates(0) == Approx(1.0).epsilon(1e-5));
+  REQUIRE(coordinates(1) == Approx(1.0).epsilon(1e-5));
+  REQUIRE(memoized.Misses() > 0);
+}
+
+/**
+ * Make sure InstrumentedFunction has exactly the methods of the function it
+ * wraps.
+ */
+TEST_CASE("InstrumentedFunctionTypeCheckTest", "[FunctionTest]")
+{
+  static_assert(CheckNumFunctions<InstrumentedFunction<A>, arma::mat,
+      arma::mat>::value, "CheckNumFunctions static check failed.");
+  static_assert(CheckSeparableEvaluate<InstrumentedFunction<B>, arma::mat,
+      arma::mat>::value, "CheckSeparableEvaluate static check failed.");
+  static_assert(CheckSparseGradient<InstrumentedFunction<A>, arma::mat,
+      arma::sp_mat>::value, "CheckSparseGradient static check failed.");
+  static_assert(CheckPartialGradient<InstrumentedFunction<B>, arma::mat,
+      arma::sp_mat>::value, "CheckPartialGradient static check failed.");
+  static_assert(!CheckSeparableEvaluate<InstrumentedFunction<C>, arma::mat,
+      arma::mat>::value, "CheckSeparableEvaluate static check failed.");
+  static_assert(!CheckNumFunctions<InstrumentedFunction<D>, arma::mat,
+      arma::mat>::value, "CheckNumFunctions static check failed.");
+
+  static_assert(CheckEvaluate<InstrumentedFunction<C>, arma::mat,
+      arma::mat>::value, "CheckEvaluate static check failed.");
+  static_assert(CheckEvaluateConstraint<InstrumentedFunction<D>, arma::mat,
+      arma::mat>::value, "CheckEvaluateConstraint static check failed.");
+  static_assert(CheckGradientConstraint<InstrumentedFunction<C>, arma::mat,
+      arma::mat>::value, "CheckGradientConstraint static check failed.");
+  static_assert(!CheckEvaluateWithGradient<InstrumentedFunction<C>, arma::mat,
+      arma::mat>::value, "CheckEvaluateWithGradient static check failed.");
+  static_assert(!CheckShuffle<InstrumentedFunction<C>, arma::mat,
+      arma::mat>::value, "CheckShuffle static check failed.");
+}
+
+/**
+ * Make sure InstrumentedFunction counts the calls of an optimizer.
+ */
+TEST_CASE("InstrumentedFunctionTest", "[FunctionTest]")
+{
+  SGDTestFunction f;
+  InstrumentedFunction<SGDTestFunction> instrumented(f);
+
+  // Three epochs of three functions, one batch per epoch; the tolerance can
+  // never be reached.
+  arma::mat coordinates = f.GetInitialPoint();
+  StandardSGD optimizer(0.01, 3, 9, -1.0, true);
+  optimizer.Optimize(instrumented, coordinates);
+
+  // EvaluateWithGradient() is derived from Evaluate() and Gradient().
+  REQUIRE(instrumented.EvaluateStats().Calls() == 3);
+  REQUIRE(instrumented.EvaluateStats().Points() == 9);
+  REQUIRE(instrumented.EvaluateStats().MeanBatchSize() == Approx(3.0));
+  REQUIRE(instrumented.GradientStats().Calls() == 3);
+  REQUIRE(instrumented.EvaluateWithGradientStats().Calls() == 0);
+  REQUIRE(instrumented.ShuffleStats().Calls() == 3);
+
+  const CallStatistics& stats = instrumented.EvaluateStats();
+  REQUIRE(stats.TotalTime() >= 0.0);
+  REQUIRE(stats.MinTime() <= stats.Percentile(0.5));
+  REQUIRE(stats.Percentile(0.5) <= stats.Percentile(0.99));
+  REQUIRE(stats.Percentile(0.99) <= stats.MaxTime());
+  REQUIRE(instrumented.TotalTime() >= stats.TotalTime());
+
+  instrumented.Reset();
+  REQUIRE(instrumented.EvaluateStats().Calls() == 0);
+  REQUIRE(instrumented.TotalTime() == 0.0);
+}
+
+/**
+ * A linear separable function that is only implemented for arma::fmat; its
+ * gradient is so small that a step can not change a coordinate of 1 in single
+ * precision.
+ */
+class FloatLinearTestFunction
+{
+ public:
+  size_t NumFunctions() const { return 1; }
+
+  void Shuffle() { }
+
+  float Evaluate(const arma::fmat& coordinates,
+                 const size_t /* begin */,
+                 const size_t /* batchSize */) const
+  {
+    return 1e-9f * arma::accu(coordinates);
+  }
+
+  void Gradient(const arma::fmat& coordinates,
+                const size_t /* begin */,
+                arma::fmat& gradient,
+                const size_t /* batchSize */) const
+  {
+    gradient.set_size(coordinates.n_rows, coordinates.n_cols);
+    gradient.fill(1e-9f);
+  }
+};
+
+/**
+ * Make sure MixedPrecisionFunction has the methods of the function it wraps,
+ * for the higher-precision type.
+ */
+TEST_CASE("MixedPrecisionFunctionTypeCheckTest", "[FunctionTest]")
+{
+  typedef MixedPrecisionFunction<FloatLinearTestFunction> FunctionType;
+
+  static_assert(CheckNumFunctions<FunctionType, arma::mat,
+      arma::mat>::value, "CheckNumFunctions static check failed.");
+  static_assert(CheckSeparableEvaluate<FunctionType, arma::mat,
+      arma::mat>::value, "CheckSeparableEvaluate static check failed.");
+  static_assert(CheckSeparableGradient<FunctionType, arma::mat,
+      arma::mat>::value, "CheckSeparableGradient static check failed.");
+  static_assert(CheckShuffle<FunctionType, arma::mat,
+      arma::mat>::value, "CheckShuffle static check failed.");
+  static_assert(!CheckEvaluate<FunctionType, arma::mat,
+      arma::mat>::value, "CheckEvaluate static check failed.");
+}
+
+/**
+ * Make sure that with MixedPrecisionFunction, SGD accumulates steps in double
+ * precision that are lost when the coordinates are single precision.
+ */
+TEST_CASE("MixedPrecisionFunctionTest", "[FunctionTest]")
+{
+  FloatLinearTestFunction f;
+  MixedPrecisionFunction<FloatLinearTestFunction> mixed(f);
+
+  StandardSGD optimizer(1.0, 1, 1000, -1.0, false);
+
+  arma::fmat floatCoordinates(4, 1, arma::fill::ones);
+  optimizer.Optimize(f, floatCoordinates);
+  REQUIRE(arma::all(arma::vectorise(floatCoordinates) == 1.0f));
+
+  arma::mat coordinates(4, 1, arma::fill::ones);
+  optimizer.Optimize(mixed, coordinates);
+  for (size_t i = 0; i < coordinates.n_elem; ++i)
+    REQUIRE(coordinates[i] == Approx(1.0 - 1e-6).margin(1e-9));
+
+  // The calls were made one after another, so a single buffer was reused.
+  REQUIRE(mixed.Buffers() == 1);
+}
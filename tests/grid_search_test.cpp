@@ -135,3 +135,104 @@ TEST_CASE("GridSearchIMatTest", "[GridSearchTest]")
   REQUIRE(params(1) == 2);
   REQUIRE(params(2) == 1);
 }
+
+// A separable categorical function f(x) = sum_i (x_i - t_i)^2 with the target
+// t = [3 7 1 5].  Since every term is non-negative, the sum of the terms of the
+// first numFixed coordinates is a lower bound on the objective of all points
+// that share these coordinates.
+class BoundedCategoricalFunction
+{
+ public:
+  BoundedCategoricalFunction() : target("3 7 1 5"), evaluations(0) { }
+
+  double Evaluate(const arma::mat& x)
+  {
+    ++evaluations;
+    return LowerBound(x, target.n_elem);
+  }
+
+  double LowerBound(const arma::mat& x, const size_t numFixed) const
+  {
+    double bound = 0.0;
+    for (size_t i = 0; i < numFixed; ++i)
+      bound += (x(i) - target(i)) * (x(i) - target(i));
+    return bound;
+  }
+
+  arma::vec target;
+  size_t evaluations;
+};
+
+// A categorical function without a lower bound.
+class UnboundedCategoricalFunction
+{
+ public:
+  double Evaluate(const arma::mat& x)
+  {
+    return f.LowerBound(x, f.target.n_elem);
+  }
+
+  BoundedCategoricalFunction f;
+};
+
+/**
+ * Make sure that sub-grids are pruned with the lower bound of the function
+ * without changing the result.
+ */
+TEST_CASE("GridSearchLowerBoundPruningTest", "[GridSearchTest]")
+{
+  REQUIRE(traits::HasLowerBoundSignature<BoundedCategoricalFunction,
+      arma::mat>::value == true);
+  REQUIRE(traits::HasLowerBoundSignature<UnboundedCategoricalFunction,
+      arma::mat>::value == false);
+
+  std::vector<bool> categoricalDimensions(4, true);
+  arma::Row<size_t> numCategories("10 10 10 10");
+
+  UnboundedCategoricalFunction u;
+  arma::mat unprunedParams;
+  GridSearch gs;
+  const double unprunedObjective = gs.Optimize(u, unprunedParams,
+      categoricalDimensions, numCategories);
+
+  BoundedCategoricalFunction f;
+  arma::mat params;
+  const double objective = gs.Optimize(f, params, categoricalDimensions,
+      numCategories);
+
+  REQUIRE(objective == 0.0);
+  REQUIRE(unprunedObjective == 0.0);
+  REQUIRE(arma::approx_equal(params, unprunedParams, "absdiff", 0.0));
+  REQUIRE(arma::approx_equal(params, f.target, "absdiff", 0.0));
+  REQUIRE(f.evaluations < 10000);
+}
+
+/**
+ * Make sure that searching the grid with several threads finds the same point
+ * as a serial search, including when several points have the best objective.
+ */
+TEST_CASE("GridSearchParallelTest", "[GridSearchTest]")
+{
+  std::vector<bool> categoricalDimensions(4, true);
+  arma::Row<size_t> numCategories("6 4 9 5");
+
+  UnboundedCategoricalFunction f;
+  f.f.target = arma::vec("2.5 1 4 3");
+
+  arma::mat serialParams;
+  GridSearch serial;
+  const double serialObjective = serial.Optimize(f, serialParams,
+      categoricalDimensions, numCategories);
+
+  arma::mat parallelParams;
+  GridSearch parallel(0);
+  const double parallelObjective = parallel.Optimize(f, parallelParams,
+      categoricalDimensions, numCategories);
+
+  // Both 2 and 3 are optimal in the first dimension; the first point wins.
+  REQUIRE(serialObjective == Approx(0.25));
+  REQUIRE(parallelObjective == serialObjective);
+  REQUIRE(arma::approx_equal(serialParams, arma::mat("2; 1; 4; 3"), "absdiff",
+      0.0));
+  REQUIRE(arma::approx_equal(parallelParams, serialParams, "absdiff", 0.0));
+}
@@ -0,0 +1,109 @@
+/**
+ * @file lamb_test.cpp
+ *
+ * Test file for the LAMB update policy.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+
+#include <ensmallen.hpp>
+#include "catch.hpp"
+#include "test_function_tools.hpp"
+
+using namespace ens;
+using namespace ens::test;
+
+/**
+ * Test the LAMB optimizer on the Sphere function.
+ */
+TEST_CASE("LAMBSphereFunctionTest", "[LAMBTest]")
+{
+  LAMB optimizer(0.01, 2, 10000, -1.0, false);
+  FunctionTest<SphereFunction>(optimizer, 0.5, 0.1);
+}
+
+/**
+ * Test the LAMB optimizer on the Sphere function with arma::fmat.
+ */
+TEST_CASE("LAMBSphereFunctionTestFMat", "[LAMBTest]")
+{
+  LAMB optimizer(0.01, 2, 10000, -1.0, false);
+  FunctionTest<SphereFunction, arma::fmat>(optimizer, 0.5, 0.1);
+}
+
+/**
+ * Make sure that the step of every block has the norm of the weights of the
+ * block, times the step size.
+ */
+TEST_CASE("LAMBTrustRatioTest", "[LAMBTest]")
+{
+  // The rows are the blocks; the first one has a much larger norm.
+  arma::mat coordinates = { { 3.0, 4.0, 0.0 }, { 0.03, 0.0, 0.04 } };
+  arma::mat gradient = { { 1.0, -10.0, 0.1 }, { 2.0, 2.0, -5.0 } };
+
+  LAMBUpdate update(0.9, 0.999, 1e-6, 0.0,
+      ParameterBlocks(arma::uvec({ 0, 1 })));
+  LAMBUpdate::Policy<arma::mat, arma::mat> policy(update, 2, 3);
+
+  arma::mat result(coordinates);
+  policy.Update(result, 0.1, gradient);
+
+  REQUIRE(policy.BlockStepSizes().n_elem == 2);
+
+  const arma::mat step = coordinates - result;
+  REQUIRE(arma::norm(step.row(0)) == Approx(0.1 * 5.0));
+  REQUIRE(arma::norm(step.row(1)) == Approx(0.1 * 0.05));
+
+  // Each step goes against the sign of the gradient.
+  for (size_t i = 0; i < step.n_elem; ++i)
+    REQUIRE(step(i) * gradient(i) > 0.0);
+}
+
+/**
+ * Make sure that per-row block indices and the equivalent per-element block
+ * indices give the same updates.
+ */
+TEST_CASE("LAMBRowAndElementBlocksTest", "[LAMBTest]")
+{
+  arma::mat coordinates(5, 3, arma::fill::randn);
+
+  LAMBUpdate rowUpdate(0.9, 0.999, 1e-6, 0.01,
+      ParameterBlocks(arma::uvec({ 0, 0, 1, 1, 2 })));
+  LAMBUpdate elementUpdate(0.9, 0.999, 1e-6, 0.01,
+      ParameterBlocks(
+          arma::uvec(arma::repmat(arma::uvec({ 0, 0, 1, 1, 2 }), 3, 1))));
+
+  LAMBUpdate::Policy<arma::mat, arma::mat> rowPolicy(rowUpdate, 5, 3);
+  LAMBUpdate::Policy<arma::mat, arma::mat> elementPolicy(elementUpdate, 5, 3);
+
+  arma::mat rowCoordinates(coordinates);
+  arma::mat elementCoordinates(coordinates);
+  for (size_t i = 0; i < 5; ++i)
+  {
+    arma::mat gradient(5, 3, arma::fill::randn);
+    rowPolicy.Update(rowCoordinates, 0.1, gradient);
+    elementPolicy.Update(elementCoordinates, 0.1, gradient);
+  }
+
+  REQUIRE(rowPolicy.BlockStepSizes().n_elem == 3);
+  CheckMatrices(rowPolicy.BlockStepSizes(), elementPolicy.BlockStepSizes());
+  CheckMatrices(rowCoordinates, elementCoordinates);
+}
+
+/**
+ * Make sure that block indices that do not fit the coordinates are rejected.
+ */
+TEST_CASE("LAMBInvalidBlocksTest", "[LAMBTest]")
+{
+  SphereFunction f(2);
+  arma::mat coordinates = f.GetInitialPoint();
+
+  LAMBUpdate update(0.9, 0.999, 1e-6, 0.0,
+      ParameterBlocks(arma::uvec({ 0, 1, 2 })));
+  LAMB optimizer(0.01, 2, 100, -1.0, false, update);
+
+  REQUIRE_THROWS_AS(optimizer.Optimize(f, coordinates), std::invalid_argument);
+}
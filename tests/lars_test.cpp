@@ -0,0 +1,146 @@
+/**
+ * @file lars_test.cpp
+ *
+ * Test file for the LARS update policy.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+
+#include <ensmallen.hpp>
+#include "catch.hpp"
+#include "test_function_tools.hpp"
+
+using namespace ens;
+using namespace ens::test;
+
+/**
+ * Test the LARS optimizer on the Sphere function.
+ */
+TEST_CASE("LARSSphereFunctionTest", "[LARSTest]")
+{
+  LARS optimizer(10.0, 2, 4000, -1.0, false, LARSUpdate(0.9, 0.001));
+  FunctionTest<SphereFunction>(optimizer, 0.5, 0.1);
+}
+
+/**
+ * Test the LARS optimizer on the Sphere function with arma::fmat.
+ */
+TEST_CASE("LARSSphereFunctionTestFMat", "[LARSTest]")
+{
+  LARS optimizer(10.0, 2, 4000, -1.0, false, LARSUpdate(0.9, 0.001));
+  FunctionTest<SphereFunction, arma::fmat>(optimizer, 0.5, 0.1);
+}
+
+/**
+ * Test the LARS optimizer on the Sphere function, with every coordinate in its
+ * own block.
+ */
+TEST_CASE("LARSSphereFunctionBlocksTest", "[LARSTest]")
+{
+  LARSUpdate update(0.9, 0.001, 0.0, 1e-8,
+      ParameterBlocks(arma::uvec({ 0, 1 })));
+  LARS optimizer(10.0, 2, 4000, -1.0, false, update);
+  FunctionTest<SphereFunction>(optimizer, 0.5, 0.1);
+}
+
+/**
+ * Make sure that the step size of every block is scaled by the ratio of the
+ * norm of its weights to the norm of its gradient.
+ */
+TEST_CASE("LARSTrustRatioTest", "[LARSTest]")
+{
+  // The rows are the blocks; the first one has a much larger norm.
+  arma::mat coordinates = { { 3.0, 4.0 }, { 0.03, 0.04 } };
+  arma::mat gradient = { { 1.0, -1.0 }, { 2.0, 2.0 } };
+
+  LARSUpdate update(0.9, 0.01, 0.0, 0.0,
+      ParameterBlocks(arma::uvec({ 0, 1 })));
+  LARSUpdate::Policy<arma::mat, arma::mat> policy(update, 2, 2);
+
+  arma::mat result(coordinates);
+  policy.Update(result, 0.5, gradient);
+
+  const arma::vec& steps = policy.BlockStepSizes();
+  REQUIRE(steps.n_elem == 2);
+  REQUIRE(steps(0) == Approx(0.5 * 0.01 * 5.0 / std::sqrt(2.0)));
+  REQUIRE(steps(1) == Approx(0.5 * 0.01 * 0.05 / std::sqrt(8.0)));
+
+  // There is no momentum yet, so the first step is plain gradient descent
+  // with the step size of the block.
+  for (size_t j = 0; j < 2; ++j)
+  {
+    for (size_t i = 0; i < 2; ++i)
+    {
+      REQUIRE(result(i, j) ==
+          Approx(coordinates(i, j) - steps(i) * gradient(i, j)));
+    }
+  }
+}
+
+/**
+ * Make sure that a block with zero weights takes an unscaled step.
+ */
+TEST_CASE("LARSZeroBlockTest", "[LARSTest]")
+{
+  arma::mat coordinates = { { 1.0, 1.0 }, { 0.0, 0.0 } };
+  arma::mat gradient = { { 1.0, 1.0 }, { 1.0, 1.0 } };
+
+  LARSUpdate update(0.9, 0.01, 0.0, 1e-8,
+      ParameterBlocks(arma::uvec({ 0, 1 })));
+  LARSUpdate::Policy<arma::mat, arma::mat> policy(update, 2, 2);
+  policy.Update(coordinates, 0.5, gradient);
+
+  REQUIRE(policy.BlockStepSizes()(0) < 0.5);
+  REQUIRE(policy.BlockStepSizes()(1) == Approx(0.5));
+  REQUIRE(coordinates(1, 0) == Approx(-0.5));
+  REQUIRE(coordinates(1, 1) == Approx(-0.5));
+}
+
+/**
+ * Make sure that per-row block indices and the equivalent per-element block
+ * indices give the same updates.
+ */
+TEST_CASE("LARSRowAndElementBlocksTest", "[LARSTest]")
+{
+  arma::mat coordinates(5, 3, arma::fill::randn);
+
+  LARSUpdate rowUpdate(0.9, 0.01, 0.1, 1e-8,
+      ParameterBlocks(arma::uvec({ 0, 0, 1, 1, 2 })));
+  LARSUpdate elementUpdate(0.9, 0.01, 0.1, 1e-8,
+      ParameterBlocks(
+          arma::uvec(arma::repmat(arma::uvec({ 0, 0, 1, 1, 2 }), 3, 1))));
+
+  LARSUpdate::Policy<arma::mat, arma::mat> rowPolicy(rowUpdate, 5, 3);
+  LARSUpdate::Policy<arma::mat, arma::mat> elementPolicy(elementUpdate, 5, 3);
+
+  arma::mat rowCoordinates(coordinates);
+  arma::mat elementCoordinates(coordinates);
+  for (size_t i = 0; i < 5; ++i)
+  {
+    arma::mat gradient(5, 3, arma::fill::randn);
+    rowPolicy.Update(rowCoordinates, 0.1, gradient);
+    elementPolicy.Update(elementCoordinates, 0.1, gradient);
+  }
+
+  REQUIRE(rowPolicy.BlockStepSizes().n_elem == 3);
+  CheckMatrices(rowPolicy.BlockStepSizes(), elementPolicy.BlockStepSizes());
+  CheckMatrices(rowCoordinates, elementCoordinates);
+}
+
+/**
+ * Make sure that block indices that do not fit the coordinates are rejected.
+ */
+TEST_CASE("LARSInvalidBlocksTest", "[LARSTest]")
+{
+  SphereFunction f(2);
+  arma::mat coordinates = f.GetInitialPoint();
+
+  LARSUpdate update(0.9, 0.001, 0.0, 1e-8,
+      ParameterBlocks(arma::uvec({ 0, 1, 2 })));
+  LARS optimizer(10.0, 2, 100, -1.0, false, update);
+
+  REQUIRE_THROWS_AS(optimizer.Optimize(f, coordinates), std::invalid_argument);
+}
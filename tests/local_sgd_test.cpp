@@ -0,0 +1,55 @@
+/**
+ * @file local_sgd_test.cpp
+ *
+ * Test file for Local SGD.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+
+#include <ensmallen.hpp>
+#include "catch.hpp"
+#include "test_function_tools.hpp"
+
+using namespace ens;
+using namespace ens::test;
+
+TEST_CASE("LocalSGDLogisticRegressionTest", "[LocalSGDTest]")
+{
+  LocalSGD<> s(0.0003, 8, 500000, 1e-9, true, VanillaUpdate(), NoDecay(), 4,
+      4);
+  LogisticRegressionFunctionTest(s, 0.003, 0.006, 3);
+}
+
+TEST_CASE("LocalSGDAdamLogisticRegressionTest", "[LocalSGDTest]")
+{
+  LocalSGD<AdamUpdate> s(0.001, 8, 500000, 1e-9, true, AdamUpdate(),
+      NoDecay(), 0, 16);
+  LogisticRegressionFunctionTest(s, 0.003, 0.006, 3);
+}
+
+TEST_CASE("LocalSGDSingleWorkerMatchesSGDTest", "[LocalSGDTest]")
+{
+  // With one worker, averaging is a no-op, so LocalSGD is exactly SGD.
+  GeneralizedRosenbrockFunction f(10);
+
+  StandardSGD sgd(0.001, 1, 100000, 1e-15, false);
+  LocalSGD<> localSGD(0.001, 1, 100000, 1e-15, false, VanillaUpdate(),
+      NoDecay(), 1, 5);
+
+  arma::mat sgdCoordinates = f.GetInitialPoint();
+  arma::mat localCoordinates = f.GetInitialPoint();
+  sgd.Optimize(f, sgdCoordinates);
+  localSGD.Optimize(f, localCoordinates);
+
+  CheckMatrices(sgdCoordinates, localCoordinates, 1e-8);
+}
+
+TEST_CASE("LocalSGDLogisticRegressionFMatTest", "[LocalSGDTest]")
+{
+  LocalSGD<> s(0.0003, 8, 500000, 1e-9, true, VanillaUpdate(), NoDecay(), 4,
+      4);
+  LogisticRegressionFunctionTest<arma::fmat>(s, 0.003, 0.006, 3);
+}
@@ -0,0 +1,185 @@
+/**
+ * @file parallel_utility_test.cpp
+ *
+ * Tests for the utilities used by the parallel code paths.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+
+#include <ensmallen.hpp>
+#include "catch.hpp"
+
+using namespace ens;
+
+TEST_CASE("CounterRNGReproducibleStreamsTest", "[ParallelUtilityTest]")
+{
+  // Streams are a pure function of (seed, stream, position), so drawing them
+  // from parallel tasks in any order gives the same numbers.
+  const size_t streams = 8;
+  arma::mat serial(100, streams), parallel(100, streams);
+  for (size_t s = 0; s < streams; ++s)
+  {
+    CounterRNG rng(42, s);
+    for (size_t i = 0; i < serial.n_rows; ++i)
+      serial(i, s) = rng.Normal();
+  }
+
+  ParallelFor(streams, 0, [&](const size_t s)
+  {
+    CounterRNG rng(42, s);
+    for (size_t i = 0; i < parallel.n_rows; ++i)
+      parallel(i, s) = rng.Normal();
+  });
+
+  REQUIRE(arma::approx_equal(serial, parallel, "absdiff", 0.0));
+
+  // Different streams should be different.
+  REQUIRE(arma::accu(serial.col(0) == serial.col(1)) == 0u);
+
+  // Seek() restarts the stream.
+  CounterRNG rng(42, 3);
+  const uint64_t first = rng();
+  rng();
+  rng.Seek(0);
+  REQUIRE(rng() == first);
+}
+
+TEST_CASE("CounterRNGMomentsTest", "[ParallelUtilityTest]")
+{
+  CounterRNG rng(7);
+  arma::vec uniform(100000), normal(100000);
+  for (size_t i = 0; i < uniform.n_elem; ++i)
+  {
+    uniform(i) = rng.Uniform();
+    normal(i) = rng.Normal();
+  }
+
+  REQUIRE(uniform.min() >= 0.0);
+  REQUIRE(uniform.max() < 1.0);
+  REQUIRE(arma::mean(uniform) == Approx(0.5).margin(0.01));
+  REQUIRE(arma::mean(normal) == Approx(0.0).margin(0.02));
+  REQUIRE(arma::stddev(normal) == Approx(1.0).margin(0.02));
+}
+
+TEST_CASE("TreeReduceTest", "[ParallelUtilityTest]")
+{
+  for (size_t n = 1; n < 20; ++n)
+  {
+    std::vector<double> parts(n);
+    for (size_t i = 0; i < n; ++i)
+      parts[i] = (double) (i + 1);
+
+    TreeReduce(parts, n);
+    REQUIRE(parts[0] == Approx(n * (n + 1) / 2.0));
+  }
+
+  // The reduction only touches the first n parts.
+  std::vector<arma::mat> mats(4, arma::mat(2, 2, arma::fill::ones));
+  TreeReduce(mats, 3);
+  REQUIRE(arma::accu(mats[0]) == Approx(12.0));
+  REQUIRE(arma::accu(mats[3]) == Approx(4.0));
+}
+
+TEST_CASE("RandomEngineFillTest", "[ParallelUtilityTest]")
+{
+  RandomEngine engine(11);
+  arma::mat uniform(300, 301), normal(301, 300);
+  engine.FillUniform(uniform);
+  engine.FillNormal(normal);
+
+  REQUIRE(uniform.min() >= 0.0);
+  REQUIRE(uniform.max() < 1.0);
+  REQUIRE(arma::mean(arma::vectorise(uniform)) == Approx(0.5).margin(0.01));
+  REQUIRE(arma::mean(arma::vectorise(normal)) == Approx(0.0).margin(0.02));
+  REQUIRE(arma::stddev(arma::vectorise(normal)) == Approx(1.0).margin(0.02));
+
+  // A permutation contains every index exactly once.
+  const arma::uvec permutation = engine.Permutation(50);
+  REQUIRE(arma::all(arma::sort(permutation) ==
+      arma::regspace<arma::uvec>(0, 49)));
+}
+
+TEST_CASE("RandomEngineFillMatchesStreamTest", "[ParallelUtilityTest]")
+{
+  // The (vectorized) fills give the same values as drawing the elements one
+  // by one, also for an odd number of normal values.
+  RandomEngine engine(13);
+  CounterRNG rng(13);
+  arma::vec uniform(1001), normal(1001);
+  engine.FillUniform(uniform);
+  engine.FillNormal(normal);
+
+  for (size_t i = 0; i < uniform.n_elem; ++i)
+    REQUIRE(uniform[i] == rng.Uniform());
+  for (size_t i = 0; i < normal.n_elem; ++i)
+    REQUIRE(normal[i] == Approx(rng.Normal()).epsilon(1e-12));
+}
+
+TEST_CASE("RandomEngineFloatUniformTest", "[ParallelUtilityTest]")
+{
+  // The largest value rounds to 1 as a float if it is computed as a double.
+  const uint64_t largest = std::numeric_limits<uint64_t>::max();
+  REQUIRE((float) CounterRNG::ToUniform(largest) == 1.0f);
+  REQUIRE(CounterRNG::ToUniformFloat(largest) < 1.0f);
+  REQUIRE(CounterRNG::ToUniformFloat(0) == 0.0f);
+
+  RandomEngine engine(17);
+  arma::fmat uniform(100, 100);
+  engine.FillUniform(uniform);
+  REQUIRE(uniform.min() >= 0.0f);
+  REQUIRE(uniform.max() < 1.0f);
+}
+
+TEST_CASE("RandomEngineIntegerTest", "[ParallelUtilityTest]")
+{
+  // An empty permutation, with and without a seed.
+  RandomEngine global, seeded(3);
+  REQUIRE(global.Permutation(0).n_elem == 0);
+  REQUIRE(seeded.Permutation(0).n_elem == 0);
+
+  // Bounds that do not fit into an int.
+  const size_t low = (size_t) 3 << 40;
+  const size_t high = low + ((size_t) 1 << 36);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    const size_t a = global.Integer(low, high);
+    const size_t b = seeded.Integer(low, high);
+    REQUIRE(a >= low);
+    REQUIRE(a <= high);
+    REQUIRE(b >= low);
+    REQUIRE(b <= high);
+  }
+
+  // The whole range of size_t.
+  seeded.Integer(0, std::numeric_limits<size_t>::max());
+
+  // Every value of a small range is drawn.
+  arma::uvec counts(5, arma::fill::zeros);
+  for (size_t i = 0; i < 5000; ++i)
+    ++counts[seeded.Integer(10, 14) - 10];
+  REQUIRE(counts.min() > 800);
+}
+
+TEST_CASE("RandomEngineSeededOptimizerTest", "[ParallelUtilityTest]")
+{
+  // A seeded engine makes the result independent of Armadillo's generator.
+  RosenbrockFunction f;
+  arma::mat coordinates1 = f.GetInitialPoint();
+  arma::mat coordinates2 = f.GetInitialPoint();
+
+  CNE optimizer1(50, 100, 0.2, 0.2, 0.2, -1);
+  optimizer1.Engine() = RandomEngine(42);
+  arma::arma_rng::set_seed(1);
+  optimizer1.Optimize(f, coordinates1);
+
+  CNE optimizer2(50, 100, 0.2, 0.2, 0.2, -1);
+  optimizer2.Engine() = RandomEngine(42);
+  arma::arma_rng::set_seed(2);
+  optimizer2.Optimize(f, coordinates2);
+
+  REQUIRE(arma::approx_equal(coordinates1, coordinates2, "absdiff", 0.0));
+  arma::arma_rng::set_seed_random();
+}
@@ -0,0 +1,152 @@
+/**
+ * @file parameter_server_sgd_test.cpp
+ *
+ * Test file for the multi-process parameter server SGD.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+
+#include <ensmallen.hpp>
+#include "catch.hpp"
+#include "test_function_tools.hpp"
+
+#ifdef ENS_HAVE_PARAMETER_SERVER
+
+#include <fcntl.h>
+
+using namespace ens;
+using namespace ens::test;
+
+/**
+ * A separable function f(x) = sum_i || x - c_i ||^2, minimized at the mean of
+ * the centers c_i.  If a lock file name is given, the first process that
+ * manages to create it terminates itself while computing a gradient, which
+ * simulates a crashing worker, or hangs forever if `hang` is true.
+ */
+class CentersFunction
+{
+ public:
+  CentersFunction(const arma::mat& centers,
+                  const std::string& lockFile = "",
+                  const bool hang = false) :
+      centers(centers), lockFile(lockFile), hang(hang) { }
+
+  size_t NumFunctions() const { return centers.n_cols; }
+
+  void Shuffle() { }
+
+  double Evaluate(const arma::mat& x, const size_t begin,
+                  const size_t batchSize) const
+  {
+    double objective = 0.0;
+    for (size_t i = begin; i < begin + batchSize; ++i)
+      objective += arma::accu(arma::square(x - centers.col(i)));
+    return objective;
+  }
+
+  void Gradient(const arma::mat& x, const size_t begin, arma::mat& g,
+                const size_t batchSize) const
+  {
+    if (!lockFile.empty())
+    {
+      const int fd = ::open(lockFile.c_str(), O_CREAT | O_EXCL | O_WRONLY,
+          0600);
+      while (fd >= 0 && hang)
+        ::pause();
+      if (fd >= 0)
+        ::_exit(1);
+    }
+
+    g = 2.0 * ((double) batchSize * x - arma::sum(centers.cols(begin,
+        begin + batchSize - 1), 1));
+  }
+
+ private:
+  arma::mat centers;
+  std::string lockFile;
+  bool hang;
+};
+
+TEST_CASE("ParameterServerSGDLogisticRegressionTest",
+          "[ParameterServerSGDTest]")
+{
+  ParameterServerSGD<> s(0.001, 8, 200000, 1e-9, 4);
+  LogisticRegressionFunctionTest(s, 0.003, 0.006, 3);
+}
+
+TEST_CASE("ParameterServerSGDCentersTest", "[ParameterServerSGDTest]")
+{
+  arma::mat centers(3, 100, arma::fill::randn);
+  CentersFunction f(centers);
+
+  ParameterServerSGD<MomentumUpdate> s(0.0001, 10, 200000, 1e-12, 3,
+      MomentumUpdate(0.5));
+  arma::mat coordinates(3, 1, arma::fill::zeros);
+  s.Optimize(f, coordinates);
+
+  const arma::vec mean = arma::mean(centers, 1);
+  for (size_t i = 0; i < 3; ++i)
+    REQUIRE(coordinates(i) == Approx(mean(i)).margin(0.1));
+}
+
+TEST_CASE("ParameterServerSGDWorkerCrashTest", "[ParameterServerSGDTest]")
+{
+  const std::string lockFile = "parameter_server_sgd_test.lock";
+  std::remove(lockFile.c_str());
+
+  arma::mat centers(3, 100, arma::fill::randn);
+  CentersFunction f(centers, lockFile);
+
+  // One worker dies; its mini-batch is reassigned to the others.
+  ParameterServerSGD<> s(0.0005, 10, 200000, 1e-12, 3);
+  arma::mat coordinates(3, 1, arma::fill::zeros);
+  s.Optimize(f, coordinates);
+  std::remove(lockFile.c_str());
+
+  const arma::vec mean = arma::mean(centers, 1);
+  for (size_t i = 0; i < 3; ++i)
+    REQUIRE(coordinates(i) == Approx(mean(i)).margin(0.1));
+}
+
+TEST_CASE("ParameterServerSGDWorkerTimeoutTest", "[ParameterServerSGDTest]")
+{
+  const std::string lockFile = "parameter_server_sgd_timeout_test.lock";
+  std::remove(lockFile.c_str());
+
+  arma::mat centers(3, 100, arma::fill::randn);
+  CentersFunction f(centers, lockFile, true);
+
+  // One worker hangs without closing its socket; it is killed after the
+  // timeout and its mini-batch is reassigned to the others.
+  ParameterServerSGD<> s(0.0005, 10, 200000, 1e-12, 3, VanillaUpdate(),
+      NoDecay(), 1.0);
+  arma::mat coordinates(3, 1, arma::fill::zeros);
+  s.Optimize(f, coordinates);
+  std::remove(lockFile.c_str());
+
+  const arma::vec mean = arma::mean(centers, 1);
+  for (size_t i = 0; i < 3; ++i)
+    REQUIRE(coordinates(i) == Approx(mean(i)).margin(0.1));
+}
+
+TEST_CASE("ParameterServerSGDAllWorkersLostTest", "[ParameterServerSGDTest]")
+{
+  const std::string lockFile = "parameter_server_sgd_lost_test.lock";
+  std::remove(lockFile.c_str());
+
+  arma::mat centers(3, 100, arma::fill::randn);
+  CentersFunction f(centers, lockFile, true);
+
+  // The only worker hangs, so the optimization must fail instead of waiting
+  // forever.
+  ParameterServerSGD<> s(0.0005, 10, 200000, 1e-12, 1, VanillaUpdate(),
+      NoDecay(), 0.5);
+  arma::mat coordinates(3, 1, arma::fill::zeros);
+  REQUIRE_THROWS_AS(s.Optimize(f, coordinates), std::runtime_error);
+  std::remove(lockFile.c_str());
+}
+
+#endif
@@ -0,0 +1,91 @@
+/**
+ * @file perf_counters_enabled_test.cpp
+ *
+ * Test PerfCounters with ENS_USE_PERF_EVENTS defined.
+ *
+ * This file is compiled into its own test program
+ * (ensmallen_perf_counters_tests) on Linux only, because ENS_USE_PERF_EVENTS
+ * changes inline code and must be the same in every translation unit of a
+ * program.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+
+#define ENS_USE_PERF_EVENTS
+#include <ensmallen.hpp>
+
+#include <cerrno>
+
+#define CATCH_CONFIG_RUNNER
+#include "catch.hpp"
+
+using namespace ens;
+
+/**
+ * Try to open a counter of retired instructions, and return 0 if that works or
+ * errno if it does not.
+ */
+static int ProbePerfEvents()
+{
+  struct perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.size = sizeof(attr);
+  attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+
+  const long fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+  if (fd < 0)
+    return errno;
+
+  close((int) fd);
+  return 0;
+}
+
+/**
+ * Count the events of a matrix multiplication.
+ */
+TEST_CASE("PerfCountersEnabledTest", "[PerfCountersTest]")
+{
+  // Containers and kernels with a strict perf_event_paranoid setting do not
+  // give access to the counters, and virtual machines often have no hardware
+  // counters at all.
+  const int error = ProbePerfEvents();
+  if (error == EACCES || error == EPERM || error == ENOENT ||
+      error == ENODEV || error == EOPNOTSUPP)
+  {
+    WARN("perf events are not available (" << std::strerror(error)
+        << "); skipping test.");
+    return;
+  }
+  REQUIRE(error == 0);
+
+  PerfCounters counters;
+  REQUIRE(counters.Available(PerfCounters::INSTRUCTIONS));
+
+  counters.Start();
+  arma::mat a(200, 200, arma::fill::randu);
+  const double sum = arma::accu(a * a);
+  counters.Stop();
+
+  REQUIRE(sum > 0.0);
+  REQUIRE(counters.Seconds() > 0.0);
+  REQUIRE(counters.Count(PerfCounters::INSTRUCTIONS) > 200 * 200);
+  for (size_t e = 0; e < PerfCounters::NUM_EVENTS; ++e)
+  {
+    const PerfCounters::Event event = (PerfCounters::Event) e;
+    if (!counters.Available(event))
+      REQUIRE(counters.Count(event) == 0);
+  }
+
+}
+
+int main(int argc, char** argv)
+{
+  return Catch::Session().run(argc, argv);
+}
@@ -0,0 +1,40 @@
+/**
+ * @file perf_counters_test.cpp
+ *
+ * Test file for PerfCounters without ENS_USE_PERF_EVENTS.  The counters
+ * themselves are tested in perf_counters_enabled_test.cpp.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+
+#include <ensmallen.hpp>
+#include "catch.hpp"
+
+using namespace ens;
+
+#if !defined(ENS_USE_PERF_EVENTS)
+
+/**
+ * Without ENS_USE_PERF_EVENTS, no counter is opened, but the time is still
+ * measured.
+ */
+TEST_CASE("PerfCountersDisabledTest", "[PerfCountersTest]")
+{
+  PerfCounters counters;
+  REQUIRE(!counters.Available());
+
+  counters.Start();
+  arma::mat a(100, 100, arma::fill::randu);
+  const double sum = arma::accu(a * a);
+  counters.Stop();
+
+  REQUIRE(sum > 0.0);
+  REQUIRE(counters.Seconds() > 0.0);
+  for (size_t e = 0; e < PerfCounters::NUM_EVENTS; ++e)
+    REQUIRE(counters.Count((PerfCounters::Event) e) == 0);
+}
+
+#endif
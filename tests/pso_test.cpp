@@ -392,3 +392,21 @@ TEST_CASE("LBestPSOScafferFunctionN4Test", "[PSOTest]")
   REQUIRE(abs(coordinates(1)) == Approx(1.25313).margin(0.1));
 }
 */
+
+/**
+ * Make sure that evaluating the swarm on several threads gives the same result
+ * as evaluating it serially.
+ */
+TEST_CASE("LBestPSOParallelMatchesSerialTest", "[PSOTest]")
+{
+  SphereFunction f(4);
+  LBestPSO serialOpt(64, 1, 1, 500, 100);
+  LBestPSO parallelOpt(64, 1, 1, 500, 100, 1e-10, 2.05, 2.05, LBestUpdate(),
+      DefaultInit(), 0);
+
+  // PSO draws from Armadillo's global generator.
+  CheckParallelMatchesSerial(f, serialOpt, parallelOpt,
+      f.GetInitialPoint<arma::mat>(),
+      [](LBestPSO& /* opt */) { arma::arma_rng::set_seed(11); });
+  arma::arma_rng::set_seed_random();
+}
@@ -78,3 +78,86 @@ TEST_CASE("RastrigrinFunctionTest", "[SATest]")
   SA<> sa(schedule, 2000000, 100, 50, 1000, 1e-12, 2, 2.0, 0.5, 0.1);
   FunctionTest<RastriginFunction>(sa, 0.01, 0.001, 4);
 }
+
+/**
+ * Parallel tempering on the Rastrigin function; the exchanges between the
+ * replicas should let the coldest replica escape from the local minima.
+ */
+TEST_CASE("ParallelTemperingRastriginFunctionTest", "[SATest]")
+{
+  SA<> replica(ExponentialSchedule(), 500000, 100, 50, 1000, 1e-12, 2, 2.0,
+      0.5, 0.1);
+  ParallelTempering<> pt(replica, 4, 100.0, 1000);
+  FunctionTest<RastriginFunction>(pt, 0.01, 0.001, 4);
+}
+
+/**
+ * Make sure that the result of parallel tempering does not depend on the
+ * number of threads.
+ */
+TEST_CASE("ParallelTemperingThreadsTest", "[SATest]")
+{
+  RosenbrockFunction f;
+  SA<> replica(ExponentialSchedule(), 20000, 1000., 1000, 100, 1e-11, 3, 1.5,
+      0.3, 0.3);
+
+  ParallelTempering<> serialOpt(replica, 4, 10.0, 500, 1);
+  ParallelTempering<> parallelOpt(replica, 4, 10.0, 500, 0);
+
+  const double objective = CheckParallelMatchesSerial(f, serialOpt,
+      parallelOpt, f.GetInitialPoint(),
+      [](ParallelTempering<>& opt) { opt.Engine() = RandomEngine(11); });
+  REQUIRE(serialOpt.AcceptedExchanges() == parallelOpt.AcceptedExchanges());
+  REQUIRE(objective < f.Evaluate(f.GetInitialPoint()));
+}
+
+// The function f(x) = sum_i (x_i - i)^2, with an EvaluateDelta() method that
+// computes the change of a single-coordinate move in constant time.
+class DeltaEvaluableFunction
+{
+ public:
+  DeltaEvaluableFunction() : evaluations(0), deltaEvaluations(0) { }
+
+  double Evaluate(const arma::mat& x)
+  {
+    ++evaluations;
+    double objective = 0.0;
+    for (size_t i = 0; i < x.n_elem; ++i)
+      objective += (x(i) - i) * (x(i) - i);
+    return objective;
+  }
+
+  double EvaluateDelta(const arma::mat& x, const size_t i, const double value)
+  {
+    ++deltaEvaluations;
+    return (value - i) * (value - i) - (x(i) - i) * (x(i) - i);
+  }
+
+  size_t evaluations;
+  size_t deltaEvaluations;
+};
+
+/**
+ * Make sure that SA uses EvaluateDelta() for the moves when it is available.
+ */
+TEST_CASE("SAEvaluateDeltaTest", "[SATest]")
+{
+  REQUIRE(traits::HasEvaluateDeltaSignature<DeltaEvaluableFunction,
+      arma::mat>::value == true);
+  REQUIRE(traits::HasEvaluateDeltaSignature<RosenbrockFunction,
+      arma::mat>::value == false);
+
+  DeltaEvaluableFunction f;
+  arma::mat coordinates(5, 1, arma::fill::zeros);
+
+  SA<> sa(ExponentialSchedule(), 1000000, 1000., 1000, 100, 1e-11, 3, 1.5, 0.3,
+      0.3);
+  const double objective = sa.Optimize(f, coordinates);
+
+  // Only the initial and the final energy are computed with Evaluate().
+  REQUIRE(f.evaluations == 2);
+  REQUIRE(f.deltaEvaluations > 1000);
+  REQUIRE(objective == Approx(0.0).margin(1e-4));
+  for (size_t i = 0; i < 5; ++i)
+    REQUIRE(coordinates(i) == Approx(i).margin(1e-2));
+}
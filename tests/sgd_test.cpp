@@ -74,3 +74,86 @@ TEST_CASE("GeneralizedRosenbrockTestFloat", "[SGDTest]")
     }
   }
 }
+
+TEST_CASE("SGDDataParallelMatchesSerialTest", "[SGDTest]")
+{
+  arma::mat data, testData, shuffledData;
+  arma::Row<size_t> responses, testResponses, shuffledResponses;
+  LogisticRegressionTestData(data, testData, shuffledData,
+      responses, testResponses, shuffledResponses);
+  LogisticRegression<> lr(shuffledData, shuffledResponses, 0.5);
+
+  // Without shuffling, splitting each batch across threads should only change
+  // the order in which the per-shard gradients are summed.
+  StandardSGD serial(0.0003, 64, 5000, 1e-10, false);
+  StandardSGD parallel(0.0003, 64, 5000, 1e-10, false, VanillaUpdate(),
+      NoDecay(), true, false, 4);
+
+  arma::mat serialCoordinates = lr.GetInitialPoint();
+  arma::mat parallelCoordinates = lr.GetInitialPoint();
+  const double serialObjective = serial.Optimize(lr, serialCoordinates);
+  const double parallelObjective = parallel.Optimize(lr, parallelCoordinates);
+
+  REQUIRE(parallelObjective == Approx(serialObjective).epsilon(1e-5));
+  CheckMatrices(serialCoordinates, parallelCoordinates, 1e-5);
+}
+
+/**
+ * Make sure that splitting an element-wise update policy across threads with
+ * ParallelUpdate takes exactly the same steps as the policy itself.
+ */
+TEMPLATE_TEST_CASE("ParallelUpdateMatchesSerialTest", "[SGDTest]",
+    MomentumUpdate, NesterovMomentumUpdate, AdaGradUpdate, RMSPropUpdate,
+    AdamUpdate)
+{
+  TestType update;
+  ParallelUpdate<TestType> parallelUpdate(update, 4, 64);
+
+  typename TestType::template Policy<arma::mat, arma::mat> serial(update,
+      1000, 1);
+  typename ParallelUpdate<TestType>::template Policy<arma::mat, arma::mat>
+      parallel(parallelUpdate, 1000, 1);
+
+  // 1000 elements in chunks of at least 64 elements: one chunk per thread.
+  REQUIRE(parallel.Chunks() == NumThreads(4));
+
+  arma::mat serialIterate(1000, 1, arma::fill::randn);
+  arma::mat parallelIterate = serialIterate;
+  for (size_t i = 0; i < 10; ++i)
+  {
+    const arma::mat gradient(1000, 1, arma::fill::randn);
+    serial.Update(serialIterate, 0.01, gradient);
+    parallel.Update(parallelIterate, 0.01, gradient);
+  }
+
+  CheckMatrices(serialIterate, parallelIterate, 1e-10);
+}
+
+/**
+ * Make sure that ParallelUpdate still takes the same steps as the policy
+ * itself when the parameters do not start on a cache line.
+ */
+TEST_CASE("ParallelUpdateUnalignedTest", "[SGDTest]")
+{
+  AdamUpdate update;
+  ParallelUpdate<AdamUpdate> parallelUpdate(update, 4, 64);
+
+  AdamUpdate::Policy<arma::mat, arma::mat> serial(update, 1000, 1);
+  ParallelUpdate<AdamUpdate>::Policy<arma::mat, arma::mat> parallel(
+      parallelUpdate, 1000, 1);
+
+  // View the parameters one element into a larger buffer.
+  arma::mat serialIterate(1000, 1, arma::fill::randn);
+  arma::mat buffer(1001, 1);
+  arma::mat parallelIterate(buffer.memptr() + 1, 1000, 1, false, true);
+  parallelIterate = serialIterate;
+  for (size_t i = 0; i < 10; ++i)
+  {
+    const arma::mat gradient(1000, 1, arma::fill::randn);
+    serial.Update(serialIterate, 0.01, gradient);
+    parallel.Update(parallelIterate, 0.01, gradient);
+  }
+
+  REQUIRE(parallel.Chunks() == NumThreads(4));
+  CheckMatrices(serialIterate, parallelIterate, 1e-10);
+}
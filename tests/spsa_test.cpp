@@ -65,3 +65,47 @@ TEST_CASE("SPSALogisticRegressionTest", "[SPSATest]")
   SPSA optimizer(0.5, 0.102, 0.002, 0.3, 5000, 1e-8);
   LogisticRegressionFunctionTest(optimizer, 0.003, 0.006, 10);
 }
+
+/**
+ * Make sure that averaging several perturbations per iteration gives the same
+ * result with one thread and with several threads.
+ */
+TEST_CASE("SPSAMultiplePerturbationsTest", "[SPSATest]")
+{
+  SphereFunction f(2);
+  SPSA serialOpt(0.1, 0.102, 0.16, 0.3, 10000, 0, 4, false, 1);
+  SPSA parallelOpt(0.1, 0.102, 0.16, 0.3, 10000, 0, 4, false, 0);
+
+  const double objective = CheckParallelMatchesSerial(f, serialOpt,
+      parallelOpt, f.GetInitialPoint(),
+      [](SPSA& opt) { opt.Engine() = RandomEngine(5); });
+  REQUIRE(objective == Approx(0.0).margin(0.1));
+}
+
+/**
+ * Test second-order SPSA (2SPSA) on the Matyas function.
+ */
+TEST_CASE("SPSASecondOrderMatyasFunctionTest", "[SPSATest]")
+{
+  SPSA optimizer(0.602, 0.101, 0.5, 0.3, 20000, 0, 4, true);
+  FunctionTest<MatyasFunction>(optimizer, 0.1, 0.01, 3);
+}
+
+/**
+ * Test 2SPSA with one perturbation on a 20-dimensional Sphere function, where
+ * the Hessian estimate stays rank-deficient for the first iterations and the
+ * preconditioner must not blow up the step.
+ */
+TEST_CASE("SPSASecondOrderRankDeficientTest", "[SPSATest]")
+{
+  SphereFunction f(20);
+  arma::mat coordinates = f.GetInitialPoint();
+
+  SPSA optimizer(0.602, 0.101, 0.5, 0.3, 2000, 0, 1, true);
+  const double objective = optimizer.Optimize(f, coordinates);
+
+  REQUIRE(coordinates.is_finite());
+  REQUIRE(objective == Approx(0.0).margin(0.1));
+  for (size_t i = 0; i < coordinates.n_elem; ++i)
+    REQUIRE(coordinates(i) == Approx(0.0).margin(0.1));
+}
@@ -97,6 +97,29 @@ inline void CheckMatrices(const MatType& a,
   }
 }
 
+// Run a serial and a parallel configuration of an optimizer from the same
+// starting point, calling seed() on each optimizer right before it runs, and
+// check that both produce bitwise identical results.  Returns the objective.
+template<typename FunctionType, typename OptimizerType, typename SeedType>
+inline double CheckParallelMatchesSerial(FunctionType& f,
+                                         OptimizerType& serialOpt,
+                                         OptimizerType& parallelOpt,
+                                         const arma::mat& initialPoint,
+                                         SeedType seed)
+{
+  arma::mat serial = initialPoint;
+  seed(serialOpt);
+  const double serialObjective = serialOpt.Optimize(f, serial);
+
+  arma::mat parallel = initialPoint;
+  seed(parallelOpt);
+  const double parallelObjective = parallelOpt.Optimize(f, parallel);
+
+  REQUIRE(serialObjective == parallelObjective);
+  REQUIRE(arma::approx_equal(serial, parallel, "absdiff", 0.0));
+  return serialObjective;
+}
+
 template<typename FunctionType, typename OptimizerType, typename PointType>
 bool TestOptimizer(FunctionType& f,
                    OptimizerType& optimizer,